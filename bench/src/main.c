@@ -0,0 +1,601 @@
+#if !defined(_WIN32) && !defined(_WIN64)
+    #define _XOPEN_SOURCE 700
+    #include <sys/resource.h>
+#endif
+
+#include <time.h>
+#include "raccoon/raccoon.h"
+#include "vita/vita.h"
+
+// bench suite
+static int bench_num = 0;
+#define BENCH(func) { fprintf(stderr, "(%d) ---> BENCHMARKING: %s\n", bench_num, #func); func(); bench_num++; }
+
+/**
+ * BENCHMARKS:  Throughput of raccoon at several levels: single operations,
+ *              neurons, layers, MLPs and full training epochs.
+ *
+ *              Results are written as JSON to stdout or to the file passed
+ *              as the first argument. Progress is printed to stderr.
+ *
+ *              Everything is allocated through one vita allocator, and its
+ *              stats give the allocations made during the timed steps (nodes,
+ *              lists, parent trees) and the allocations still alive at the
+ *              end of a step, before its graph is released. The resident set
+ *              high-water mark is process-wide, so it is only reported once.
+ */
+
+void bench_op_add(void);
+void bench_op_mul(void);
+void bench_op_backward(void);
+void bench_neuron(void);
+void bench_layer(void);
+void bench_mlp(void);
+void bench_train(void);
+
+/**
+ * HELPER FUNCTIONS
+ */
+
+struct BenchResult {
+    const char *name;       // benchmark name
+    size_t width;           // input/hidden width, or graph length
+    size_t depth;           // number of layers (0 if not applicable)
+    size_t steps;           // number of timed steps
+    size_t nodes;           // nodes processed during timed steps
+    size_t samples;         // samples processed during timed steps
+    size_t allocs;          // allocations made during timed steps
+    size_t live_allocs;     // most allocations alive at the end of a step (graph not yet released)
+    double time_secs;       // total time spent
+};
+
+double bench_time_now_secs(void);
+size_t bench_allocs(void);
+size_t bench_live_allocs(void);
+size_t bench_peak_memory_kb(void);
+void bench_report(const struct BenchResult result);
+size_t mlp_cache_len(const rac_mlp_t *const mlp);
+void mlp_cache_release(rac_mlp_t *const mlp);
+void plist_var_free(vt_plist_t *list);
+
+static FILE *out = NULL;
+static size_t results_num = 0;
+static vt_mallocator_t *alloctr = NULL;
+int main(int argc, char **argv) {
+    vt_version_t
+        vt_v = vt_version_get(),
+        rac_v = rac_version_get();
+    fprintf(stderr, "Vita (%s) | Raccoon (%s)\n", vt_v.str, rac_v.str);
+
+    // output
+    out = (argc > 1) ? fopen(argv[1], "w") : stdout;
+    if (out == NULL) {
+        fprintf(stderr, "Failed to open <%s>!\n", argv[1]);
+        return 1;
+    }
+
+    // allocator
+    alloctr = vt_mallocator_create();
+
+    // header
+    fprintf(out, "{\n");
+    fprintf(out, "  \"raccoon\": \"%s\",\n", rac_v.str);
+    fprintf(out, "  \"precision\": \"%s\",\n", (sizeof(rac_float) == sizeof(float)) ? "float" : (sizeof(rac_float) == sizeof(double)) ? "double" : "long double");
+    fprintf(out, "  \"sizeof_var\": %zu,\n", sizeof(rac_var_t));
+    fprintf(out, "  \"results\": [\n");
+
+    // start
+    {
+        BENCH(bench_op_add);
+        BENCH(bench_op_mul);
+        BENCH(bench_op_backward);
+        BENCH(bench_neuron);
+        BENCH(bench_layer);
+        BENCH(bench_mlp);
+        BENCH(bench_train);
+    }
+
+    // footer
+    fprintf(out, "\n  ],\n");
+    fprintf(out, "  \"process_peak_rss_kb\": %zu\n", bench_peak_memory_kb());
+    fprintf(out, "}\n");
+    if (out != stdout) fclose(out);
+    vt_mallocator_destroy(alloctr);
+
+    return 0;
+}
+
+/**
+ * BENCHMARKS
+ */
+
+void bench_op_add(void) {
+    const size_t counts[] = { 1024, 65536 };
+    VT_FOREACH(c, 0, sizeof(counts)/sizeof(counts[0])) {
+        const size_t count = counts[c];
+        const size_t steps = 64;
+
+        // setup
+        rac_var_t *a = rac_var_make(alloctr, 1);
+        rac_var_t *b = rac_var_make(alloctr, 2);
+        rac_var_t **nodes = VT_CALLOC(count * sizeof(rac_var_t*));
+
+        // run
+        double time_secs = 0;
+        size_t allocs = 0, live_allocs = 0;
+        VT_FOREACH(step, 0, steps) {
+            const size_t allocs_start = bench_allocs(), live_start = bench_live_allocs();
+            const double start = bench_time_now_secs();
+            VT_FOREACH(i, 0, count) nodes[i] = rac_var_add(a, b);
+            time_secs += bench_time_now_secs() - start;
+            allocs += bench_allocs() - allocs_start;
+            if (bench_live_allocs() - live_start > live_allocs) live_allocs = bench_live_allocs() - live_start;
+
+            // free
+            VT_FOREACH(i, 0, count) rac_var_free(nodes[i]);
+        }
+
+        // report
+        bench_report((struct BenchResult) {
+            .name = "op_add",
+            .width = count,
+            .steps = steps,
+            .nodes = steps * count,
+            .allocs = allocs,
+            .live_allocs = live_allocs,
+            .time_secs = time_secs,
+        });
+
+        // free
+        VT_FREE(nodes);
+        rac_var_free(a);
+        rac_var_free(b);
+    }
+}
+
+void bench_op_mul(void) {
+    const size_t counts[] = { 1024, 65536 };
+    VT_FOREACH(c, 0, sizeof(counts)/sizeof(counts[0])) {
+        const size_t count = counts[c];
+        const size_t steps = 64;
+
+        // setup
+        rac_var_t *a = rac_var_make(alloctr, 1);
+        rac_var_t *b = rac_var_make(alloctr, 2);
+        rac_var_t **nodes = VT_CALLOC(count * sizeof(rac_var_t*));
+
+        // run
+        double time_secs = 0;
+        size_t allocs = 0, live_allocs = 0;
+        VT_FOREACH(step, 0, steps) {
+            const size_t allocs_start = bench_allocs(), live_start = bench_live_allocs();
+            const double start = bench_time_now_secs();
+            VT_FOREACH(i, 0, count) nodes[i] = rac_var_mul(a, b);
+            time_secs += bench_time_now_secs() - start;
+            allocs += bench_allocs() - allocs_start;
+            if (bench_live_allocs() - live_start > live_allocs) live_allocs = bench_live_allocs() - live_start;
+
+            // free
+            VT_FOREACH(i, 0, count) rac_var_free(nodes[i]);
+        }
+
+        // report
+        bench_report((struct BenchResult) {
+            .name = "op_mul",
+            .width = count,
+            .steps = steps,
+            .nodes = steps * count,
+            .allocs = allocs,
+            .live_allocs = live_allocs,
+            .time_secs = time_secs,
+        });
+
+        // free
+        VT_FREE(nodes);
+        rac_var_free(a);
+        rac_var_free(b);
+    }
+}
+
+void bench_op_backward(void) {
+    const size_t lengths[] = { 64, 256, 1024 };
+    VT_FOREACH(l, 0, sizeof(lengths)/sizeof(lengths[0])) {
+        const size_t length = lengths[l];
+        const size_t steps = 16;
+
+        // setup: s = ((x0 * x0) + (x1 * x1)) + ...
+        vt_plist_t *cache = vt_plist_create(2 * length + 1, alloctr);
+        rac_var_t *sum = rac_var_make(alloctr, 0);
+        vt_plist_push_back(cache, sum);
+        VT_FOREACH(i, 0, length) {
+            rac_var_t *x = rac_var_make(alloctr, i);
+            rac_var_t *prod = rac_var_mul(x, x);
+            sum = rac_var_add(sum, prod);
+            vt_plist_push_back(cache, x);
+            vt_plist_push_back(cache, prod);
+            vt_plist_push_back(cache, sum);
+        }
+        const size_t nodes = vt_plist_len(cache);
+
+        // run
+        const size_t allocs_start = bench_allocs();
+        const double start = bench_time_now_secs();
+        VT_FOREACH(step, 0, steps) rac_var_backward(sum);
+        const double time_secs = bench_time_now_secs() - start;
+        const size_t allocs = bench_allocs() - allocs_start;
+
+        // report
+        bench_report((struct BenchResult) {
+            .name = "op_backward",
+            .width = length,
+            .steps = steps,
+            .nodes = steps * nodes,
+            .allocs = allocs,
+            .time_secs = time_secs,
+        });
+
+        // free
+        plist_var_free(cache);
+    }
+}
+
+void bench_neuron(void) {
+    const size_t widths[] = { 4, 16, 64, 256 };
+    VT_FOREACH(w, 0, sizeof(widths)/sizeof(widths[0])) {
+        const size_t width = widths[w];
+        const size_t steps = 32;
+
+        // setup
+        rac_neuron_t *neuron = rac_neuron_make(alloctr, width, NULL);
+        vt_plist_t *input = vt_plist_create(width, alloctr);
+        VT_FOREACH(i, 0, width) vt_plist_push_back(input, rac_var_make_rand(alloctr));
+
+        // run
+        double time_secs = 0;
+        size_t nodes = 0, allocs = 0, live_allocs = 0;
+        VT_FOREACH(step, 0, steps) {
+            const size_t cache_len = vt_plist_len(neuron->cache);
+            const size_t allocs_start = bench_allocs(), live_start = bench_live_allocs();
+            const double start = bench_time_now_secs();
+
+            // forward + backward
+            rac_var_t *yhat = rac_neuron_forward(neuron, input);
+            rac_neuron_zero_grad(neuron);
+            rac_var_backward(yhat);
+
+            time_secs += bench_time_now_secs() - start;
+            allocs += bench_allocs() - allocs_start;
+            if (bench_live_allocs() - live_start > live_allocs) live_allocs = bench_live_allocs() - live_start;
+            nodes += vt_plist_len(neuron->cache) - cache_len;
+
+            // release graph
+            VT_FOREACH(i, 0, vt_plist_len(neuron->cache)) rac_var_free(vt_plist_get(neuron->cache, i));
+            vt_plist_clear(neuron->cache);
+        }
+
+        // report
+        bench_report((struct BenchResult) {
+            .name = "neuron_forward_backward",
+            .width = width,
+            .depth = 1,
+            .steps = steps,
+            .nodes = nodes,
+            .samples = steps,
+            .allocs = allocs,
+            .live_allocs = live_allocs,
+            .time_secs = time_secs,
+        });
+
+        // free
+        plist_var_free(input);
+        rac_neuron_free(neuron);
+    }
+}
+
+void bench_layer(void) {
+    const size_t widths[] = { 4, 16, 32, 64 };
+    VT_FOREACH(w, 0, sizeof(widths)/sizeof(widths[0])) {
+        const size_t width = widths[w];
+        const size_t steps = 8;
+
+        // setup
+        rac_layer_t *layer = rac_layer_make(alloctr, width, width, NULL);
+        rac_mlp_t *mlp = rac_mlp_make_ex(alloctr, vt_plist_create(1, alloctr));
+        vt_plist_push_back(mlp->layers, layer);
+        vt_plist_t *input = vt_plist_create(width, alloctr);
+        VT_FOREACH(i, 0, width) vt_plist_push_back(input, rac_var_make_rand(alloctr));
+        vt_plist_t *cache = vt_plist_create(width, alloctr);
+
+        // run
+        double time_secs = 0;
+        size_t nodes = 0, allocs = 0, live_allocs = 0;
+        VT_FOREACH(step, 0, steps) {
+            const size_t cache_len = mlp_cache_len(mlp);
+            const size_t allocs_start = bench_allocs(), live_start = bench_live_allocs();
+            const double start = bench_time_now_secs();
+
+            // forward
+            vt_plist_t *output = rac_layer_forward(layer, input);
+
+            // loss: sum of outputs
+            rac_var_t *loss = vt_plist_get(output, 0);
+            VT_FOREACH(i, 1, vt_plist_len(output)) {
+                loss = rac_var_add(loss, vt_plist_get(output, i));
+                vt_plist_push_back(cache, loss);
+            }
+
+            // backward
+            rac_layer_zero_grad(layer);
+            rac_var_backward(loss);
+
+            time_secs += bench_time_now_secs() - start;
+            allocs += bench_allocs() - allocs_start;
+            if (bench_live_allocs() - live_start > live_allocs) live_allocs = bench_live_allocs() - live_start;
+            nodes += mlp_cache_len(mlp) - cache_len + vt_plist_len(cache);
+
+            // release graph
+            while ((loss = vt_plist_pop_get(cache)) != NULL) rac_var_free(loss);
+            mlp_cache_release(mlp);
+        }
+
+        // report
+        bench_report((struct BenchResult) {
+            .name = "layer_forward_backward",
+            .width = width,
+            .depth = 1,
+            .steps = steps,
+            .nodes = nodes,
+            .samples = steps,
+            .allocs = allocs,
+            .live_allocs = live_allocs,
+            .time_secs = time_secs,
+        });
+
+        // free
+        vt_plist_destroy(cache);
+        plist_var_free(input);
+        rac_mlp_free(mlp);
+    }
+}
+
+void bench_mlp(void) {
+    const size_t widths[] = { 4, 8, 16 };
+    const size_t depths[] = { 1, 2, 3 };
+    VT_FOREACH(w, 0, sizeof(widths)/sizeof(widths[0])) {
+        VT_FOREACH(d, 0, sizeof(depths)/sizeof(depths[0])) {
+            const size_t width = widths[w];
+            const size_t depth = depths[d];
+            const size_t steps = 8;
+
+            // setup: input -> depth x hidden -> 1
+            size_t shape[8] = {0};
+            VT_FOREACH(i, 0, depth+1) shape[i] = width;
+            shape[depth+1] = 1;
+            rac_mlp_t *mlp = rac_mlp_make(alloctr, depth+2, shape, NULL, NULL);
+            vt_plist_t *input = vt_plist_create(width, alloctr);
+            VT_FOREACH(i, 0, width) vt_plist_push_back(input, rac_var_make_rand(alloctr));
+
+            // run
+            double time_secs = 0;
+            size_t nodes = 0, allocs = 0, live_allocs = 0;
+            VT_FOREACH(step, 0, steps) {
+                const size_t cache_len = mlp_cache_len(mlp);
+                const size_t allocs_start = bench_allocs(), live_start = bench_live_allocs();
+                const double start = bench_time_now_secs();
+
+                // forward + backward
+                vt_plist_t *output = rac_mlp_forward(mlp, input);
+                rac_mlp_zero_grad(mlp);
+                rac_var_backward(vt_plist_get(output, 0));
+
+                time_secs += bench_time_now_secs() - start;
+                allocs += bench_allocs() - allocs_start;
+                if (bench_live_allocs() - live_start > live_allocs) live_allocs = bench_live_allocs() - live_start;
+                nodes += mlp_cache_len(mlp) - cache_len;
+
+                // release graph
+                mlp_cache_release(mlp);
+            }
+
+            // report
+            bench_report((struct BenchResult) {
+                .name = "mlp_forward_backward",
+                .width = width,
+                .depth = depth+1,
+                .steps = steps,
+                .nodes = nodes,
+                .samples = steps,
+                .allocs = allocs,
+                .live_allocs = live_allocs,
+                .time_secs = time_secs,
+            });
+
+            // free
+            plist_var_free(input);
+            rac_mlp_free(mlp);
+        }
+    }
+}
+
+void bench_train(void) {
+    // the same dataset as in tests/src/main.c: test_mlp
+    const size_t input_size = 3;
+    const size_t input_rows = 8;
+    const rac_float data[/*input_rows * (input_size+1)*/] = {
+        // x     y
+        0, 0, 0, 1,
+        0, 0, 1, 0,
+        0, 1, 1, 0,
+        1, 1, 1, 0,
+        1, 1, 0, 1,
+        1, 0, 0, 1,
+        1, 0, 1, 0,
+        0, 1, 0, 1,
+    };
+    vt_plist_t *input = vt_plist_create(input_rows, alloctr);
+    vt_plist_t *target = vt_plist_create(input_rows, alloctr);
+    VT_FOREACH(i, 0, input_rows) {
+        vt_plist_t *input_row = vt_plist_create(input_size, alloctr);
+        VT_FOREACH(j, 0, input_size) vt_plist_push_back(input_row, rac_var_make(alloctr, data[vt_index_2d_to_1d(i, j, 4)]));
+        vt_plist_push_back(input, input_row);
+        vt_plist_push_back(target, rac_var_make(alloctr, data[vt_index_2d_to_1d(i, 3, 4)]));
+    }
+
+    const size_t hidden[] = { 5, 32 };
+    VT_FOREACH(h, 0, sizeof(hidden)/sizeof(hidden[0])) {
+        // model
+        rac_mlp_t *model = rac_mlp_make(alloctr, 3, (size_t[]){input_size, hidden[h], 1}, NULL, NULL);
+        rac_var_t *batch_size = rac_var_make(alloctr, input_rows);
+        vt_plist_t *cache = vt_plist_create(3 * input_rows + 2, alloctr);
+
+        // train
+        const size_t epochs = 64;
+        const rac_float lr = 0.0005;
+        double time_secs = 0;
+        size_t nodes = 0, allocs = 0, live_allocs = 0;
+        VT_FOREACH(epoch, 0, epochs) {
+            const size_t cache_len = mlp_cache_len(model);
+            const size_t allocs_start = bench_allocs(), live_start = bench_live_allocs();
+            const double start = bench_time_now_secs();
+
+            // batch forward
+            rac_var_t *loss = rac_var_make(alloctr, 0);                    vt_plist_push_back(cache, loss);
+            VT_FOREACH(i, 0, input_rows) {
+                vt_plist_t *out = rac_mlp_forward(model, vt_plist_get(input, i));
+                rac_var_t *diff = rac_var_sub(vt_plist_get(out, 0), vt_plist_get(target, i));
+                rac_var_t *sq = rac_var_mul(diff, diff);
+                loss = rac_var_add(loss, sq);
+                vt_plist_push_back(cache, diff);
+                vt_plist_push_back(cache, sq);
+                vt_plist_push_back(cache, loss);
+            }
+            loss = rac_var_div(loss, batch_size);                       vt_plist_push_back(cache, loss);
+
+            // backward + update
+            rac_mlp_zero_grad(model);
+            rac_var_backward(loss);
+            rac_mlp_update(model, lr);
+
+            time_secs += bench_time_now_secs() - start;
+            allocs += bench_allocs() - allocs_start;
+            if (bench_live_allocs() - live_start > live_allocs) live_allocs = bench_live_allocs() - live_start;
+            nodes += mlp_cache_len(model) - cache_len + vt_plist_len(cache);
+
+            // release graph
+            while ((loss = vt_plist_pop_get(cache)) != NULL) rac_var_free(loss);
+            mlp_cache_release(model);
+        }
+
+        // report
+        bench_report((struct BenchResult) {
+            .name = "train_epoch",
+            .width = hidden[h],
+            .depth = 2,
+            .steps = epochs,
+            .nodes = nodes,
+            .samples = epochs * input_rows,
+            .allocs = allocs,
+            .live_allocs = live_allocs,
+            .time_secs = time_secs,
+        });
+
+        // free
+        vt_plist_destroy(cache);
+        rac_var_free(batch_size);
+        rac_mlp_free(model);
+    }
+
+    // free
+    plist_var_free(target);
+    VT_FOREACH(i, 0, vt_plist_len(input)) plist_var_free(vt_plist_get(input, i));
+    vt_plist_destroy(input);
+}
+
+/**
+ * HELPER FUNCTIONS
+ */
+
+// returns current time in seconds
+double bench_time_now_secs(void) {
+    struct timespec ts = {0};
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// returns the number of allocations made through the bench allocator so far
+size_t bench_allocs(void) {
+    return alloctr->stats.count_allocs;
+}
+
+// returns the number of allocations made through the bench allocator that are not freed yet
+size_t bench_live_allocs(void) {
+    return alloctr->stats.count_allocs - alloctr->stats.count_frees;
+}
+
+// returns process-wide peak resident memory in KB (0 if unsupported)
+size_t bench_peak_memory_kb(void) {
+#if !defined(_WIN32) && !defined(_WIN64)
+    struct rusage usage = {0};
+    getrusage(RUSAGE_SELF, &usage);
+    #if defined(__APPLE__)
+        return (size_t)usage.ru_maxrss / 1024; // bytes on osx
+    #else
+        return (size_t)usage.ru_maxrss;
+    #endif
+#else
+    return 0;
+#endif
+}
+
+// writes result as a JSON object
+void bench_report(const struct BenchResult result) {
+    const double time_secs = (result.time_secs > 0) ? result.time_secs : 1e-9;
+    fprintf(out, "%s    {", results_num++ ? ",\n" : "");
+    fprintf(out, "\"name\": \"%s\", ", result.name);
+    fprintf(out, "\"width\": %zu, ", result.width);
+    fprintf(out, "\"depth\": %zu, ", result.depth);
+    fprintf(out, "\"steps\": %zu, ", result.steps);
+    fprintf(out, "\"time_secs\": %.6f, ", result.time_secs);
+    fprintf(out, "\"nodes_per_sec\": %.1f, ", (double)result.nodes / time_secs);
+    fprintf(out, "\"samples_per_sec\": %.1f, ", (double)result.samples / time_secs);
+    fprintf(out, "\"allocs_per_step\": %.1f, ", (double)result.allocs / (double)result.steps);
+    fprintf(out, "\"live_allocs\": %zu", result.live_allocs);
+    fprintf(out, "}");
+}
+
+// returns the number of nodes cached by mlp neurons
+size_t mlp_cache_len(const rac_mlp_t *const mlp) {
+    size_t len = 0;
+    VT_FOREACH(i, 0, vt_plist_len(mlp->layers)) {
+        rac_layer_t *layer = vt_plist_get(mlp->layers, i);
+        VT_FOREACH(j, 0, vt_plist_len(layer->neurons)) {
+            rac_neuron_t *neuron = vt_plist_get(layer->neurons, j);
+            len += vt_plist_len(neuron->cache);
+        }
+    }
+
+    return len;
+}
+
+// frees nodes cached by mlp neurons
+void mlp_cache_release(rac_mlp_t *const mlp) {
+    VT_FOREACH(i, 0, vt_plist_len(mlp->layers)) {
+        rac_layer_t *layer = vt_plist_get(mlp->layers, i);
+        VT_FOREACH(j, 0, vt_plist_len(layer->neurons)) {
+            rac_neuron_t *neuron = vt_plist_get(layer->neurons, j);
+            VT_FOREACH(k, 0, vt_plist_len(neuron->cache)) rac_var_free(vt_plist_get(neuron->cache, k));
+            vt_plist_clear(neuron->cache);
+        }
+    }
+}
+
+// frees plist and its contents
+void plist_var_free(vt_plist_t *list) {
+    assert(list != NULL);
+
+    // free list contents
+    VT_FOREACH(i, 0, vt_plist_len(list)) rac_var_free(vt_plist_get(list, i));
+
+    // free list itself
+    vt_plist_destroy(list);
+}
@@ -0,0 +1,90 @@
+#ifndef RACCOON_AUXILIARY_GRAD_H
+#define RACCOON_AUXILIARY_GRAD_H
+
+/** GRAD MODULE (differentiable gradients and Hessian-vector products)
+ * Functions:
+    - rac_grad_make
+    - rac_grad_free
+    - rac_grad_get
+    - rac_grad_update
+    - rac_grad_hvp
+*/
+
+#include "raccoon/core/core.h"
+#include "raccoon/core/variable.h"
+#include "raccoon/core/graph.h"
+#include "raccoon/auxiliary/jvp.h"
+
+// Gradient of a root built as a graph: every gradient is a regular node that can be differentiated again
+typedef struct RaccoonGrad {
+    // nodes of the original graph in topological order and node -> position
+    vt_plist_t *nodes;
+    rac_graph_map_t *index;
+
+    // gradient node of each original node, indexed like `nodes`; `NULL` if it does not affect the root
+    rac_var_t **adjoints;
+
+    // nodes created for the gradient graph (owned)
+    vt_plist_t *created;
+
+    // forward mode over the gradient graph, used for Hessian-vector products
+    rac_jvp_t *jvp;
+
+    // allocator: if `NULL`, then calloc/realloc/free is used
+    struct VitaBaseAllocatorType *alloctr;
+} rac_grad_t;
+
+/*
+    Grad creation/destruction
+*/
+
+/**
+ * @brief Builds the gradient graph of a root (a backward pass that records operations instead of accumulating values)
+ * @param alloctr allocator instance
+ * @param root graph output; the graph must outlive the grad instance
+ * @returns valid `rac_grad_t*` or asserts on failure
+ * @note Records the local derivatives of `rac_var_partials`, so gradient node values equal `grad` after a backward pass.
+ * @note Asserts on custom operations and dot products: their derivatives cannot be recorded as graph operations.
+ */
+extern rac_grad_t *rac_grad_make(struct VitaBaseAllocatorType *const alloctr, rac_var_t *const root);
+
+/**
+ * @brief Frees a grad instance and the nodes it created
+ * @param grad instance
+ * @returns None
+ */
+extern void rac_grad_free(rac_grad_t *grad);
+
+/*
+    Grad operations
+*/
+
+/**
+ * @brief Returns the gradient node of the root with respect to a node
+ * @param grad instance
+ * @param var node of the original graph
+ * @returns gradient node, or `NULL` if `var` does not affect the root
+ */
+extern rac_var_t *rac_grad_get(const rac_grad_t *const grad, const rac_var_t *const var);
+
+/**
+ * @brief Recomputes the original graph and all gradient nodes after inputs changed
+ * @param grad instance
+ * @returns None
+ */
+extern void rac_grad_update(rac_grad_t *const grad);
+
+/**
+ * @brief Computes a Hessian-vector product `H v` with forward-over-reverse differentiation
+ * @param grad instance
+ * @param len number of variables
+ * @param wrt leaf nodes the Hessian is taken with respect to
+ * @param v direction, `len` values
+ * @param hv result, `len` values
+ * @returns None
+ * @note Costs one forward sweep over the original and gradient graphs; values are recomputed as well.
+ */
+extern void rac_grad_hvp(rac_grad_t *const grad, const size_t len, rac_var_t *const wrt[len], const rac_float *const v, rac_float *const hv);
+
+#endif // RACCOON_AUXILIARY_GRAD_H
+
@@ -0,0 +1,164 @@
+#ifndef RACCOON_AUXILIARY_INSTRUMENT_H
+#define RACCOON_AUXILIARY_INSTRUMENT_H
+
+/** INSTRUMENT MODULE
+ * Macros:
+    - RAC_INSTRUMENT_NODE
+    - RAC_INSTRUMENT_ALLOC
+    - RAC_INSTRUMENT_FREE
+    - RAC_INSTRUMENT_BACKWARD
+    - RAC_INSTRUMENT_SPAN_BEGIN
+    - RAC_INSTRUMENT_SPAN_END
+ * Functions:
+    - rac_instrument_reset
+    - rac_instrument_free
+    - rac_instrument_get_stats
+    - rac_instrument_print_stats
+    - rac_instrument_dump_trace
+    - rac_instrument_count_node
+    - rac_instrument_count_alloc
+    - rac_instrument_count_free
+    - rac_instrument_count_backward
+    - rac_instrument_span_begin
+    - rac_instrument_span_end
+*/
+
+#include "raccoon/core/core.h"
+
+// maximum number of trace events kept in memory (older events are kept, newer are dropped)
+#define RAC_INSTRUMENT_TRACE_EVENTS_MAX (1 << 20)
+
+// instrumented code regions
+enum RaccoonInstrumentSpan {
+    RAC_INSTRUMENT_SPAN_MLP_FORWARD,    // rac_mlp_forward
+    RAC_INSTRUMENT_SPAN_LAYER_FORWARD,  // rac_layer_forward
+    RAC_INSTRUMENT_SPAN_BACKWARD,       // rac_var_backward
+    RAC_INSTRUMENT_SPAN_MLP_UPDATE,     // rac_mlp_update
+    RAC_INSTRUMENT_SPAN_LAYER_UPDATE,   // rac_layer_update
+    RAC_INSTRUMENT_SPAN_COUNT           // number of elements
+};
+
+// Collected counters (hooks are thread-safe: counters and trace events are guarded by a spin lock)
+struct RaccoonInstrumentStats {
+    // nodes created per operation (indexed by `op`, leaves have op `0`)
+    size_t nodes[256];
+    size_t nodes_total;
+
+    // backward
+    size_t backward_calls;              // rac_var_backward invocations
+    size_t backward_nodes;              // node backward functions invoked
+
+    // allocator
+    size_t alloc_calls;
+    size_t alloc_bytes;
+    size_t free_calls;
+
+    // time spans
+    size_t span_calls[RAC_INSTRUMENT_SPAN_COUNT];
+    double span_secs[RAC_INSTRUMENT_SPAN_COUNT];
+
+    // trace events dropped after RAC_INSTRUMENT_TRACE_EVENTS_MAX was reached
+    size_t trace_dropped;
+};
+
+// hooks: compiled out unless `RACCOON_USE_INSTRUMENTATION` is defined
+#if defined(RACCOON_USE_INSTRUMENTATION)
+    #define RAC_INSTRUMENT_NODE(op) rac_instrument_count_node(op)
+    #define RAC_INSTRUMENT_ALLOC(bytes) rac_instrument_count_alloc(bytes)
+    #define RAC_INSTRUMENT_FREE() rac_instrument_count_free()
+    #define RAC_INSTRUMENT_BACKWARD(nodes) rac_instrument_count_backward(nodes)
+    #define RAC_INSTRUMENT_SPAN_BEGIN(name) const double rac_instrument_span_##name = rac_instrument_span_begin()
+    #define RAC_INSTRUMENT_SPAN_END(name, span) rac_instrument_span_end(span, rac_instrument_span_##name)
+#else
+    #define RAC_INSTRUMENT_NODE(op)
+    #define RAC_INSTRUMENT_ALLOC(bytes)
+    #define RAC_INSTRUMENT_FREE()
+    #define RAC_INSTRUMENT_BACKWARD(nodes)
+    #define RAC_INSTRUMENT_SPAN_BEGIN(name)
+    #define RAC_INSTRUMENT_SPAN_END(name, span)
+#endif
+
+/*
+    Instrumentation control
+*/
+
+/**
+ * @brief Resets all counters and drops collected trace events
+ * @returns None
+ */
+extern void rac_instrument_reset(void);
+
+/**
+ * @brief Resets all counters and releases the trace event buffer
+ * @returns None
+ * @note Call once instrumentation is no longer needed (e.g. before exit); recording afterwards is allowed
+ */
+extern void rac_instrument_free(void);
+
+/**
+ * @brief Returns collected counters
+ * @returns valid `struct RaccoonInstrumentStats*` (all zeros if instrumentation is compiled out)
+ * @note The counters are read without locking: read them while no other thread is recording
+ */
+extern const struct RaccoonInstrumentStats *rac_instrument_get_stats(void);
+
+/**
+ * @brief Prints collected counters to stdout
+ * @returns None
+ */
+extern void rac_instrument_print_stats(void);
+
+/**
+ * @brief Writes collected time spans in Chrome `trace_event` JSON format
+ * @param path output file path
+ * @returns `true` upon success
+ * @note Open the file with chrome://tracing or https://ui.perfetto.dev
+ */
+extern bool rac_instrument_dump_trace(const char *const path);
+
+/*
+    Hooks (use the RAC_INSTRUMENT_* macros instead)
+*/
+
+/**
+ * @brief Counts a created node
+ * @param op node operation
+ * @returns None
+ */
+extern void rac_instrument_count_node(const char op);
+
+/**
+ * @brief Counts an allocation
+ * @param bytes number of bytes allocated
+ * @returns None
+ */
+extern void rac_instrument_count_alloc(const size_t bytes);
+
+/**
+ * @brief Counts a deallocation
+ * @returns None
+ */
+extern void rac_instrument_count_free(void);
+
+/**
+ * @brief Counts a backward pass
+ * @param nodes number of nodes visited
+ * @returns None
+ */
+extern void rac_instrument_count_backward(const size_t nodes);
+
+/**
+ * @brief Starts a time span
+ * @returns time stamp in seconds
+ */
+extern double rac_instrument_span_begin(void);
+
+/**
+ * @brief Ends a time span and records a trace event
+ * @param span instrumented region
+ * @param start_secs time stamp returned by `rac_instrument_span_begin`
+ * @returns None
+ */
+extern void rac_instrument_span_end(const enum RaccoonInstrumentSpan span, const double start_secs);
+
+#endif // RACCOON_AUXILIARY_INSTRUMENT_H
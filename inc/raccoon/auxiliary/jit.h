@@ -0,0 +1,97 @@
+#ifndef RACCOON_AUXILIARY_JIT_H
+#define RACCOON_AUXILIARY_JIT_H
+
+/** JIT MODULE
+ * Functions:
+    - rac_jit_make
+    - rac_jit_free
+    - rac_jit_update
+    - rac_jit_backward
+    - rac_jit_hash
+*/
+
+#include "raccoon/core/core.h"
+#include "raccoon/core/variable.h"
+#include "raccoon/auxiliary/tape.h"
+
+// default compiler command, overridden by the `RAC_JIT_CC` or `CC` environment variables (run without a shell, split on whitespace)
+#define RAC_JIT_CC_DEFAULT "cc"
+
+// flags passed to the compiler (contraction is off so that results match the interpreter)
+#define RAC_JIT_CFLAGS "-O2 -shared -fPIC -ffp-contract=off"
+
+// maximum length of generated file paths
+#define RAC_JIT_PATH_MAX 4096
+
+// Native code compiled from a tape: straight-line forward and backward over flat arrays
+typedef struct RaccoonJit {
+    // shared object handle and entry points
+    void *handle;
+    void (*forward)(rac_float *const data);
+    void (*backward)(const rac_float *const data, rac_float *const grad);
+
+    // graph nodes: external inputs (parents missing from the tape) first, then tape nodes in tape order
+    rac_var_t **nodes;
+    size_t len;
+    size_t external_len;
+
+    // value and gradient buffers indexed like `nodes`
+    rac_float *data;
+    rac_float *grad;
+
+    // graph structure hash and whether the shared object was loaded from the cache
+    uint64_t hash;
+    bool cached;
+
+    // allocator: if `NULL`, then calloc/realloc/free is used
+    struct VitaBaseAllocatorType *alloctr;
+} rac_jit_t;
+
+/*
+    JIT creation/destruction
+*/
+
+/**
+ * @brief Compiles a tape into native code and loads it
+ * @param tape compiled tape instance; must outlive the jit instance
+ * @param cache_dir directory for shared objects (`<cache_dir>/rac_jit_<hash>.so`); temporary sources are removed after the build
+ * @returns valid `rac_jit_t*` or `NULL` if the tape has unsupported operations or compilation/loading failed
+ * @note Shared objects are reused across runs if a graph with the same hash was compiled before.
+ * @note Not supported on Windows (always returns `NULL`).
+ */
+extern rac_jit_t *rac_jit_make(const rac_tape_t *const tape, const char *const cache_dir);
+
+/**
+ * @brief Unloads native code and frees the jit instance (tape nodes are not freed)
+ * @param jit jit instance
+ * @returns None
+ */
+extern void rac_jit_free(rac_jit_t *jit);
+
+/*
+    JIT operations
+*/
+
+/**
+ * @brief Recomputes the tape values and zeroes gradients, same as `rac_tape_update`
+ * @param jit jit instance
+ * @returns None
+ */
+extern void rac_jit_update(rac_jit_t *const jit);
+
+/**
+ * @brief Backpropagates from the last tape node, like `rac_var_backward(rac_tape_last(tape))`
+ * @param jit jit instance
+ * @returns None
+ */
+extern void rac_jit_backward(rac_jit_t *const jit);
+
+/**
+ * @brief Hashes the tape structure (operations and wiring, not values)
+ * @param tape tape instance
+ * @returns 64-bit FNV-1a hash
+ */
+extern uint64_t rac_jit_hash(const rac_tape_t *const tape);
+
+#endif // RACCOON_AUXILIARY_JIT_H
+
@@ -0,0 +1,101 @@
+#ifndef RACCOON_AUXILIARY_JVP_H
+#define RACCOON_AUXILIARY_JVP_H
+
+/** JVP MODULE (forward-mode differentiation)
+ * Functions:
+    - rac_jvp_make
+    - rac_jvp_make_tape
+    - rac_jvp_free
+    - rac_jvp_zero
+    - rac_jvp_seed
+    - rac_jvp_forward
+    - rac_jvp_tangent
+*/
+
+#include "raccoon/core/core.h"
+#include "raccoon/core/variable.h"
+#include "raccoon/core/graph.h"
+#include "raccoon/auxiliary/tape.h"
+
+// Tangents of a graph: one forward sweep gives the derivatives of every node with respect to a seeded direction
+typedef struct RaccoonJvp {
+    // graph nodes in topological order and node -> position
+    vt_plist_t *nodes;
+    rac_graph_map_t *index;
+
+    // positions of each node's operands (`RAC_VAR_OPERANDS_LEN` per node) and tangent of each node, indexed like `nodes`
+    size_t *parents;
+    rac_float *tangents;
+
+    // allocator: if `NULL`, then calloc/realloc/free is used
+    struct VitaBaseAllocatorType *alloctr;
+} rac_jvp_t;
+
+/*
+    JVP creation/destruction
+*/
+
+/**
+ * @brief Creates a forward-mode instance over everything the outputs depend on
+ * @param alloctr allocator instance
+ * @param outputs graph outputs; nodes must outlive the jvp instance
+ * @returns valid `rac_jvp_t*` or asserts on failure
+ * @note The graph structure is captured at creation: make a new instance after fusing or rebuilding the graph.
+ * @note Asserts if a node has no derivative rule (see `rac_var_has_rule`); register custom operations with `rac_var_register_op`.
+ *       Dot products (`rac_mlp_forward_array`) are rejected: their weights are not operands.
+ */
+extern rac_jvp_t *rac_jvp_make(struct VitaBaseAllocatorType *const alloctr, const vt_plist_t *const outputs);
+
+/**
+ * @brief Creates a forward-mode instance over a tape (and the inputs its nodes use)
+ * @param tape tape instance; must outlive the jvp instance
+ * @returns valid `rac_jvp_t*` or asserts on failure
+ */
+extern rac_jvp_t *rac_jvp_make_tape(const rac_tape_t *const tape);
+
+/**
+ * @brief Frees a jvp instance
+ * @param jvp instance
+ * @returns None
+ */
+extern void rac_jvp_free(rac_jvp_t *jvp);
+
+/*
+    JVP operations
+*/
+
+/**
+ * @brief Sets all tangents to zero
+ * @param jvp instance
+ * @returns None
+ */
+extern void rac_jvp_zero(rac_jvp_t *const jvp);
+
+/**
+ * @brief Sets the tangent (direction component) of an input
+ * @param jvp instance
+ * @param var leaf node of the graph
+ * @param tangent value, e.g. `1` to differentiate with respect to `var`
+ * @returns None
+ */
+extern void rac_jvp_seed(rac_jvp_t *const jvp, const rac_var_t *const var, const rac_float tangent);
+
+/**
+ * @brief Recomputes values and propagates tangents in one forward sweep
+ * @param jvp instance
+ * @returns None
+ * @note Like `rac_tape_update`, operation nodes get their gradients reset.
+ * @note Local derivatives come from `rac_var_partials`, so tangents agree with the gradients of `rac_var_backward`.
+ */
+extern void rac_jvp_forward(rac_jvp_t *const jvp);
+
+/**
+ * @brief Returns the tangent of a node after `rac_jvp_forward`
+ * @param jvp instance
+ * @param var graph node
+ * @returns d(var)/d(direction)
+ */
+extern rac_float rac_jvp_tangent(const rac_jvp_t *const jvp, const rac_var_t *const var);
+
+#endif // RACCOON_AUXILIARY_JVP_H
+
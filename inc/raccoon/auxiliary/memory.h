@@ -0,0 +1,103 @@
+#ifndef RACCOON_AUXILIARY_MEMORY_H
+#define RACCOON_AUXILIARY_MEMORY_H
+
+/** MEMORY MODULE
+ * Functions:
+    - rac_memory_report
+    - rac_memory_print_report
+    - rac_memory_step_begin
+    - rac_memory_neuron_cache_bytes
+    - rac_memory_neuron_bytes
+    - rac_memory_layer_bytes
+    - rac_memory_mlp_bytes
+    - rac_memory_tape_bytes
+*/
+
+#include "raccoon/core/core.h"
+#include "raccoon/core/counter.h"
+#include "raccoon/nn/mlp.h"
+#include "raccoon/auxiliary/tape.h"
+
+// Graph memory report
+struct RaccoonMemoryReport {
+    // live `rac_var_t` nodes (process-wide, see `struct RaccoonCounterStats`)
+    size_t leaves;          // nodes without an operation: parameters, inputs, constants
+    size_t intermediates;   // operation results
+    size_t bytes_nodes;     // bytes allocated for live nodes
+    size_t cached;          // nodes held by the model's neuron caches (subset of the above)
+
+    // bytes attributed to the model
+    size_t bytes_params;    // parameters and their containers
+    size_t bytes_cache;     // neuron caches and their containers
+    size_t bytes_total;     // everything owned by the model
+
+    // high-water marks of live nodes and their bytes since the last `rac_memory_step_begin`
+    size_t peak_nodes;
+    size_t peak_bytes;
+};
+
+/*
+    Reports
+*/
+
+/**
+ * @brief Queries current graph memory usage
+ * @param mlp model to attribute bytes to; can be `NULL`
+ * @returns a filled `struct RaccoonMemoryReport`
+ * @note Node counters are process-wide relaxed atomics, always maintained (see `rac_counter_get_stats`).
+ */
+extern struct RaccoonMemoryReport rac_memory_report(const rac_mlp_t *const mlp);
+
+/**
+ * @brief Prints a memory report with a per-layer breakdown to stdout
+ * @param mlp model instance; can be `NULL`
+ * @returns None
+ */
+extern void rac_memory_print_report(const rac_mlp_t *const mlp);
+
+/**
+ * @brief Starts a new step: resets the high-water marks to the current live nodes and bytes
+ * @returns None
+ */
+extern void rac_memory_step_begin(void);
+
+/*
+    Bytes attributed to objects
+*/
+
+/**
+ * @brief Bytes held by the neuron cache (cached nodes and the container)
+ * @param neuron instance
+ * @returns number of bytes
+ */
+extern size_t rac_memory_neuron_cache_bytes(const rac_neuron_t *const neuron);
+
+/**
+ * @brief Bytes held by the neuron (parameters, cache and the neuron itself)
+ * @param neuron instance
+ * @returns number of bytes
+ */
+extern size_t rac_memory_neuron_bytes(const rac_neuron_t *const neuron);
+
+/**
+ * @brief Bytes held by the layer (neurons and the layer itself)
+ * @param layer instance
+ * @returns number of bytes
+ */
+extern size_t rac_memory_layer_bytes(const rac_layer_t *const layer);
+
+/**
+ * @brief Bytes held by the mlp (layers and the mlp itself)
+ * @param mlp instance
+ * @returns number of bytes
+ */
+extern size_t rac_memory_mlp_bytes(const rac_mlp_t *const mlp);
+
+/**
+ * @brief Bytes held by the tape (taped nodes and the tape itself)
+ * @param tape instance
+ * @returns number of bytes
+ */
+extern size_t rac_memory_tape_bytes(const rac_tape_t *const tape);
+
+#endif // RACCOON_AUXILIARY_MEMORY_H
@@ -0,0 +1,81 @@
+#ifndef RACCOON_AUXILIARY_STATIC_GRAPH_H
+#define RACCOON_AUXILIARY_STATIC_GRAPH_H
+
+/** STATIC GRAPH MODULE (build once, replay every step)
+ * Functions:
+    - rac_static_graph_make
+    - rac_static_graph_free
+    - rac_static_graph_forward
+    - rac_static_graph_backward
+    - rac_static_graph_step
+*/
+
+#include "raccoon/core/core.h"
+#include "raccoon/core/variable.h"
+#include "raccoon/core/graph.h"
+
+// A captured graph: nodes are recomputed in place, no nodes are created and the graph is not walked again
+typedef struct RaccoonStaticGraph {
+    // output (for example, the loss)
+    rac_var_t *root;
+
+    // graph nodes in topological order, ending with `root`
+    vt_plist_t *nodes;
+
+    // placeholders the graph depends on (`RAC_VAR_FLAG_PLACEHOLDER`), in topological order
+    vt_plist_t *placeholders;
+
+    // allocator: if `NULL`, then calloc/realloc/free is used
+    struct VitaBaseAllocatorType *alloctr;
+} rac_static_graph_t;
+
+/*
+    Static graph creation/destruction
+*/
+
+/**
+ * @brief Captures the graph of an output built once from placeholders (`rac_var_make_placeholder`)
+ * @param alloctr allocator instance
+ * @param root graph output; nodes must outlive the static graph (do not clear model caches)
+ * @returns valid `rac_static_graph_t*` or asserts on failure
+ * @note Every node must be recomputable by `rac_var_update`: custom activations have to be registered with
+ *       `rac_var_register_op`, otherwise their values would stay stale between steps.
+ */
+extern rac_static_graph_t *rac_static_graph_make(struct VitaBaseAllocatorType *const alloctr, rac_var_t *const root);
+
+/**
+ * @brief Frees a static graph instance (not the nodes)
+ * @param graph instance
+ * @returns None
+ */
+extern void rac_static_graph_free(rac_static_graph_t *graph);
+
+/*
+    Static graph operations
+*/
+
+/**
+ * @brief Recomputes every node from the current placeholder and parameter values, and zeroes all gradients
+ * @param graph instance
+ * @returns root value
+ * @note Nodes keep their operations: values built with the accumulator of `rac_neuron_forward` are recomputed
+ *       pairwise, which differs only in rounding in mixed precision builds.
+ */
+extern rac_float rac_static_graph_forward(rac_static_graph_t *const graph);
+
+/**
+ * @brief Backward pass from the root over the captured order
+ * @param graph instance
+ * @returns None
+ */
+extern void rac_static_graph_backward(rac_static_graph_t *const graph);
+
+/**
+ * @brief Forward and backward pass: one training step after the placeholders are set
+ * @param graph instance
+ * @returns root value
+ */
+extern rac_float rac_static_graph_step(rac_static_graph_t *const graph);
+
+#endif // RACCOON_AUXILIARY_STATIC_GRAPH_H
+
@@ -7,25 +7,60 @@
     - rac_tape_free 
     - rac_tape_reset 
     - rac_tape_update 
+    - rac_tape_mark_changed
+    - rac_tape_update_changed
     - rac_tape_push 
     - rac_tape_push_ex 
     - rac_tape_last 
     - rac_tape_compile 
+    - rac_tape_compile_ex 
     - rac_tape_compiled 
 */
 
 #include "raccoon/core/core.h"
 #include "raccoon/core/variable.h"
+#include "raccoon/core/graph.h"
 #include "vita/container/plist.h"
 
+// Tape optimization passes run by `rac_tape_compile_ex`
+enum RaccoonTapeOptimize {
+    RAC_TAPE_OPTIMIZE_NONE = 0,
+    RAC_TAPE_OPTIMIZE_FOLD = 1 << 0,    // fold nodes whose parents are all constants (RAC_VAR_FLAG_CONST)
+    RAC_TAPE_OPTIMIZE_CSE = 1 << 1,     // deduplicate identical (op, parent, parent) nodes
+    RAC_TAPE_OPTIMIZE_DCE = 1 << 2,     // drop nodes that do not reach the output (last tape element)
+    RAC_TAPE_OPTIMIZE_FUSE = 1 << 3,    // fuse mul/add, sub/mul and sqdiff/add chains into single nodes (runs before DCE)
+    RAC_TAPE_OPTIMIZE_DEFAULT = RAC_TAPE_OPTIMIZE_FOLD | RAC_TAPE_OPTIMIZE_CSE | RAC_TAPE_OPTIMIZE_DCE, // value-preserving passes
+    RAC_TAPE_OPTIMIZE_ALL = RAC_TAPE_OPTIMIZE_DEFAULT | RAC_TAPE_OPTIMIZE_FUSE,
+};
+
+// levels of a compiled tape narrower than this are replayed on one thread
+#define RAC_TAPE_PARALLEL_MIN 64
+
 // Variable tape for caching operations
 // When tape is locked (compiled), you can call update upon 'taped' data
 typedef struct RaccoonTape {
     vt_plist_t *list;
     struct VitaBaseAllocatorType *alloctr;
 
+    // nodes removed from `list` by optimization passes (kept alive until reset)
+    vt_plist_t *pruned;
+
     // lock the tape (make read-only)
     bool locked;
+
+    // replay levels built by compile: tape positions grouped by depth, level `l` is `levels[level_offsets[l] .. level_offsets[l+1]]`
+    size_t *levels;
+    size_t *level_offsets;
+    size_t levels_len;
+    size_t width; // widest level
+
+    // dependents built by compile: node -> id (tape position, then parents that are not on the tape) and consumers of each id
+    rac_graph_map_t *index;
+    size_t *consumer_offsets;
+    size_t *consumers;
+
+    // tape positions to recompute on the next `rac_tape_update_changed`
+    bool *changed;
 } rac_tape_t;
 
 /* 
@@ -61,9 +96,28 @@ extern void rac_tape_reset(rac_tape_t *const tape);
  * @brief Update tape elements values starting from the begining of the tape
  * @param tape tape instance
  * @returns None
+ * @note A compiled tape is replayed level by level: nodes of one level do not use each other and are
+ *       updated on several threads when the library is built with OpenMP. Results match the sequential replay.
  */
 extern void rac_tape_update(rac_tape_t *const tape);
 
+/**
+ * @brief Marks a changed input, so that the next `rac_tape_update_changed` recomputes the nodes that depend on it
+ * @param tape compiled tape instance
+ * @param var changed variable: a tape node or an input of one (dot product weights included)
+ * @returns None
+ */
+extern void rac_tape_mark_changed(rac_tape_t *const tape, const rac_var_t *const var);
+
+/**
+ * @brief Recomputes only the tape nodes downstream of the marked inputs, in tape order, and clears the marks
+ * @param tape compiled tape instance
+ * @returns number of recomputed nodes
+ * @note Values of recomputed nodes are the same as after `rac_tape_update`; nodes that were not recomputed keep their gradients.
+ *       If the tape has a node pushed before one of its parents, the whole tape is replayed.
+ */
+extern size_t rac_tape_update_changed(rac_tape_t *const tape);
+
 /**
  * @brief Push an element to the tape
  * @param tape tape instance
@@ -104,13 +158,27 @@ extern rac_var_t *rac_tape_get(const rac_tape_t *const tape, const size_t idx);
 extern rac_var_t *rac_tape_last(const rac_tape_t *const tape);
 
 /**
- * @brief Compiles (locks) the tape
+ * @brief Compiles (locks) the tape, folding constants, deduplicating common subexpressions and dropping dead nodes
  * @param tape tape instance
  * @returns None
  * @note Tape can only be reset `rac_tape_reset(tape)` afterwards.
+ * @note Same as `rac_tape_compile_ex(tape, RAC_TAPE_OPTIMIZE_DEFAULT)`; fusion is opt-in (`RAC_TAPE_OPTIMIZE_FUSE`),
+ *       use `RAC_TAPE_OPTIMIZE_NONE` to keep the recorded nodes as they are.
  */
 extern void rac_tape_compile(rac_tape_t *const tape);
 
+/**
+ * @brief Compiles (locks) the tape, extended
+ * @param tape tape instance
+ * @param passes bitmask of `enum RaccoonTapeOptimize`
+ * @returns None
+ * @note Tape can only be reset `rac_tape_reset(tape)` afterwards.
+ * @note Nodes are expected to be pushed after their parents. The last tape element is the output; no pass replaces
+ *       or removes it, so a pointer to it stays valid. Removed nodes stay alive in `tape->pruned`; nodes that were
+ *       deduplicated are no longer updated, so read other results from the nodes that remain on the tape.
+ */
+extern void rac_tape_compile_ex(rac_tape_t *const tape, const int passes);
+
 /**
  * @brief Checks if tape is compiled (locked)
  * @param tape tape instance
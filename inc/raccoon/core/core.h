@@ -9,6 +9,7 @@
 #include "vita/core/core.h"
 #include "vita/util/debug.h"
 #include "vita/allocator/mallocator.h"
+#include "raccoon/core/symbols.h"
 
 #if defined(RACCOON_USE_TYPE_DOUBLE)
     #define RAC_FLOAT double
@@ -24,6 +25,9 @@
     #define RAC_EXP exp
     #define RAC_TANH tanh
     #define RAC_LOG log
+    #define RAC_SIN sin
+    #define RAC_COS cos
+    #define RAC_FMA fma
     #define RAC_CONST_EPSILON __DBL_EPSILON__
 #elif defined(RACCOON_USE_TYPE_LONG_DOUBLE)
     #define RAC_FLOAT long double
@@ -39,6 +43,9 @@
     #define RAC_EXP expl
     #define RAC_TANH tanhl
     #define RAC_LOG logl
+    #define RAC_SIN sinl
+    #define RAC_COS cosl
+    #define RAC_FMA fmal
     #define RAC_CONST_EPSILON __LDBL_EPSILON__
 #else
     #define RAC_FLOAT float
@@ -54,10 +61,21 @@
     #define RAC_EXP expf
     #define RAC_TANH tanhf
     #define RAC_LOG logf
+    #define RAC_SIN sinf
+    #define RAC_COS cosf
+    #define RAC_FMA fmaf
     #define RAC_CONST_EPSILON __FLT_EPSILON__
 #endif
 typedef RAC_FLOAT rac_float;
 
+// accumulator for dot products and sums: double in float builds with RACCOON_USE_MIXED_PRECISION
+#if defined(RACCOON_USE_MIXED_PRECISION) && !defined(RACCOON_USE_TYPE_DOUBLE) && !defined(RACCOON_USE_TYPE_LONG_DOUBLE)
+    #define RAC_ACC_FLOAT double
+#else
+    #define RAC_ACC_FLOAT RAC_FLOAT
+#endif
+typedef RAC_ACC_FLOAT rac_acc_float;
+
 // raccoon error codes
 #define RAC_i_GENERATE_RAC_STATUS(apply) \
     apply(RAC_STATUS_ERROR_IS_NULL)                  /* element wasn't initialized or is NULL */ \
@@ -0,0 +1,54 @@
+#ifndef RACCOON_CORE_COUNTER_H
+#define RACCOON_CORE_COUNTER_H
+
+/** COUNTER MODULE (live graph nodes)
+ * Macros:
+    - RAC_COUNTER_NODE
+ * Functions:
+    - rac_counter_get_stats
+    - rac_counter_step_begin
+    - rac_counter_count_node
+*/
+
+#include "raccoon/core/core.h"
+
+// hook: always on (a few relaxed atomic updates per node)
+#define RAC_COUNTER_NODE(leaf, bytes, delta) rac_counter_count_node(leaf, bytes, delta)
+
+// Live node counters (process-wide; updated from any thread)
+struct RaccoonCounterStats {
+    size_t leaves;          // nodes without an operation (`op == 0`): parameters, inputs, constants
+    size_t intermediates;   // operation results, dot products included
+    size_t bytes;           // bytes allocated for live nodes
+
+    // high-water marks since the last `rac_counter_step_begin`
+    size_t peak_nodes;
+    size_t peak_bytes;
+};
+
+/**
+ * @brief Queries the live node counters
+ * @returns a filled `struct RaccoonCounterStats`
+ */
+extern struct RaccoonCounterStats rac_counter_get_stats(void);
+
+/**
+ * @brief Starts a new step: resets the high-water marks to the current live nodes and bytes
+ * @returns None
+ */
+extern void rac_counter_step_begin(void);
+
+/*
+    Hooks (use the RAC_COUNTER_NODE macro instead)
+*/
+
+/**
+ * @brief Tracks creation (+1) or destruction (-1) of a node
+ * @param leaf whether the node is a leaf (`op == 0`)
+ * @param bytes bytes allocated for the node
+ * @param delta +1 or -1
+ * @returns None
+ */
+extern void rac_counter_count_node(const bool leaf, const size_t bytes, const int delta);
+
+#endif // RACCOON_CORE_COUNTER_H
@@ -0,0 +1,42 @@
+#ifndef RACCOON_CORE_GEMM_H
+#define RACCOON_CORE_GEMM_H
+
+/** GEMM MODULE (blocked dense matrix multiply)
+ * Functions:
+    - rac_gemm
+*/
+
+#include "raccoon/core/core.h"
+
+// block sizes: a packed `K x N` block of `b` (16 KiB in float builds) stays in L1 while rows of `a` stream over it
+#define RAC_GEMM_BLOCK_K 64
+#define RAC_GEMM_BLOCK_N 64
+
+/**
+ * @brief Row-major matrix multiply `c (+)= op(a) * op(b)`, where `op(a)` is `m x k` and `op(b)` is `k x n`
+ * @param trans_a use `a` transposed: `a` is stored `k x m` instead of `m x k`
+ * @param trans_b use `b` transposed: `b` is stored `n x k` instead of `k x n`
+ * @param m rows of `c`
+ * @param n columns of `c`
+ * @param k inner dimension
+ * @param a left matrix
+ * @param b right matrix
+ * @param accumulate add to `c` instead of overwriting it
+ * @param c `m x n` result
+ * @returns None
+ * @note Sums within a `RAC_GEMM_BLOCK_K` block are accumulated in `rac_acc_float`.
+ */
+extern void rac_gemm(
+    const bool trans_a,
+    const bool trans_b,
+    const size_t m,
+    const size_t n,
+    const size_t k,
+    const rac_float *const a,
+    const rac_float *const b,
+    const bool accumulate,
+    rac_float *const c
+);
+
+#endif // RACCOON_CORE_GEMM_H
+
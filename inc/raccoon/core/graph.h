@@ -0,0 +1,132 @@
+#ifndef RACCOON_CORE_GRAPH_H
+#define RACCOON_CORE_GRAPH_H
+
+/** GRAPH MODULE
+ * Functions:
+    - rac_graph_map_make
+    - rac_graph_map_free
+    - rac_graph_map_set
+    - rac_graph_map_get
+    - rac_graph_map_len
+    - rac_graph_map_clear
+    - rac_graph_topo_sort
+    - rac_graph_topo_sort_list
+    - rac_graph_backward
+    - rac_graph_fuse_list
+*/
+
+#include "raccoon/core/core.h"
+#include "raccoon/core/variable.h"
+#include "vita/container/plist.h"
+
+// Open-addressing hash map from a pointer (node) to an index, used by graph passes
+typedef struct RaccoonGraphMap {
+    // keys and values
+    const void **keys;
+    size_t *values;
+
+    // number of elements and number of slots (power of two)
+    size_t len;
+    size_t capacity;
+
+    // allocator: if `NULL`, then calloc/realloc/free is used
+    struct VitaBaseAllocatorType *alloctr;
+} rac_graph_map_t;
+
+/*
+    Map creation/destruction
+*/
+
+/**
+ * @brief Creates a map
+ * @param alloctr allocator instance
+ * @param expected_len expected number of elements (the map grows if needed)
+ * @returns valid `rac_graph_map_t*` or asserts on failure
+ */
+extern rac_graph_map_t *rac_graph_map_make(struct VitaBaseAllocatorType *const alloctr, const size_t expected_len);
+
+/**
+ * @brief Frees a map instance
+ * @param map instance
+ * @returns None
+ */
+extern void rac_graph_map_free(rac_graph_map_t *map);
+
+/*
+    Map operations
+*/
+
+/**
+ * @brief Inserts or updates an element
+ * @param map instance
+ * @param key non-NULL pointer
+ * @param value index
+ * @returns None
+ */
+extern void rac_graph_map_set(rac_graph_map_t *const map, const void *const key, const size_t value);
+
+/**
+ * @brief Looks up an element
+ * @param map instance
+ * @param key pointer
+ * @param value where to store the index if found; can be `NULL`
+ * @returns `true` if found
+ */
+extern bool rac_graph_map_get(const rac_graph_map_t *const map, const void *const key, size_t *const value);
+
+/**
+ * @brief Returns number of elements
+ * @param map instance
+ * @returns ditto
+ */
+extern size_t rac_graph_map_len(const rac_graph_map_t *const map);
+
+/**
+ * @brief Removes all elements, keeping the slots
+ * @param map instance
+ * @returns None
+ */
+extern void rac_graph_map_clear(rac_graph_map_t *const map);
+
+/*
+    Graph passes
+*/
+
+/**
+ * @brief Lists all nodes reachable from the root, parents before their consumers
+ * @param root graph output
+ * @returns a list of nodes ending with `root` or asserts on failure
+ */
+extern vt_plist_t *rac_graph_topo_sort(rac_var_t *const root);
+
+/**
+ * @brief Lists all nodes reachable from any of the roots, parents before their consumers
+ * @param roots graph outputs (for example, a tape's node list)
+ * @returns a list of nodes, each listed once, or asserts on failure
+ */
+extern vt_plist_t *rac_graph_topo_sort_list(const vt_plist_t *const roots);
+
+/**
+ * @brief Backward pass from several outputs whose gradients are already set
+ * @param roots graph outputs with seeded `grad` (for example, gradients flowing in from a later part of the graph)
+ * @returns None
+ * @note `rac_var_backward(root)` is the same as seeding `root->grad = 1` and calling this with `{ root }`.
+ */
+extern void rac_graph_backward(const vt_plist_t *const roots);
+
+/**
+ * @brief Fuses operation chains of a topologically ordered node list into single nodes
+ * @param nodes node list, parents before their consumers (for example, a tape's node list)
+ * @param replaced list that receives the nodes replaced by new fused nodes
+ * @returns number of fused nodes
+ * @note Rewrites `mul -> add` into `fma`, `sub -> mul` (squaring) into `sqdiff`, and `sqdiff -> add` into `sqdiff_acc`.
+ * @note Values and gradients of the fused graph equal those of the original one (up to the rounding of `fma`).
+ * @note Squares are rewritten in place. Fused nodes with an accumulator are new nodes: they take the place of the
+ *       `add` node in `nodes` and in its consumers from `nodes`, and are owned by whoever owns the list. The replaced
+ *       nodes go to `replaced`, so the caller can free them once nothing outside the list uses them. The last node
+ *       is the output and is never replaced, so a pointer to it stays valid.
+ * @note Only intermediate nodes with a single consumer in `nodes` are absorbed; they stay in the list.
+ */
+extern size_t rac_graph_fuse_list(vt_plist_t *const nodes, vt_plist_t *const replaced);
+
+#endif // RACCOON_CORE_GRAPH_H
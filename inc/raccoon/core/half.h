@@ -0,0 +1,165 @@
+#ifndef RACCOON_CORE_HALF_H
+#define RACCOON_CORE_HALF_H
+
+/** HALF MODULE (16-bit floating point storage)
+ * Functions:
+    - rac_half_from_float
+    - rac_half_to_float
+    - rac_half_pack
+    - rac_half_unpack
+    - rac_bf16_from_float
+    - rac_bf16_to_float
+    - rac_fp16_from_float
+    - rac_fp16_to_float
+*/
+
+#include "raccoon/core/core.h"
+
+// 16-bit storage formats (computation is always done in `rac_float`)
+enum RaccoonHalfType {
+    RAC_HALF_BF16,  // bfloat16: 8-bit exponent, 7-bit mantissa (float range, lower precision)
+    RAC_HALF_FP16,  // IEEE 754 binary16: 5-bit exponent, 10-bit mantissa (max 65504)
+};
+
+// 16-bit floating point value
+typedef uint16_t rac_half_t;
+
+/*
+    Scalar conversions (round to nearest even)
+*/
+
+/**
+ * @brief Converts a float to bfloat16
+ * @param value float value
+ * @returns bfloat16 bits
+ */
+static inline rac_half_t rac_bf16_from_float(const float value) {
+    uint32_t bits = 0;
+    memcpy(&bits, &value, sizeof(bits));
+    if ((bits & 0x7fffffff) > 0x7f800000) return (rac_half_t)((bits >> 16) | 0x40); // quiet NaN
+    bits += 0x7fff + ((bits >> 16) & 1);
+    return (rac_half_t)(bits >> 16);
+}
+
+/**
+ * @brief Converts a bfloat16 to float (exact)
+ * @param value bfloat16 bits
+ * @returns float value
+ */
+static inline float rac_bf16_to_float(const rac_half_t value) {
+    const uint32_t bits = (uint32_t)value << 16;
+    float result = 0;
+    memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+/**
+ * @brief Converts a float to IEEE 754 half precision
+ * @param value float value
+ * @returns fp16 bits; values beyond the range become infinity, tiny values become subnormals or zero
+ */
+static inline rac_half_t rac_fp16_from_float(const float value) {
+    uint32_t x = 0;
+    memcpy(&x, &value, sizeof(x));
+    const uint32_t sign = (x >> 16) & 0x8000;
+    x &= 0x7fffffff;
+
+    // infinity, NaN and overflow (|value| >= 65520 rounds to infinity)
+    if (x > 0x7f800000) return (rac_half_t)(sign | 0x7e00);
+    if (x >= 0x477ff000) return (rac_half_t)(sign | 0x7c00);
+
+    // subnormal or zero (|value| < 2^-14)
+    if (x < 0x38800000) {
+        if (x < 0x33000000) return (rac_half_t)sign;
+        const uint32_t shift = 126 - (x >> 23);
+        const uint32_t mantissa = (x & 0x7fffff) | 0x800000;
+        const uint32_t rem = mantissa & ((1u << shift) - 1), halfway = 1u << (shift - 1);
+        uint32_t h = mantissa >> shift;
+        if (rem > halfway || (rem == halfway && (h & 1))) h++;
+        return (rac_half_t)(sign | h);
+    }
+
+    // normal: rebias exponent, round mantissa (a carry propagates into the exponent)
+    uint32_t h = (x >> 13) - (112 << 10);
+    const uint32_t rem = x & 0x1fff;
+    if (rem > 0x1000 || (rem == 0x1000 && (h & 1))) h++;
+    return (rac_half_t)(sign | h);
+}
+
+/**
+ * @brief Converts an IEEE 754 half precision value to float (exact)
+ * @param value fp16 bits
+ * @returns float value
+ */
+static inline float rac_fp16_to_float(const rac_half_t value) {
+    const uint32_t sign = (uint32_t)(value & 0x8000) << 16;
+    uint32_t exponent = (value >> 10) & 0x1f;
+    uint32_t mantissa = value & 0x3ff;
+    uint32_t bits = 0;
+    if (exponent == 0x1f) {
+        bits = sign | 0x7f800000 | (mantissa << 13);
+    } else if (exponent) {
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    } else if (mantissa) {
+        // subnormal: normalize
+        exponent = 113;
+        while (!(mantissa & 0x400)) {
+            mantissa <<= 1;
+            exponent--;
+        }
+        bits = sign | (exponent << 23) | ((mantissa & 0x3ff) << 13);
+    } else {
+        bits = sign;
+    }
+
+    float result = 0;
+    memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+/**
+ * @brief Converts a value to the given 16-bit format
+ * @param type storage format
+ * @param value value
+ * @returns 16-bit bits
+ */
+static inline rac_half_t rac_half_from_float(const enum RaccoonHalfType type, const rac_float value) {
+    return (type == RAC_HALF_BF16) ? rac_bf16_from_float((float)value) : rac_fp16_from_float((float)value);
+}
+
+/**
+ * @brief Converts a 16-bit value to `rac_float`
+ * @param type storage format
+ * @param value 16-bit bits
+ * @returns value
+ */
+static inline rac_float rac_half_to_float(const enum RaccoonHalfType type, const rac_half_t value) {
+    return (type == RAC_HALF_BF16) ? rac_bf16_to_float(value) : rac_fp16_to_float(value);
+}
+
+/*
+    Array conversions
+*/
+
+/**
+ * @brief Converts an array to the given 16-bit format
+ * @param type storage format
+ * @param len number of elements
+ * @param src source values
+ * @param dst destination (16-bit values)
+ * @returns None
+ */
+extern void rac_half_pack(const enum RaccoonHalfType type, const size_t len, const rac_float *const src, rac_half_t *const dst);
+
+/**
+ * @brief Converts an array of 16-bit values to `rac_float`
+ * @param type storage format
+ * @param len number of elements
+ * @param src source (16-bit values)
+ * @param dst destination values
+ * @returns None
+ */
+extern void rac_half_unpack(const enum RaccoonHalfType type, const size_t len, const rac_half_t *const src, rac_float *const dst);
+
+#endif // RACCOON_CORE_HALF_H
+
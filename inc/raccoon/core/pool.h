@@ -0,0 +1,107 @@
+#ifndef RACCOON_CORE_POOL_H
+#define RACCOON_CORE_POOL_H
+
+/** POOL MODULE (slab allocator for graph nodes)
+ * Functions:
+    - rac_pool_make
+    - rac_pool_free
+    - rac_pool_bind
+    - rac_pool_bound
+    - rac_pool_alloc
+    - rac_pool_release
+*/
+
+#include <stdatomic.h>
+#include "raccoon/core/core.h"
+
+// slab size and alignment: the slab of a node is found by masking its address
+#define RAC_POOL_SLAB_SIZE (64 * 1024)
+
+// slabs carved from one allocation: aligning costs one extra slab per allocation, not one per slab
+#define RAC_POOL_SLABS_PER_ALLOC 8
+
+// slot size classes: `rac_var_t` and `rac_var_fused_t`
+#define RAC_POOL_CLASSES_LEN 2
+
+/*
+    Node pool:
+        slabs:      `RAC_POOL_SLAB_SIZE`-aligned blocks of fixed-size slots of one size class, never returned before `rac_pool_free`;
+                    carved `RAC_POOL_SLABS_PER_ALLOC` at a time, unused ones wait on the spare list for any class
+        owner:      the thread the pool is bound to allocates and frees through a plain free list
+        remote:     other threads push released slots onto a lock-free stack that the owner takes over when its list runs out
+*/
+typedef struct RaccoonPool {
+    // free slots of each size class (owner thread only)
+    void *free_list[RAC_POOL_CLASSES_LEN];
+
+    // slots of each size class released by other threads
+    _Atomic(void*) remote_list[RAC_POOL_CLASSES_LEN];
+
+    // slabs in use and the total number of slots in them
+    struct RaccoonPoolSlab *slabs;
+    size_t slabs_len;
+    size_t capacity;
+
+    // carved slabs not assigned to a size class yet, and the first slab of every allocation
+    struct RaccoonPoolSlab *spare;
+    struct RaccoonPoolSlab *allocs;
+
+    // allocator for slabs: if `NULL`, then calloc/realloc/free is used
+    struct VitaBaseAllocatorType *alloctr;
+} rac_pool_t;
+
+/*
+    Pool creation/destruction
+*/
+
+/**
+ * @brief Creates a node pool
+ * @param alloctr allocator instance used for slabs
+ * @returns valid `rac_pool_t*` or asserts on failure
+ */
+extern rac_pool_t *rac_pool_make(struct VitaBaseAllocatorType *const alloctr);
+
+/**
+ * @brief Frees a pool and all of its slabs (unbinds it from the calling thread)
+ * @param pool instance
+ * @returns None
+ * @note Nodes allocated from the pool must be freed before.
+ */
+extern void rac_pool_free(rac_pool_t *pool);
+
+/*
+    Pool operations
+*/
+
+/**
+ * @brief Binds a pool to the calling thread: `rac_var_make*` on this thread take nodes from it
+ * @param pool instance or `NULL` to go back to the variable's allocator
+ * @returns previously bound pool or `NULL`
+ * @note A pool must be bound to at most one thread at a time. Its nodes can be freed from any thread.
+ */
+extern rac_pool_t *rac_pool_bind(rac_pool_t *const pool);
+
+/**
+ * @brief Returns the pool bound to the calling thread
+ * @returns `rac_pool_t*` or `NULL`
+ */
+extern rac_pool_t *rac_pool_bound(void);
+
+/**
+ * @brief Takes one node slot from a pool
+ * @param pool instance (owned by the calling thread)
+ * @param size node size, at most `sizeof(rac_var_fused_t)`
+ * @returns uninitialized memory for one node from the smallest size class that fits
+ */
+extern void *rac_pool_alloc(rac_pool_t *const pool, const size_t size);
+
+/**
+ * @brief Returns a node slot to the pool it came from
+ * @param ptr slot from `rac_pool_alloc`
+ * @returns None
+ * @note Slots of the calling thread's bound pool go to its free list; others are pushed onto their pool's remote list.
+ */
+extern void rac_pool_release(void *const ptr);
+
+#endif // RACCOON_CORE_POOL_H
+
@@ -0,0 +1,113 @@
+#ifndef RACCOON_CORE_RANDOM_H
+#define RACCOON_CORE_RANDOM_H
+
+/** RANDOM MODULE (counter-based Philox4x32-10 generator)
+ * Functions:
+    - rac_random_make
+    - rac_random_philox
+    - rac_random_uniform
+    - rac_random_normal
+    - rac_random_xavier
+    - rac_random_he
+*/
+
+#include "raccoon/core/core.h"
+
+// blocks per fill below which splitting the work between threads does not pay off
+#define RAC_RANDOM_PARALLEL_MIN 4096
+
+// weight initialization schemes
+enum RaccoonRandomInit {
+    RAC_RANDOM_INIT_XAVIER, // uniform in `+-sqrt(6 / (fan_in + fan_out))`, for tanh/sigmoid/linear layers
+    RAC_RANDOM_INIT_HE,     // normal with deviation `sqrt(2 / fan_in)`, for relu layers
+};
+
+/*
+    Random stream: block `n` of the stream is `philox(counter = { n, stream }, key = seed)`
+        counter-based:  blocks do not depend on each other, so fills are split between threads (OpenMP) and
+                        give the same values for any number of threads
+        streams:        the same seed with different stream ids gives independent sequences (one per thread, layer, ...)
+*/
+typedef struct RaccoonRandom {
+    uint32_t key[2];    // seed
+    uint64_t stream;    // high counter words
+    uint64_t counter;   // next block
+} rac_random_t;
+
+/**
+ * @brief Creates a random stream
+ * @param seed key shared by related streams
+ * @param stream stream id
+ * @returns stream positioned at its first block
+ */
+extern rac_random_t rac_random_make(const uint64_t seed, const uint64_t stream);
+
+/**
+ * @brief Philox4x32 with 10 rounds: maps a 128-bit counter to 128 random bits
+ * @param counter 4 words
+ * @param key 2 words
+ * @param out 4 words
+ * @returns None
+ */
+static inline void rac_random_philox(const uint32_t counter[4], const uint32_t key[2], uint32_t out[4]) {
+    uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+    uint32_t k0 = key[0], k1 = key[1];
+    for (int r = 0; r < 10; r++) {
+        const uint64_t p0 = (uint64_t)0xD2511F53u * c0;
+        const uint64_t p1 = (uint64_t)0xCD9E8D57u * c2;
+        c0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+        c2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+        c1 = (uint32_t)p1;
+        c3 = (uint32_t)p0;
+        k0 += 0x9E3779B9u;
+        k1 += 0xBB67AE85u;
+    }
+    out[0] = c0; out[1] = c1; out[2] = c2; out[3] = c3;
+}
+
+/**
+ * @brief Fills an array with uniform values in `[low; high)` and advances the stream
+ * @param rng stream
+ * @param out array
+ * @param len number of values
+ * @param low lower bound
+ * @param high upper bound
+ * @returns None
+ * @note Values have the full `rac_float` resolution: 24 random bits in float builds, 53 in double builds.
+ */
+extern void rac_random_uniform(rac_random_t *const rng, rac_float *const out, const size_t len, const rac_float low, const rac_float high);
+
+/**
+ * @brief Fills an array with normal values (Box-Muller) and advances the stream
+ * @param rng stream
+ * @param out array
+ * @param len number of values
+ * @param mean mean
+ * @param std standard deviation
+ * @returns None
+ */
+extern void rac_random_normal(rac_random_t *const rng, rac_float *const out, const size_t len, const rac_float mean, const rac_float std);
+
+/**
+ * @brief Xavier (Glorot) uniform initialization
+ * @param rng stream
+ * @param out weights
+ * @param len number of weights
+ * @param fan_in inputs per unit
+ * @param fan_out outputs per unit
+ * @returns None
+ */
+extern void rac_random_xavier(rac_random_t *const rng, rac_float *const out, const size_t len, const size_t fan_in, const size_t fan_out);
+
+/**
+ * @brief He (Kaiming) normal initialization
+ * @param rng stream
+ * @param out weights
+ * @param len number of weights
+ * @param fan_in inputs per unit
+ * @returns None
+ */
+extern void rac_random_he(rac_random_t *const rng, rac_float *const out, const size_t len, const size_t fan_in);
+
+#endif // RACCOON_CORE_RANDOM_H
+
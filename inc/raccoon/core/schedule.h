@@ -0,0 +1,81 @@
+#ifndef RACCOON_CORE_SCHEDULE_H
+#define RACCOON_CORE_SCHEDULE_H
+
+/** SCHEDULE MODULE (level-parallel graph execution)
+ * Functions:
+    - rac_schedule_make
+    - rac_schedule_free
+    - rac_schedule_backward
+*/
+
+#include "raccoon/core/core.h"
+#include "raccoon/core/variable.h"
+#include "raccoon/core/graph.h"
+
+// levels narrower than this are not worth waking up worker threads for
+#define RAC_SCHEDULE_PARALLEL_MIN 64
+
+/*
+    Schedule of a graph:
+        level:      distance from the outputs (longest path), so every consumer of a node is in an earlier level
+        backward:   each node pulls its gradient from its consumers; nodes of a level write only their own `grad`
+                    and run concurrently when the library is built with OpenMP (RACCOON_USE_OPENMP)
+*/
+typedef struct RaccoonSchedule {
+    // graph nodes in topological order
+    vt_plist_t *nodes;
+
+    // node positions grouped by level: level `l` is `levels[level_offsets[l] .. level_offsets[l+1]]`
+    size_t *levels;
+    size_t *level_offsets;
+    size_t levels_len;
+    size_t width; // widest level
+
+    // consumers of each node: `consumers[consumer_offsets[i] .. consumer_offsets[i+1]]` with the parent slot they use
+    size_t *consumer_offsets;
+    size_t *consumers;
+    size_t *slots;
+
+    // local derivatives of each node with respect to its operands (`RAC_VAR_OPERANDS_LEN` per node)
+    rac_float *partials;
+
+    // allocator: if `NULL`, then calloc/realloc/free is used
+    struct VitaBaseAllocatorType *alloctr;
+} rac_schedule_t;
+
+/*
+    Schedule creation/destruction
+*/
+
+/**
+ * @brief Creates a schedule over everything the outputs depend on
+ * @param alloctr allocator instance
+ * @param outputs graph outputs; nodes must outlive the schedule
+ * @returns valid `rac_schedule_t*` or asserts on failure
+ * @note The graph structure is captured at creation; values may change (for example, with `rac_var_update`) between runs.
+ * @note Asserts if a node has no derivative rule (see `rac_var_has_rule`); register custom operations, e.g. activations, with `rac_var_register_op`.
+ * @note Dot products (`rac_mlp_forward_array`) are rejected: their weights are not operands.
+ */
+extern rac_schedule_t *rac_schedule_make(struct VitaBaseAllocatorType *const alloctr, const vt_plist_t *const outputs);
+
+/**
+ * @brief Frees a schedule instance
+ * @param schedule instance
+ * @returns None
+ */
+extern void rac_schedule_free(rac_schedule_t *schedule);
+
+/*
+    Schedule operations
+*/
+
+/**
+ * @brief Backward pass level by level, from outputs whose gradients are already set
+ * @param schedule instance
+ * @returns None
+ * @note Uses the local derivatives from `rac_var_partials`, so gradients match `rac_graph_backward`; each node sums its consumers' contributions in a fixed order, so results do not depend on the number of threads.
+ */
+extern void rac_schedule_backward(rac_schedule_t *const schedule);
+
+#endif // RACCOON_CORE_SCHEDULE_H
+
@@ -0,0 +1,59 @@
+#ifndef RACCOON_CORE_SPARSE_H
+#define RACCOON_CORE_SPARSE_H
+
+/** SPARSE MODULE (index/value input vectors)
+ * Functions:
+    - rac_sparse_make
+    - rac_sparse_make_dense
+    - rac_sparse_free
+*/
+
+#include "raccoon/core/core.h"
+
+// Sparse vector: only nonzero entries are stored
+typedef struct RaccoonSparse {
+    // dense length (e.g. vocabulary size)
+    size_t len;
+
+    // nonzero entries: `indices[i] < len`
+    size_t nnz;
+    size_t *indices;
+    rac_float *values;
+
+    // allocator: if `NULL`, then calloc/realloc/free is used
+    struct VitaBaseAllocatorType *alloctr;
+} rac_sparse_t;
+
+/*
+    Sparse creation/destruction
+*/
+
+/**
+ * @brief Creates a sparse vector from index/value pairs (copied)
+ * @param alloctr allocator instance
+ * @param len dense length
+ * @param nnz number of entries
+ * @param indices entry positions, each less than `len`
+ * @param values entry values
+ * @returns valid `rac_sparse_t*` or asserts on failure
+ */
+extern rac_sparse_t *rac_sparse_make(struct VitaBaseAllocatorType *const alloctr, const size_t len, const size_t nnz, const size_t *const indices, const rac_float *const values);
+
+/**
+ * @brief Creates a sparse vector from the nonzero entries of a dense array
+ * @param alloctr allocator instance
+ * @param len dense length
+ * @param dense values
+ * @returns valid `rac_sparse_t*` or asserts on failure
+ */
+extern rac_sparse_t *rac_sparse_make_dense(struct VitaBaseAllocatorType *const alloctr, const size_t len, const rac_float *const dense);
+
+/**
+ * @brief Frees a sparse vector instance
+ * @param sparse instance
+ * @returns None
+ */
+extern void rac_sparse_free(rac_sparse_t *sparse);
+
+#endif // RACCOON_CORE_SPARSE_H
+
@@ -0,0 +1,305 @@
+#ifndef RACCOON_CORE_SYMBOLS_H
+#define RACCOON_CORE_SYMBOLS_H
+
+/** SYMBOLS MODULE
+ * Macros:
+    - RAC_SYMBOL
+*/
+
+/*
+    Builds with `RACCOON_USE_SYMBOL_SUFFIX` append `RACCOON_SYMBOL_SUFFIX` (`_f64` by default) to every exported
+    function, so that libraries built with different `rac_float` types can be linked into one binary. Code that
+    includes raccoon headers with the same definitions calls the suffixed functions by their usual names.
+
+    Every `extern` function of the public headers must be listed here.
+*/
+
+#if defined(RACCOON_USE_SYMBOL_SUFFIX)
+    #if !defined(RACCOON_SYMBOL_SUFFIX)
+        #define RACCOON_SYMBOL_SUFFIX _f64
+    #endif
+
+    // appends the suffix (the name itself is not expanded again)
+    #define RAC_SYMBOL(name) RAC_i_SYMBOL_CONCAT(name, RACCOON_SYMBOL_SUFFIX)
+    #define RAC_i_SYMBOL_CONCAT(name, suffix) RAC_i_SYMBOL_CONCAT_IMPL(name, suffix)
+    #define RAC_i_SYMBOL_CONCAT_IMPL(name, suffix) name ## suffix
+
+    // core/core.h
+    #define rac_status_to_str RAC_SYMBOL(rac_status_to_str)
+
+    // core/version.h
+    #define rac_version_get RAC_SYMBOL(rac_version_get)
+
+    // core/half.h
+    #define rac_half_pack RAC_SYMBOL(rac_half_pack)
+    #define rac_half_unpack RAC_SYMBOL(rac_half_unpack)
+
+    // core/variable.h
+    #define rac_var_make RAC_SYMBOL(rac_var_make)
+    #define rac_var_make_ex RAC_SYMBOL(rac_var_make_ex)
+    #define rac_var_make_rand RAC_SYMBOL(rac_var_make_rand)
+    #define rac_var_make_rand_ex RAC_SYMBOL(rac_var_make_rand_ex)
+    #define rac_var_make_const RAC_SYMBOL(rac_var_make_const)
+    #define rac_var_make_placeholder RAC_SYMBOL(rac_var_make_placeholder)
+    #define rac_var_remake RAC_SYMBOL(rac_var_remake)
+    #define rac_var_free RAC_SYMBOL(rac_var_free)
+    #define rac_var_backward RAC_SYMBOL(rac_var_backward)
+    #define rac_var_zero_grad RAC_SYMBOL(rac_var_zero_grad)
+    #define rac_var_add RAC_SYMBOL(rac_var_add)
+    #define rac_var_sub RAC_SYMBOL(rac_var_sub)
+    #define rac_var_mul RAC_SYMBOL(rac_var_mul)
+    #define rac_var_div RAC_SYMBOL(rac_var_div)
+    #define rac_var_add_inplace RAC_SYMBOL(rac_var_add_inplace)
+    #define rac_var_sub_inplace RAC_SYMBOL(rac_var_sub_inplace)
+    #define rac_var_mul_inplace RAC_SYMBOL(rac_var_mul_inplace)
+    #define rac_var_div_inplace RAC_SYMBOL(rac_var_div_inplace)
+    #define rac_var_fma RAC_SYMBOL(rac_var_fma)
+    #define rac_var_sqdiff RAC_SYMBOL(rac_var_sqdiff)
+    #define rac_var_sqdiff_acc RAC_SYMBOL(rac_var_sqdiff_acc)
+    #define rac_var_fma_inplace RAC_SYMBOL(rac_var_fma_inplace)
+    #define rac_var_sqdiff_inplace RAC_SYMBOL(rac_var_sqdiff_inplace)
+    #define rac_var_sqdiff_acc_inplace RAC_SYMBOL(rac_var_sqdiff_acc_inplace)
+    #define rac_var_dot RAC_SYMBOL(rac_var_dot)
+    #define rac_var_update RAC_SYMBOL(rac_var_update)
+    #define rac_var_partials RAC_SYMBOL(rac_var_partials)
+    #define rac_var_operand RAC_SYMBOL(rac_var_operand)
+    #define rac_var_inputs_len RAC_SYMBOL(rac_var_inputs_len)
+    #define rac_var_input RAC_SYMBOL(rac_var_input)
+    #define rac_var_bytes RAC_SYMBOL(rac_var_bytes)
+    #define rac_var_register_op RAC_SYMBOL(rac_var_register_op)
+    #define rac_var_has_rule RAC_SYMBOL(rac_var_has_rule)
+    #define rac_var_build_parent_tree RAC_SYMBOL(rac_var_build_parent_tree)
+
+    // core/graph.h
+    #define rac_graph_map_make RAC_SYMBOL(rac_graph_map_make)
+    #define rac_graph_map_free RAC_SYMBOL(rac_graph_map_free)
+    #define rac_graph_map_set RAC_SYMBOL(rac_graph_map_set)
+    #define rac_graph_map_get RAC_SYMBOL(rac_graph_map_get)
+    #define rac_graph_map_len RAC_SYMBOL(rac_graph_map_len)
+    #define rac_graph_map_clear RAC_SYMBOL(rac_graph_map_clear)
+    #define rac_graph_topo_sort RAC_SYMBOL(rac_graph_topo_sort)
+    #define rac_graph_topo_sort_list RAC_SYMBOL(rac_graph_topo_sort_list)
+    #define rac_graph_backward RAC_SYMBOL(rac_graph_backward)
+    #define rac_graph_fuse_list RAC_SYMBOL(rac_graph_fuse_list)
+
+    // core/pool.h
+    #define rac_pool_make RAC_SYMBOL(rac_pool_make)
+    #define rac_pool_free RAC_SYMBOL(rac_pool_free)
+    #define rac_pool_bind RAC_SYMBOL(rac_pool_bind)
+    #define rac_pool_bound RAC_SYMBOL(rac_pool_bound)
+    #define rac_pool_alloc RAC_SYMBOL(rac_pool_alloc)
+    #define rac_pool_release RAC_SYMBOL(rac_pool_release)
+
+    // core/counter.h
+    #define rac_counter_get_stats RAC_SYMBOL(rac_counter_get_stats)
+    #define rac_counter_step_begin RAC_SYMBOL(rac_counter_step_begin)
+    #define rac_counter_count_node RAC_SYMBOL(rac_counter_count_node)
+
+    // core/schedule.h
+    #define rac_schedule_make RAC_SYMBOL(rac_schedule_make)
+    #define rac_schedule_free RAC_SYMBOL(rac_schedule_free)
+    #define rac_schedule_backward RAC_SYMBOL(rac_schedule_backward)
+
+    // core/sparse.h
+    #define rac_sparse_make RAC_SYMBOL(rac_sparse_make)
+    #define rac_sparse_make_dense RAC_SYMBOL(rac_sparse_make_dense)
+    #define rac_sparse_free RAC_SYMBOL(rac_sparse_free)
+
+    // core/gemm.h
+    #define rac_gemm RAC_SYMBOL(rac_gemm)
+
+    // core/random.h
+    #define rac_random_make RAC_SYMBOL(rac_random_make)
+    #define rac_random_uniform RAC_SYMBOL(rac_random_uniform)
+    #define rac_random_normal RAC_SYMBOL(rac_random_normal)
+    #define rac_random_xavier RAC_SYMBOL(rac_random_xavier)
+    #define rac_random_he RAC_SYMBOL(rac_random_he)
+
+    // nn/neuron.h
+    #define rac_neuron_make RAC_SYMBOL(rac_neuron_make)
+    #define rac_neuron_make_ex RAC_SYMBOL(rac_neuron_make_ex)
+    #define rac_neuron_free RAC_SYMBOL(rac_neuron_free)
+    #define rac_neuron_forward RAC_SYMBOL(rac_neuron_forward)
+    #define rac_neuron_forward_sparse RAC_SYMBOL(rac_neuron_forward_sparse)
+    #define rac_neuron_forward_array RAC_SYMBOL(rac_neuron_forward_array)
+    #define rac_neuron_zero_grad RAC_SYMBOL(rac_neuron_zero_grad)
+    #define rac_neuron_zero_grad_sparse RAC_SYMBOL(rac_neuron_zero_grad_sparse)
+    #define rac_neuron_clear_cache RAC_SYMBOL(rac_neuron_clear_cache)
+    #define rac_neuron_update RAC_SYMBOL(rac_neuron_update)
+    #define rac_neuron_update_sparse RAC_SYMBOL(rac_neuron_update_sparse)
+
+    // nn/layer.h
+    #define rac_layer_make RAC_SYMBOL(rac_layer_make)
+    #define rac_layer_free RAC_SYMBOL(rac_layer_free)
+    #define rac_layer_forward RAC_SYMBOL(rac_layer_forward)
+    #define rac_layer_forward_sparse RAC_SYMBOL(rac_layer_forward_sparse)
+    #define rac_layer_forward_array RAC_SYMBOL(rac_layer_forward_array)
+    #define rac_layer_zero_grad RAC_SYMBOL(rac_layer_zero_grad)
+    #define rac_layer_zero_grad_sparse RAC_SYMBOL(rac_layer_zero_grad_sparse)
+    #define rac_layer_clear_cache RAC_SYMBOL(rac_layer_clear_cache)
+    #define rac_layer_update RAC_SYMBOL(rac_layer_update)
+    #define rac_layer_update_sparse RAC_SYMBOL(rac_layer_update_sparse)
+    #define rac_layer_init RAC_SYMBOL(rac_layer_init)
+
+    // nn/mlp.h
+    #define rac_mlp_make RAC_SYMBOL(rac_mlp_make)
+    #define rac_mlp_make_ex RAC_SYMBOL(rac_mlp_make_ex)
+    #define rac_mlp_free RAC_SYMBOL(rac_mlp_free)
+    #define rac_mlp_forward RAC_SYMBOL(rac_mlp_forward)
+    #define rac_mlp_forward_sparse RAC_SYMBOL(rac_mlp_forward_sparse)
+    #define rac_mlp_forward_array RAC_SYMBOL(rac_mlp_forward_array)
+    #define rac_mlp_zero_grad RAC_SYMBOL(rac_mlp_zero_grad)
+    #define rac_mlp_zero_grad_sparse RAC_SYMBOL(rac_mlp_zero_grad_sparse)
+    #define rac_mlp_clear_cache RAC_SYMBOL(rac_mlp_clear_cache)
+    #define rac_mlp_update RAC_SYMBOL(rac_mlp_update)
+    #define rac_mlp_update_sparse RAC_SYMBOL(rac_mlp_update_sparse)
+    #define rac_mlp_init RAC_SYMBOL(rac_mlp_init)
+
+    // nn/checkpoint.h
+    #define rac_checkpoint_make RAC_SYMBOL(rac_checkpoint_make)
+    #define rac_checkpoint_free RAC_SYMBOL(rac_checkpoint_free)
+    #define rac_checkpoint_forward RAC_SYMBOL(rac_checkpoint_forward)
+    #define rac_checkpoint_backward RAC_SYMBOL(rac_checkpoint_backward)
+
+    // nn/packed_mlp.h
+    #define rac_packed_mlp_make RAC_SYMBOL(rac_packed_mlp_make)
+    #define rac_packed_mlp_free RAC_SYMBOL(rac_packed_mlp_free)
+    #define rac_packed_mlp_pack RAC_SYMBOL(rac_packed_mlp_pack)
+    #define rac_packed_mlp_unpack RAC_SYMBOL(rac_packed_mlp_unpack)
+    #define rac_packed_mlp_pack_grad RAC_SYMBOL(rac_packed_mlp_pack_grad)
+    #define rac_packed_mlp_unpack_grad RAC_SYMBOL(rac_packed_mlp_unpack_grad)
+    #define rac_packed_mlp_forward RAC_SYMBOL(rac_packed_mlp_forward)
+
+    // nn/quant_mlp.h
+    #define rac_quant_mlp_make RAC_SYMBOL(rac_quant_mlp_make)
+    #define rac_quant_mlp_free RAC_SYMBOL(rac_quant_mlp_free)
+    #define rac_quant_mlp_calibrate RAC_SYMBOL(rac_quant_mlp_calibrate)
+    #define rac_quant_mlp_forward RAC_SYMBOL(rac_quant_mlp_forward)
+
+    // nn/conv.h
+    #define rac_conv1d_make RAC_SYMBOL(rac_conv1d_make)
+    #define rac_conv2d_make RAC_SYMBOL(rac_conv2d_make)
+    #define rac_conv_free RAC_SYMBOL(rac_conv_free)
+    #define rac_conv_forward RAC_SYMBOL(rac_conv_forward)
+    #define rac_conv_backward RAC_SYMBOL(rac_conv_backward)
+    #define rac_conv_zero_grad RAC_SYMBOL(rac_conv_zero_grad)
+    #define rac_conv_update RAC_SYMBOL(rac_conv_update)
+    #define rac_conv_init RAC_SYMBOL(rac_conv_init)
+
+    // nn/pooling.h
+    #define rac_pooling1d_make RAC_SYMBOL(rac_pooling1d_make)
+    #define rac_pooling2d_make RAC_SYMBOL(rac_pooling2d_make)
+    #define rac_pooling_free RAC_SYMBOL(rac_pooling_free)
+    #define rac_pooling_forward RAC_SYMBOL(rac_pooling_forward)
+    #define rac_pooling_backward RAC_SYMBOL(rac_pooling_backward)
+
+    // nn/recurrent.h
+    #define rac_recurrent_make RAC_SYMBOL(rac_recurrent_make)
+    #define rac_recurrent_free RAC_SYMBOL(rac_recurrent_free)
+    #define rac_recurrent_reset RAC_SYMBOL(rac_recurrent_reset)
+    #define rac_recurrent_forward RAC_SYMBOL(rac_recurrent_forward)
+    #define rac_recurrent_backward RAC_SYMBOL(rac_recurrent_backward)
+    #define rac_recurrent_zero_grad RAC_SYMBOL(rac_recurrent_zero_grad)
+    #define rac_recurrent_update RAC_SYMBOL(rac_recurrent_update)
+    #define rac_recurrent_init RAC_SYMBOL(rac_recurrent_init)
+
+    // nn/embedding.h
+    #define rac_embedding_make RAC_SYMBOL(rac_embedding_make)
+    #define rac_embedding_free RAC_SYMBOL(rac_embedding_free)
+    #define rac_embedding_lookup RAC_SYMBOL(rac_embedding_lookup)
+    #define rac_embedding_grad RAC_SYMBOL(rac_embedding_grad)
+    #define rac_embedding_forward RAC_SYMBOL(rac_embedding_forward)
+    #define rac_embedding_backward RAC_SYMBOL(rac_embedding_backward)
+    #define rac_embedding_zero_grad RAC_SYMBOL(rac_embedding_zero_grad)
+    #define rac_embedding_update RAC_SYMBOL(rac_embedding_update)
+    #define rac_embedding_update_adagrad RAC_SYMBOL(rac_embedding_update_adagrad)
+    #define rac_embedding_init RAC_SYMBOL(rac_embedding_init)
+
+    // nn/norm.h
+    #define rac_norm_make RAC_SYMBOL(rac_norm_make)
+    #define rac_norm_free RAC_SYMBOL(rac_norm_free)
+    #define rac_norm_forward RAC_SYMBOL(rac_norm_forward)
+    #define rac_norm_backward RAC_SYMBOL(rac_norm_backward)
+    #define rac_norm_zero_grad RAC_SYMBOL(rac_norm_zero_grad)
+    #define rac_norm_update RAC_SYMBOL(rac_norm_update)
+    #define rac_norm_fold RAC_SYMBOL(rac_norm_fold)
+
+    // nn/dropout.h
+    #define rac_dropout_make RAC_SYMBOL(rac_dropout_make)
+    #define rac_dropout_free RAC_SYMBOL(rac_dropout_free)
+    #define rac_dropout_forward RAC_SYMBOL(rac_dropout_forward)
+    #define rac_dropout_backward RAC_SYMBOL(rac_dropout_backward)
+
+    // auxiliary/tape.h
+    #define rac_tape_make RAC_SYMBOL(rac_tape_make)
+    #define rac_tape_free RAC_SYMBOL(rac_tape_free)
+    #define rac_tape_reset RAC_SYMBOL(rac_tape_reset)
+    #define rac_tape_update RAC_SYMBOL(rac_tape_update)
+    #define rac_tape_mark_changed RAC_SYMBOL(rac_tape_mark_changed)
+    #define rac_tape_update_changed RAC_SYMBOL(rac_tape_update_changed)
+    #define rac_tape_push RAC_SYMBOL(rac_tape_push)
+    #define rac_tape_push_ex RAC_SYMBOL(rac_tape_push_ex)
+    #define rac_tape_first RAC_SYMBOL(rac_tape_first)
+    #define rac_tape_get RAC_SYMBOL(rac_tape_get)
+    #define rac_tape_last RAC_SYMBOL(rac_tape_last)
+    #define rac_tape_compile RAC_SYMBOL(rac_tape_compile)
+    #define rac_tape_compile_ex RAC_SYMBOL(rac_tape_compile_ex)
+    #define rac_tape_compiled RAC_SYMBOL(rac_tape_compiled)
+
+    // auxiliary/instrument.h
+    #define rac_instrument_reset RAC_SYMBOL(rac_instrument_reset)
+    #define rac_instrument_free RAC_SYMBOL(rac_instrument_free)
+    #define rac_instrument_get_stats RAC_SYMBOL(rac_instrument_get_stats)
+    #define rac_instrument_print_stats RAC_SYMBOL(rac_instrument_print_stats)
+    #define rac_instrument_dump_trace RAC_SYMBOL(rac_instrument_dump_trace)
+    #define rac_instrument_count_node RAC_SYMBOL(rac_instrument_count_node)
+    #define rac_instrument_count_alloc RAC_SYMBOL(rac_instrument_count_alloc)
+    #define rac_instrument_count_free RAC_SYMBOL(rac_instrument_count_free)
+    #define rac_instrument_count_backward RAC_SYMBOL(rac_instrument_count_backward)
+    #define rac_instrument_span_begin RAC_SYMBOL(rac_instrument_span_begin)
+    #define rac_instrument_span_end RAC_SYMBOL(rac_instrument_span_end)
+
+    // auxiliary/memory.h
+    #define rac_memory_report RAC_SYMBOL(rac_memory_report)
+    #define rac_memory_print_report RAC_SYMBOL(rac_memory_print_report)
+    #define rac_memory_step_begin RAC_SYMBOL(rac_memory_step_begin)
+    #define rac_memory_neuron_cache_bytes RAC_SYMBOL(rac_memory_neuron_cache_bytes)
+    #define rac_memory_neuron_bytes RAC_SYMBOL(rac_memory_neuron_bytes)
+    #define rac_memory_layer_bytes RAC_SYMBOL(rac_memory_layer_bytes)
+    #define rac_memory_mlp_bytes RAC_SYMBOL(rac_memory_mlp_bytes)
+    #define rac_memory_tape_bytes RAC_SYMBOL(rac_memory_tape_bytes)
+
+    // auxiliary/jit.h
+    #define rac_jit_make RAC_SYMBOL(rac_jit_make)
+    #define rac_jit_free RAC_SYMBOL(rac_jit_free)
+    #define rac_jit_update RAC_SYMBOL(rac_jit_update)
+    #define rac_jit_backward RAC_SYMBOL(rac_jit_backward)
+    #define rac_jit_hash RAC_SYMBOL(rac_jit_hash)
+
+    // auxiliary/jvp.h
+    #define rac_jvp_make RAC_SYMBOL(rac_jvp_make)
+    #define rac_jvp_make_tape RAC_SYMBOL(rac_jvp_make_tape)
+    #define rac_jvp_free RAC_SYMBOL(rac_jvp_free)
+    #define rac_jvp_zero RAC_SYMBOL(rac_jvp_zero)
+    #define rac_jvp_seed RAC_SYMBOL(rac_jvp_seed)
+    #define rac_jvp_forward RAC_SYMBOL(rac_jvp_forward)
+    #define rac_jvp_tangent RAC_SYMBOL(rac_jvp_tangent)
+
+    // auxiliary/grad.h
+    #define rac_grad_make RAC_SYMBOL(rac_grad_make)
+    #define rac_grad_free RAC_SYMBOL(rac_grad_free)
+    #define rac_grad_get RAC_SYMBOL(rac_grad_get)
+    #define rac_grad_update RAC_SYMBOL(rac_grad_update)
+    #define rac_grad_hvp RAC_SYMBOL(rac_grad_hvp)
+
+    // auxiliary/static_graph.h
+    #define rac_static_graph_make RAC_SYMBOL(rac_static_graph_make)
+    #define rac_static_graph_free RAC_SYMBOL(rac_static_graph_free)
+    #define rac_static_graph_forward RAC_SYMBOL(rac_static_graph_forward)
+    #define rac_static_graph_backward RAC_SYMBOL(rac_static_graph_backward)
+    #define rac_static_graph_step RAC_SYMBOL(rac_static_graph_step)
+#else
+    #define RAC_SYMBOL(name) name
+#endif
+
+#endif // RACCOON_CORE_SYMBOLS_H
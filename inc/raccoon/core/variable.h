@@ -6,6 +6,9 @@
     - rac_var_make
     - rac_var_make_ex
     - rac_var_make_rand
+    - rac_var_make_rand_ex
+    - rac_var_make_const
+    - rac_var_make_placeholder
     - rac_var_remake
     - rac_var_free
     - rac_var_backward
@@ -18,16 +21,40 @@
     - rac_var_sub_inplace
     - rac_var_mul_inplace
     - rac_var_div_inplace
+    - rac_var_fma
+    - rac_var_sqdiff
+    - rac_var_sqdiff_acc
+    - rac_var_fma_inplace
+    - rac_var_sqdiff_inplace
+    - rac_var_sqdiff_acc_inplace
+    - rac_var_dot
     - rac_var_update
+    - rac_var_partials
+    - rac_var_operand
+    - rac_var_inputs_len
+    - rac_var_input
+    - rac_var_bytes
+    - rac_var_register_op
+    - rac_var_has_rule
     - rac_var_build_parent_tree
 */
 
 #include "raccoon/core/core.h"
+#include "raccoon/core/random.h"
 #include "vita/container/plist.h"
 
-// parent node length (there can only be two parents at a time)
+// parent node length
 #define RAC_VAR_PARENTS_LEN 2
 
+// operand length: parents and the accumulator of fused nodes (see `rac_var_operand`)
+#define RAC_VAR_OPERANDS_LEN 3
+
+// variable flags
+#define RAC_VAR_FLAG_CONST 0x01 // node value never changes (can be folded by tape passes)
+#define RAC_VAR_FLAG_POOLED 0x02 // node memory comes from a `rac_pool_t` slab
+#define RAC_VAR_FLAG_PLACEHOLDER 0x04 // input slot of a static graph, rewritten by the caller every step
+#define RAC_VAR_FLAG_FUSED 0x08 // node is a `rac_var_fused_t` with an accumulator operand
+
 // Variable with autograd functionality
 typedef struct RaccoonVariable {
     // numerical data
@@ -39,6 +66,9 @@ typedef struct RaccoonVariable {
     // track operation
     char op;
 
+    // RAC_VAR_FLAG_* bits
+    unsigned char flags;
+
     // parent nodes
     struct RaccoonVariable *parents[RAC_VAR_PARENTS_LEN];
 
@@ -49,6 +79,34 @@ typedef struct RaccoonVariable {
     struct VitaBaseAllocatorType *alloctr;
 } rac_var_t;
 
+// Fused node with a third operand (ops `f` and `a`); `var` comes first, so the node is used as a `rac_var_t*`
+typedef struct RaccoonVariableFused {
+    rac_var_t var;
+
+    // accumulator: `c` of `a * b + c`, `acc` of `(a - b)^2 + acc`
+    rac_var_t *acc;
+} rac_var_fused_t;
+
+// Dot product node (op `d`) of weight nodes with values read from caller memory; `var` comes first, so the node is used as a `rac_var_t*`
+typedef struct RaccoonVariableDot {
+    rac_var_t var;
+
+    // `sum(weights[i] * input[i * stride])` for `i < len`
+    const vt_plist_t *weights;
+    const rac_float *input;
+    size_t len;
+    size_t stride;
+} rac_var_dot_t;
+
+// Rule of a custom operation (any op other than `{ +, -, *, /, f, q, a, d }`), so that graph passes can recompute and differentiate it
+typedef struct RaccoonVariableOp {
+    // value from the parents' values (`values[1]` is 0 for single-parent nodes)
+    rac_float (*forward)(const rac_float values[RAC_VAR_PARENTS_LEN]);
+
+    // local derivatives with respect to each parent, given the parents' values and the node value
+    void (*derivative)(const rac_float values[RAC_VAR_PARENTS_LEN], const rac_float value, rac_float partials[RAC_VAR_PARENTS_LEN]);
+} rac_var_op_t;
+
 /* 
     Variable creation/destruction
 */
@@ -65,10 +123,11 @@ extern rac_var_t *rac_var_make(struct VitaBaseAllocatorType *const alloctr, cons
  * @brief Creates a variable, extended
  * @param alloctr allocator instance
  * @param data numerical data
- * @param op operation `{ +, -, *, / }`
+ * @param op operation `{ +, -, *, / }` or a custom operation (see `rac_var_register_op`)
  * @param parents parent nodes
  * @param backward backward function
  * @returns valid `rac_var_t*` or asserts on failure
+ * @note If a pool is bound to the calling thread (`rac_pool_bind`), the node is taken from it instead of `alloctr`.
  */
 extern rac_var_t *rac_var_make_ex(struct VitaBaseAllocatorType *const alloctr, const rac_float data, const char op, struct RaccoonVariable *parents[2], void (*backward)(struct RaccoonVariable*));
 
@@ -76,9 +135,34 @@ extern rac_var_t *rac_var_make_ex(struct VitaBaseAllocatorType *const alloctr, c
  * @brief Creates a random variable in range [0; 1)
  * @param alloctr allocator instance
  * @returns valid `rac_var_t*` or asserts on failure
+ * @note Draws from the global single precision generator of vita; use `rac_var_make_rand_ex` for reproducible values.
  */
 extern rac_var_t *rac_var_make_rand(struct VitaBaseAllocatorType *const alloctr);
 
+/**
+ * @brief Creates a random variable in range [0; 1) drawn from a random stream
+ * @param alloctr allocator instance
+ * @param rng random stream
+ * @returns valid `rac_var_t*` or asserts on failure
+ */
+extern rac_var_t *rac_var_make_rand_ex(struct VitaBaseAllocatorType *const alloctr, rac_random_t *const rng);
+
+/**
+ * @brief Creates a constant variable (its value never changes)
+ * @param alloctr allocator instance
+ * @param data numerical data
+ * @returns valid `rac_var_t*` or asserts on failure
+ */
+extern rac_var_t *rac_var_make_const(struct VitaBaseAllocatorType *const alloctr, const rac_float data);
+
+/**
+ * @brief Creates a placeholder: a leaf whose value is set before each replay of a static graph
+ * @param alloctr allocator instance
+ * @returns valid `rac_var_t*` or asserts on failure
+ * @note Unlike constants, placeholders are never folded by tape passes.
+ */
+extern rac_var_t *rac_var_make_placeholder(struct VitaBaseAllocatorType *const alloctr);
+
 /**
  * @brief Reinitializes the variable with new data
  * @param var variable instance
@@ -87,6 +171,8 @@ extern rac_var_t *rac_var_make_rand(struct VitaBaseAllocatorType *const alloctr)
  * @param parents parent nodes
  * @param backward backward function
  * @returns None
+ * @note Clears RAC_VAR_FLAG_CONST if parents are supplied.
+ * @note The accumulator of a fused node is reset to `NULL`.
  */
 extern void rac_var_remake(rac_var_t *var, const rac_float data, const char op, struct RaccoonVariable *parents[2], void (*backward)(struct RaccoonVariable*));
 
@@ -105,6 +191,8 @@ extern void rac_var_free(rac_var_t *var);
  * @brief Perform backward propagation
  * @param var variable instance
  * @returns None
+ * @note Nodes are visited in reverse topological order: a node shared by several consumers runs its backward
+ *       only after all of them have added their contributions to its gradient.
  */
 extern void rac_var_backward(rac_var_t *const var);
 
@@ -183,15 +271,143 @@ extern void rac_var_mul_inplace(rac_var_t *out, rac_var_t *const lhs, rac_var_t
  */
 extern void rac_var_div_inplace(rac_var_t *out, rac_var_t *const lhs, rac_var_t *const rhs);
 
+/**
+ * @brief Fused multiply-add: `a * b + c` (op `f`)
+ * @param a variable instance
+ * @param b variable instance
+ * @param c variable instance
+ * @returns valid `rac_var_t*` or asserts on failure
+ * @note Uses a single rounding (`fma()`). The result is a `rac_var_fused_t` with `c` as the accumulator.
+ */
+extern rac_var_t *rac_var_fma(rac_var_t *const a, rac_var_t *const b, rac_var_t *const c);
+
+/**
+ * @brief Fused squared difference: `(a - b) * (a - b)` (op `q`)
+ * @param a variable instance
+ * @param b variable instance
+ * @returns valid `rac_var_t*` or asserts on failure
+ */
+extern rac_var_t *rac_var_sqdiff(rac_var_t *const a, rac_var_t *const b);
+
+/**
+ * @brief Fused squared difference accumulation: `(a - b) * (a - b) + acc` (op `a`)
+ * @param a variable instance
+ * @param b variable instance
+ * @param acc accumulator variable instance
+ * @returns valid `rac_var_t*` or asserts on failure
+ * @note The result is a `rac_var_fused_t`; gradients follow `rac_var_sqdiff`.
+ */
+extern rac_var_t *rac_var_sqdiff_acc(rac_var_t *const a, rac_var_t *const b, rac_var_t *const acc);
+
+/**
+ * @brief Fused multiply-add-inplace: `out = a * b + c`
+ * @param out fused variable instance (RAC_VAR_FLAG_FUSED)
+ * @param a variable instance
+ * @param b variable instance
+ * @param c variable instance
+ * @returns None
+ */
+extern void rac_var_fma_inplace(rac_var_t *out, rac_var_t *const a, rac_var_t *const b, rac_var_t *const c);
+
+/**
+ * @brief Fused squared difference-inplace: `out = (a - b) * (a - b)`
+ * @param out variable instance
+ * @param a variable instance
+ * @param b variable instance
+ * @returns None
+ */
+extern void rac_var_sqdiff_inplace(rac_var_t *out, rac_var_t *const a, rac_var_t *const b);
+
+/**
+ * @brief Fused squared difference accumulation-inplace: `out = (a - b) * (a - b) + acc`
+ * @param out fused variable instance (RAC_VAR_FLAG_FUSED)
+ * @param a variable instance
+ * @param b variable instance
+ * @param acc accumulator variable instance
+ * @returns None
+ */
+extern void rac_var_sqdiff_acc_inplace(rac_var_t *out, rac_var_t *const a, rac_var_t *const b, rac_var_t *const acc);
+
+/**
+ * @brief Dot product of weight nodes with raw values: `sum(weights[i] * input[i * stride])` (op `d`)
+ * @param alloctr allocator instance
+ * @param weights list of at least `len` weight nodes
+ * @param input raw values; read again by backward and `rac_var_update`, so must outlive the node
+ * @param len number of products
+ * @param stride distance between consecutive values in `input`
+ * @returns valid `rac_var_t*` or asserts on failure
+ * @note Inputs need no nodes. Topological sorts list the weights before the node, but the weights are not
+ *       `parents`: passes that use local derivatives (jit, jvp, grad, schedule) see this node as an input.
+ */
+extern rac_var_t *rac_var_dot(struct VitaBaseAllocatorType *const alloctr, const vt_plist_t *const weights, const rac_float *const input, const size_t len, const size_t stride);
+
 /**
  * @brief Update variable value from cached `op` and `parents` information
  * @param var variable instance
  * @returns None
  * @note If insufficient information, does nothing.
- * @note Works only with basic operations: `{ +, -, *, / }`
+ * @note Works with basic operations `{ +, -, *, / }`, fused operations `{ f, q, a }`, dot products `d` and registered custom operations
  */
 extern void rac_var_update(rac_var_t *const var);
 
+/**
+ * @brief Computes local derivatives of an operation result with respect to each parent
+ * @param var variable instance
+ * @param partials where to store `d(var)/d(rac_var_operand(var, i))`, unused entries are set to 0
+ * @returns number of operands (0 for leaves)
+ * @note These are the derivatives the backward functions apply.
+ * @note Asserts on operations without a rule (see `rac_var_has_rule`).
+ */
+extern size_t rac_var_partials(const rac_var_t *const var, rac_float partials[RAC_VAR_OPERANDS_LEN]);
+
+/**
+ * @brief Returns an operand of a node: its parents, then the accumulator of fused nodes
+ * @param var variable instance
+ * @param idx operand index below `RAC_VAR_OPERANDS_LEN`
+ * @returns `rac_var_t*` or `NULL` if there is no such operand
+ */
+extern rac_var_t *rac_var_operand(const rac_var_t *const var, const size_t idx);
+
+/**
+ * @brief Returns the number of inputs a node is computed from: its operands and, for dot products, their weights
+ * @param var variable instance
+ * @returns `RAC_VAR_OPERANDS_LEN` plus the number of dot product weights
+ */
+extern size_t rac_var_inputs_len(const rac_var_t *const var);
+
+/**
+ * @brief Returns an input of a node: its operands (see `rac_var_operand`), then the weights of dot products
+ * @param var variable instance
+ * @param idx input index below `rac_var_inputs_len(var)`
+ * @returns `rac_var_t*` or `NULL` if there is no such input
+ * @note Dot product weights are not parents: only passes that recompute values (`rac_var_update`) follow them.
+ */
+extern rac_var_t *rac_var_input(const rac_var_t *const var, const size_t idx);
+
+/**
+ * @brief Returns the number of bytes allocated for a node
+ * @param var variable instance
+ * @returns `sizeof` of `rac_var_t`, `rac_var_fused_t` or `rac_var_dot_t`
+ */
+extern size_t rac_var_bytes(const rac_var_t *const var);
+
+/**
+ * @brief Registers the value and derivative rule of a custom operation, e.g. an activation made with `rac_var_make_ex`
+ * @param op operation character; must not be a built-in operation
+ * @param rule forward and derivative functions
+ * @returns None
+ * @note Rules are global and replace earlier registrations of `op`: register them before building graphs, not concurrently.
+ */
+extern void rac_var_register_op(const char op, const rac_var_op_t rule);
+
+/**
+ * @brief Checks if a node can be recomputed and differentiated by graph passes (`rac_var_update`, `rac_var_partials`)
+ * @param var variable instance
+ * @returns `true` for leaves, built-in operations with all operands and registered custom operations
+ * @note `false` for dot products `d`: their weights are not operands, so derivative passes would treat them as constants.
+ */
+extern bool rac_var_has_rule(const rac_var_t *const var);
+
 /* 
     Other
 */
@@ -7,6 +7,7 @@
 */
 
 #include "vita/core/version.h"
+#include "raccoon/core/symbols.h"
 
 // defines
 #define RAC_RACCOON_VERSION_MAJOR 0
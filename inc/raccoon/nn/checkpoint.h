@@ -0,0 +1,76 @@
+#ifndef RACCOON_NN_CHECKPOINT_H
+#define RACCOON_NN_CHECKPOINT_H
+
+/** CHECKPOINT MODULE (activation checkpointing for MLP training)
+ * Functions:
+    - rac_checkpoint_make
+    - rac_checkpoint_free
+    - rac_checkpoint_forward
+    - rac_checkpoint_backward
+*/
+
+#include "raccoon/core/core.h"
+#include "raccoon/core/graph.h"
+#include "raccoon/nn/mlp.h"
+
+// Training driver that keeps only segment boundary activations and recomputes segments during backward
+typedef struct RaccoonCheckpoint {
+    // model and number of layers per segment
+    rac_mlp_t *mlp;
+    size_t segment_len;
+    size_t segments_len;
+
+    // input of the last forward pass (not owned)
+    const vt_plist_t *input;
+
+    // activations entering each segment after the first: lists of leaf copies
+    vt_plist_t *boundaries;
+
+    // allocator: if `NULL`, then calloc/realloc/free is used
+    struct VitaBaseAllocatorType *alloctr;
+} rac_checkpoint_t;
+
+/*
+    Checkpoint creation/destruction
+*/
+
+/**
+ * @brief Creates a checkpointing driver for a model
+ * @param alloctr allocator instance
+ * @param mlp model; must outlive the checkpoint instance
+ * @param segment_len layers per segment; `0` picks `ceil(sqrt(layers))`
+ * @returns valid `rac_checkpoint_t*` or asserts on failure
+ */
+extern rac_checkpoint_t *rac_checkpoint_make(struct VitaBaseAllocatorType *const alloctr, rac_mlp_t *const mlp, const size_t segment_len);
+
+/**
+ * @brief Frees a checkpoint instance and its boundary activations
+ * @param checkpoint instance
+ * @returns None
+ */
+extern void rac_checkpoint_free(rac_checkpoint_t *checkpoint);
+
+/*
+    Checkpoint operations
+*/
+
+/**
+ * @brief Forward operation that keeps only the graph of the last segment
+ * @param checkpoint instance
+ * @param input input list; must stay valid until `rac_checkpoint_backward`
+ * @returns output list (as `rac_mlp_forward`)
+ * @note Clears the model caches, so graphs of previous forward passes are released.
+ */
+extern vt_plist_t *rac_checkpoint_forward(rac_checkpoint_t *const checkpoint, const vt_plist_t *const input);
+
+/**
+ * @brief Backward operation: backpropagates the loss, then recomputes and backpropagates earlier segments one at a time
+ * @param checkpoint instance
+ * @param loss scalar computed from the output of `rac_checkpoint_forward`
+ * @returns None
+ * @note Parameter gradients accumulate as with `rac_var_backward`.
+ */
+extern void rac_checkpoint_backward(rac_checkpoint_t *const checkpoint, rac_var_t *const loss);
+
+#endif // RACCOON_NN_CHECKPOINT_H
+
@@ -0,0 +1,169 @@
+#ifndef RACCOON_NN_CONV_H
+#define RACCOON_NN_CONV_H
+
+/** CONV MODULE (1D/2D convolution layers without a graph)
+ * Functions:
+    - rac_conv1d_make
+    - rac_conv2d_make
+    - rac_conv_free
+    - rac_conv_forward
+    - rac_conv_backward
+    - rac_conv_zero_grad
+    - rac_conv_update
+    - rac_conv_init
+*/
+
+#include "raccoon/core/core.h"
+#include "raccoon/core/gemm.h"
+#include "raccoon/core/random.h"
+
+/*
+    Convolution layer over one sample stored `[channels][height][width]` row-major (1D: height 1):
+        forward:    im2col of the input (`columns`, `[in_channels * kernel_h * kernel_w][out_h * out_w]`),
+                    then `output = weights * columns + bias` with `rac_gemm`
+        backward:   `grad_weights += grad_output * columns^T`, `grad_input = col2im(weights^T * grad_output)`
+        direct:     1x1 kernels with stride 1 and no padding skip im2col and multiply the input in place
+*/
+typedef struct RaccoonConv {
+    // channels
+    size_t in_channels;
+    size_t out_channels;
+
+    // geometry: `[0]` height, `[1]` width
+    size_t in_size[2];
+    size_t out_size[2];
+    size_t kernel[2];
+    size_t stride[2];
+    size_t padding[2];
+    size_t dilation[2];
+
+    // parameters: weights `[out_channels][in_channels * kernel_h * kernel_w]`, then biases `[out_channels]`
+    rac_float *weights;
+    rac_float *bias;
+    size_t params_len;
+
+    // gradients with the same layout as the parameters
+    rac_float *grad_weights;
+    rac_float *grad_bias;
+
+    // im2col of the last input and its gradient (`NULL` for direct convolutions)
+    rac_float *columns;
+    rac_float *grad_columns;
+
+    // last input (read by backward of direct convolutions)
+    const rac_float *input;
+
+    // allocator: if `NULL`, then calloc/realloc/free is used
+    struct VitaBaseAllocatorType *alloctr;
+} rac_conv_t;
+
+/*
+    Convolution creation/destruction
+*/
+
+/**
+ * @brief Creates a 1D convolution layer: He initialized weights (see `rac_conv_init`), zero biases
+ * @param alloctr allocator instance
+ * @param in_channels input channels
+ * @param out_channels output channels (filters)
+ * @param length input length
+ * @param kernel kernel length
+ * @param stride step between windows (>= 1)
+ * @param padding zeros added to both ends
+ * @param dilation step between kernel taps (>= 1)
+ * @param rng random stream for the weights
+ * @returns valid `rac_conv_t*` or asserts on failure
+ * @note Output length is `(length + 2 * padding - dilation * (kernel - 1) - 1) / stride + 1`.
+ */
+extern rac_conv_t *rac_conv1d_make(
+    struct VitaBaseAllocatorType *const alloctr,
+    const size_t in_channels,
+    const size_t out_channels,
+    const size_t length,
+    const size_t kernel,
+    const size_t stride,
+    const size_t padding,
+    const size_t dilation,
+    rac_random_t *const rng
+);
+
+/**
+ * @brief Creates a 2D convolution layer: He initialized weights (see `rac_conv_init`), zero biases
+ * @param alloctr allocator instance
+ * @param in_channels input channels
+ * @param out_channels output channels (filters)
+ * @param in_size input `{ height, width }`
+ * @param kernel kernel `{ height, width }`
+ * @param stride `{ height, width }` steps between windows; `NULL` for `{ 1, 1 }`
+ * @param padding `{ height, width }` zeros added to both sides; `NULL` for `{ 0, 0 }`
+ * @param dilation `{ height, width }` steps between kernel taps; `NULL` for `{ 1, 1 }`
+ * @param rng random stream for the weights
+ * @returns valid `rac_conv_t*` or asserts on failure
+ */
+extern rac_conv_t *rac_conv2d_make(
+    struct VitaBaseAllocatorType *const alloctr,
+    const size_t in_channels,
+    const size_t out_channels,
+    const size_t in_size[2],
+    const size_t kernel[2],
+    const size_t stride[2],
+    const size_t padding[2],
+    const size_t dilation[2],
+    rac_random_t *const rng
+);
+
+/**
+ * @brief Frees a convolution layer
+ * @param conv instance
+ * @returns None
+ */
+extern void rac_conv_free(rac_conv_t *conv);
+
+/*
+    Convolution operations
+*/
+
+/**
+ * @brief Forward operation
+ * @param conv instance
+ * @param input `in_channels * in_size[0] * in_size[1]` values; for 1x1 direct convolutions it must stay valid until backward
+ * @param output `out_channels * out_size[0] * out_size[1]` values
+ * @returns None
+ */
+extern void rac_conv_forward(rac_conv_t *const conv, const rac_float *const input, rac_float *const output);
+
+/**
+ * @brief Backward operation for the last forward: accumulates parameter gradients
+ * @param conv instance
+ * @param grad_output gradient of the loss with respect to the output
+ * @param grad_input gradient with respect to the input (overwritten); can be `NULL` for the first layer
+ * @returns None
+ */
+extern void rac_conv_backward(rac_conv_t *const conv, const rac_float *const grad_output, rac_float *const grad_input);
+
+/**
+ * @brief Zeroes parameter gradients
+ * @param conv instance
+ * @returns None
+ */
+extern void rac_conv_zero_grad(rac_conv_t *const conv);
+
+/**
+ * @brief Gradient descent step: `params -= lr * grad`
+ * @param conv instance
+ * @param lr learning rate
+ * @returns None
+ */
+extern void rac_conv_update(rac_conv_t *const conv, const rac_float lr);
+
+/**
+ * @brief Reinitializes parameters: weights by the scheme with `fan_in = in_channels * kernel_h * kernel_w`, biases to zero
+ * @param conv instance
+ * @param init initialization scheme
+ * @param rng random stream
+ * @returns None
+ */
+extern void rac_conv_init(rac_conv_t *const conv, const enum RaccoonRandomInit init, rac_random_t *const rng);
+
+#endif // RACCOON_NN_CONV_H
+
@@ -0,0 +1,85 @@
+#ifndef RACCOON_NN_DROPOUT_H
+#define RACCOON_NN_DROPOUT_H
+
+/** DROPOUT MODULE (inverted dropout without a graph)
+ * Functions:
+    - rac_dropout_make
+    - rac_dropout_free
+    - rac_dropout_forward
+    - rac_dropout_backward
+*/
+
+#include "raccoon/core/core.h"
+#include "raccoon/core/random.h"
+
+/*
+    Inverted dropout: when training, each value is zeroed with probability `rate` and the rest are scaled by `1 / (1 - rate)`,
+    so inference is the identity. Masks come from the layer's own random stream, so runs with the same stream are reproducible.
+*/
+typedef struct RaccoonDropout {
+    // drop probability in [0; 1)
+    rac_float rate;
+
+    // largest number of values per forward
+    size_t max_len;
+
+    // `false`: forward and backward pass values through
+    bool training;
+
+    // random stream
+    rac_random_t rng;
+
+    // per-value factor of the last training forward: `0` or `1 / (1 - rate)`
+    rac_float *mask;
+    size_t len;
+
+    // allocator: if `NULL`, then calloc/realloc/free is used
+    struct VitaBaseAllocatorType *alloctr;
+} rac_dropout_t;
+
+/*
+    Dropout creation/destruction
+*/
+
+/**
+ * @brief Creates a dropout layer in training mode
+ * @param alloctr allocator instance
+ * @param rate drop probability in [0; 1)
+ * @param max_len largest number of values per forward
+ * @param rng random stream for the masks (copied)
+ * @returns valid `rac_dropout_t*` or asserts on failure
+ */
+extern rac_dropout_t *rac_dropout_make(struct VitaBaseAllocatorType *const alloctr, const rac_float rate, const size_t max_len, const rac_random_t rng);
+
+/**
+ * @brief Frees a dropout layer
+ * @param dropout instance
+ * @returns None
+ */
+extern void rac_dropout_free(rac_dropout_t *dropout);
+
+/*
+    Dropout operations
+*/
+
+/**
+ * @brief Forward operation: draws a new mask when training
+ * @param dropout instance
+ * @param input `len` values
+ * @param len number of values, at most `max_len`
+ * @param output `len` values; can be the same as `input`
+ * @returns None
+ */
+extern void rac_dropout_forward(rac_dropout_t *const dropout, const rac_float *const input, const size_t len, rac_float *const output);
+
+/**
+ * @brief Backward operation for the last forward: applies the same mask to the gradient
+ * @param dropout instance
+ * @param grad_output `len` values
+ * @param grad_input `len` values (overwritten); can be the same as `grad_output`
+ * @returns None
+ */
+extern void rac_dropout_backward(const rac_dropout_t *const dropout, const rac_float *const grad_output, rac_float *const grad_input);
+
+#endif // RACCOON_NN_DROPOUT_H
+
@@ -0,0 +1,149 @@
+#ifndef RACCOON_NN_EMBEDDING_H
+#define RACCOON_NN_EMBEDDING_H
+
+/** EMBEDDING MODULE (lookup table with sparse row-wise gradients)
+ * Functions:
+    - rac_embedding_make
+    - rac_embedding_free
+    - rac_embedding_lookup
+    - rac_embedding_grad
+    - rac_embedding_forward
+    - rac_embedding_backward
+    - rac_embedding_zero_grad
+    - rac_embedding_update
+    - rac_embedding_update_adagrad
+    - rac_embedding_init
+*/
+
+#include "raccoon/core/core.h"
+#include "raccoon/core/graph.h"
+#include "raccoon/core/random.h"
+
+// touched rows the gradient buffers start with (they double when full)
+#define RAC_EMBEDDING_ROWS_INIT 16
+
+/*
+    Embedding table `[vocab_size][dim]` row-major:
+        gradients:  kept only for rows looked up since the last `rac_embedding_zero_grad`, packed in the order they were first touched
+        updates:    zeroing, SGD and Adagrad visit the touched rows only, so a step costs `O(rows * dim)` whatever the vocabulary size
+*/
+typedef struct RaccoonEmbedding {
+    // table
+    size_t vocab_size;
+    size_t dim;
+    rac_float *table;
+
+    // touched rows and their gradients (`grads[k]` belongs to `rows[k]`)
+    size_t *rows;
+    rac_float *grads;
+    size_t rows_len;
+    size_t rows_capacity;
+
+    // table row -> position in `rows`
+    rac_graph_map_t *index;
+
+    // Adagrad sums of squared gradients with the table layout; `NULL` until the first Adagrad update
+    rac_float *accumulators;
+
+    // allocator: if `NULL`, then calloc/realloc/free is used
+    struct VitaBaseAllocatorType *alloctr;
+} rac_embedding_t;
+
+/*
+    Embedding creation/destruction
+*/
+
+/**
+ * @brief Creates an embedding table with Xavier initialized rows (see `rac_embedding_init`)
+ * @param alloctr allocator instance
+ * @param vocab_size number of rows
+ * @param dim row size
+ * @param rng random stream for the table
+ * @returns valid `rac_embedding_t*` or asserts on failure
+ */
+extern rac_embedding_t *rac_embedding_make(struct VitaBaseAllocatorType *const alloctr, const size_t vocab_size, const size_t dim, rac_random_t *const rng);
+
+/**
+ * @brief Frees an embedding table
+ * @param embedding instance
+ * @returns None
+ */
+extern void rac_embedding_free(rac_embedding_t *embedding);
+
+/*
+    Embedding operations
+*/
+
+/**
+ * @brief Returns a row of the table in place (for example, as input to `rac_mlp_forward_array`)
+ * @param embedding instance
+ * @param index row index
+ * @returns `dim` values
+ */
+extern const rac_float *rac_embedding_lookup(const rac_embedding_t *const embedding, const size_t index);
+
+/**
+ * @brief Returns the accumulated gradient of a row
+ * @param embedding instance
+ * @param index row index
+ * @returns `dim` values or `NULL` if the row was not touched since the last `rac_embedding_zero_grad`
+ */
+extern const rac_float *rac_embedding_grad(const rac_embedding_t *const embedding, const size_t index);
+
+/**
+ * @brief Copies rows into a contiguous output
+ * @param embedding instance
+ * @param indices row indices
+ * @param len number of indices
+ * @param output `[len][dim]`
+ * @returns None
+ */
+extern void rac_embedding_forward(const rac_embedding_t *const embedding, const size_t *const indices, const size_t len, rac_float *const output);
+
+/**
+ * @brief Accumulates output gradients into the rows they were looked up from
+ * @param embedding instance
+ * @param indices row indices passed to forward
+ * @param len number of indices
+ * @param grad_output `[len][dim]`
+ * @returns None
+ * @note Repeated indices add up.
+ */
+extern void rac_embedding_backward(rac_embedding_t *const embedding, const size_t *const indices, const size_t len, const rac_float *const grad_output);
+
+/**
+ * @brief Forgets the touched rows and their gradients
+ * @param embedding instance
+ * @returns None
+ */
+extern void rac_embedding_zero_grad(rac_embedding_t *const embedding);
+
+/**
+ * @brief Gradient descent step on the touched rows: `row -= lr * grad`
+ * @param embedding instance
+ * @param lr learning rate
+ * @returns None
+ */
+extern void rac_embedding_update(rac_embedding_t *const embedding, const rac_float lr);
+
+/**
+ * @brief Adagrad step on the touched rows: `acc += grad^2`, `row -= lr * grad / (sqrt(acc) + eps)`
+ * @param embedding instance
+ * @param lr learning rate
+ * @param eps added to the denominator
+ * @returns None
+ * @note Rows that are not touched keep their accumulators unchanged, as in a dense Adagrad step with a zero gradient.
+ */
+extern void rac_embedding_update_adagrad(rac_embedding_t *const embedding, const rac_float lr, const rac_float eps);
+
+/**
+ * @brief Reinitializes the table by the scheme: a lookup reads one value per output, so `fan_in` is 1 and `fan_out` is `dim`
+ * @param embedding instance
+ * @param init initialization scheme
+ * @param rng random stream
+ * @returns None
+ */
+extern void rac_embedding_init(rac_embedding_t *const embedding, const enum RaccoonRandomInit init, rac_random_t *const rng);
+
+#endif // RACCOON_NN_EMBEDDING_H
+
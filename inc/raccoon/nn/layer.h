@@ -6,11 +6,18 @@
     - rac_layer_make
     - rac_layer_free
     - rac_layer_forward
+    - rac_layer_forward_sparse
+    - rac_layer_forward_array
     - rac_layer_zero_grad
+    - rac_layer_zero_grad_sparse
+    - rac_layer_clear_cache
     - rac_layer_update
+    - rac_layer_update_sparse
+    - rac_layer_init
 */
 
 #include "raccoon/nn/neuron.h"
+#include "raccoon/core/random.h"
 
 // Layer with neurons
 typedef struct RaccoonLayer {
@@ -60,6 +67,24 @@ extern void rac_layer_free(rac_layer_t *layer);
  */
 extern vt_plist_t *rac_layer_forward(rac_layer_t *const layer, const vt_plist_t *const input);
 
+/**
+ * @brief Forward operation on a sparse input
+ * @param layer instance
+ * @param input sparse vector of the layer's input size
+ * @returns valid `vt_plist_t*` of `rac_var_t*` or asserts on failure
+ */
+extern vt_plist_t *rac_layer_forward_sparse(rac_layer_t *const layer, const rac_sparse_t *const input);
+
+/**
+ * @brief Forward operation reading the input straight from caller memory
+ * @param layer instance
+ * @param input `len` values, `stride` apart; must stay valid until backward
+ * @param len number of inputs
+ * @param stride distance between consecutive inputs
+ * @returns valid `vt_plist_t*` of `rac_var_t*` or asserts on failure
+ */
+extern vt_plist_t *rac_layer_forward_array(rac_layer_t *const layer, const rac_float *const input, const size_t len, const size_t stride);
+
 /**
  * @brief Zero all gradients
  * @param layer instance
@@ -67,6 +92,22 @@ extern vt_plist_t *rac_layer_forward(rac_layer_t *const layer, const vt_plist_t
  */
 extern void rac_layer_zero_grad(rac_layer_t *const layer);
 
+/**
+ * @brief Zero the gradients of the weights of active input columns and of the biases
+ * @param layer instance
+ * @param input sparse vector the layer was run on (see `rac_layer_forward_sparse`)
+ * @returns None
+ */
+extern void rac_layer_zero_grad_sparse(rac_layer_t *const layer, const rac_sparse_t *const input);
+
+/**
+ * @brief Frees cached by-product allocations (the forward graph)
+ * @param layer instance
+ * @returns None
+ * @note Also empties `last_prediction`, which points into the neuron caches.
+ */
+extern void rac_layer_clear_cache(rac_layer_t *const layer);
+
 /**
  * @brief Update layer parameters
  * @param layer instance
@@ -75,5 +116,24 @@ extern void rac_layer_zero_grad(rac_layer_t *const layer);
  */
 extern void rac_layer_update(rac_layer_t *const layer, const rac_float lr);
 
+/**
+ * @brief Update the weights of active input columns and the biases
+ * @param layer instance
+ * @param input sparse vector the layer was run on (see `rac_layer_forward_sparse`)
+ * @param lr learning rate
+ * @returns None
+ * @note Indices of `input` must be unique (as produced by `rac_sparse_make_dense`).
+ */
+extern void rac_layer_update_sparse(rac_layer_t *const layer, const rac_sparse_t *const input, const rac_float lr);
+
+/**
+ * @brief Reinitializes layer parameters: weights by the scheme, biases to zero
+ * @param layer instance
+ * @param init initialization scheme
+ * @param rng random stream
+ * @returns None
+ */
+extern void rac_layer_init(rac_layer_t *const layer, const enum RaccoonRandomInit init, rac_random_t *const rng);
+
 #endif // RACCOON_NN_LAYER_H
 
@@ -7,8 +7,14 @@
     - rac_mlp_make_ex
     - rac_mlp_free
     - rac_mlp_forward
+    - rac_mlp_forward_sparse
+    - rac_mlp_forward_array
     - rac_mlp_zero_grad
+    - rac_mlp_zero_grad_sparse
+    - rac_mlp_clear_cache
     - rac_mlp_update
+    - rac_mlp_update_sparse
+    - rac_mlp_init
 */
 
 #include "raccoon/nn/layer.h"
@@ -72,6 +78,25 @@ extern void rac_mlp_free(rac_mlp_t *mlp);
  */
 extern vt_plist_t *rac_mlp_forward(rac_mlp_t *const mlp, const vt_plist_t *const input);
 
+/**
+ * @brief Forward operation on a sparse input: the first layer touches only nonzero entries, the rest are dense
+ * @param mlp instance
+ * @param input sparse vector of the model's input size
+ * @returns valid `vt_plist_t*` of `rac_var_t*` or asserts on failure
+ */
+extern vt_plist_t *rac_mlp_forward_sparse(rac_mlp_t *const mlp, const rac_sparse_t *const input);
+
+/**
+ * @brief Forward operation reading the input straight from caller memory (no input nodes)
+ * @param mlp instance
+ * @param input `len` values, `stride` apart, for example row `i` of a row-major matrix `x + i * cols` with stride 1,
+ *        or column `j` of it `x + j` with stride `cols`; must stay valid until backward
+ * @param len number of inputs
+ * @param stride distance between consecutive inputs
+ * @returns valid `vt_plist_t*` of `rac_var_t*` or asserts on failure
+ */
+extern vt_plist_t *rac_mlp_forward_array(rac_mlp_t *const mlp, const rac_float *const input, const size_t len, const size_t stride);
+
 /**
  * @brief Zero all gradients
  * @param mlp instance
@@ -79,6 +104,22 @@ extern vt_plist_t *rac_mlp_forward(rac_mlp_t *const mlp, const vt_plist_t *const
  */
 extern void rac_mlp_zero_grad(rac_mlp_t *const mlp);
 
+/**
+ * @brief Zero gradients after a sparse forward: active columns of the first layer, all parameters of the others
+ * @param mlp instance
+ * @param input sparse vector the model was run on (see `rac_mlp_forward_sparse`)
+ * @returns None
+ */
+extern void rac_mlp_zero_grad_sparse(rac_mlp_t *const mlp, const rac_sparse_t *const input);
+
+/**
+ * @brief Frees cached by-product allocations (the forward graph)
+ * @param mlp instance
+ * @returns None
+ * @note Caches grow with every forward pass; call between training steps to release the previous graph.
+ */
+extern void rac_mlp_clear_cache(rac_mlp_t *const mlp);
+
 /**
  * @brief Update mlp parameters
  * @param mlp instance
@@ -87,5 +128,25 @@ extern void rac_mlp_zero_grad(rac_mlp_t *const mlp);
  */
 extern void rac_mlp_update(rac_mlp_t *const mlp, const rac_float lr);
 
+/**
+ * @brief Update parameters after a sparse forward: active columns of the first layer, all parameters of the others
+ * @param mlp instance
+ * @param input sparse vector the model was run on (see `rac_mlp_forward_sparse`)
+ * @param lr learning rate
+ * @returns None
+ * @note Same result as `rac_mlp_update`, since inactive first-layer weights have no gradient; costs O(nnz) for the first layer.
+ * @note Indices of `input` must be unique (as produced by `rac_sparse_make_dense`).
+ */
+extern void rac_mlp_update_sparse(rac_mlp_t *const mlp, const rac_sparse_t *const input, const rac_float lr);
+
+/**
+ * @brief Reinitializes all layers (see `rac_layer_init`)
+ * @param mlp instance
+ * @param init initialization scheme
+ * @param rng random stream; layers take consecutive blocks, so the result depends only on the stream
+ * @returns None
+ */
+extern void rac_mlp_init(rac_mlp_t *const mlp, const enum RaccoonRandomInit init, rac_random_t *const rng);
+
 #endif // RACCOON_NN_MLP_H
 
@@ -7,12 +7,18 @@
     - rac_neuron_make_ex
     - rac_neuron_free
     - rac_neuron_forward
+    - rac_neuron_forward_sparse
+    - rac_neuron_forward_array
     - rac_neuron_zero_grad
+    - rac_neuron_zero_grad_sparse
+    - rac_neuron_clear_cache
     - rac_neuron_update
+    - rac_neuron_update_sparse
 */
 
 #include "raccoon/core/core.h"
 #include "raccoon/core/variable.h"
+#include "raccoon/core/sparse.h"
 #include "raccoon/auxiliary/tape.h"
 
 // Neuron with weights + bias (perceptron)
@@ -73,9 +79,35 @@ extern void rac_neuron_free(rac_neuron_t *neuron);
  * @param neuron instance
  * @param input ditto
  * @returns valid `rac_var_t*` or asserts on failure
+ * @note With `RACCOON_USE_MIXED_PRECISION`, the weighted sum is accumulated in `rac_acc_float` only while the nodes are
+ *       built: the sum nodes are plain additions, so replays (`rac_tape_update`, `rac_var_update`, static graphs, the jit)
+ *       recompute them pairwise in `rac_float`. Use `rac_neuron_forward_array`, whose dot product node accumulates in
+ *       `rac_acc_float` on every evaluation, to keep the wider sum in replays.
  */
 extern rac_var_t *rac_neuron_forward(rac_neuron_t *const neuron, const vt_plist_t *const input);
 
+/**
+ * @brief Forward operation on a sparse input: only nonzero entries create nodes
+ * @param neuron instance
+ * @param input sparse vector of the neuron's input size
+ * @returns valid `rac_var_t*` or asserts on failure
+ * @note Each entry adds a constant and a fused multiply-add node, so backward reaches only the active weights.
+ * @note As with `rac_neuron_forward`, the `rac_acc_float` sum of mixed precision builds is not kept by replays.
+ */
+extern rac_var_t *rac_neuron_forward_sparse(rac_neuron_t *const neuron, const rac_sparse_t *const input);
+
+/**
+ * @brief Forward operation reading the input straight from caller memory
+ * @param neuron instance
+ * @param input `len` values, `stride` apart; must stay valid until backward
+ * @param len number of inputs
+ * @param stride distance between consecutive inputs (1 for a contiguous array or a row-major matrix row)
+ * @returns valid `rac_var_t*` or asserts on failure
+ * @note The weighted sum is a single dot product node (see `rac_var_dot`); no input nodes are created. It accumulates
+ *       in `rac_acc_float` whenever it is evaluated; only the bias is added in `rac_float` by replays.
+ */
+extern rac_var_t *rac_neuron_forward_array(rac_neuron_t *const neuron, const rac_float *const input, const size_t len, const size_t stride);
+
 /**
  * @brief Zero all gradients
  * @param neuron instance
@@ -83,6 +115,23 @@ extern rac_var_t *rac_neuron_forward(rac_neuron_t *const neuron, const vt_plist_
  */
 extern void rac_neuron_zero_grad(rac_neuron_t *const neuron);
 
+/**
+ * @brief Zero the gradients of the weights of active input columns and of the bias
+ * @param neuron instance
+ * @param input sparse vector the neuron was run on (see `rac_neuron_forward_sparse`)
+ * @returns None
+ * @note Costs O(nnz) instead of O(input size); other weights get no gradient from a sparse forward.
+ */
+extern void rac_neuron_zero_grad_sparse(rac_neuron_t *const neuron, const rac_sparse_t *const input);
+
+/**
+ * @brief Frees cached by-product allocations (the forward graph)
+ * @param neuron instance
+ * @returns None
+ * @note Outputs returned by previous forward passes become invalid.
+ */
+extern void rac_neuron_clear_cache(rac_neuron_t *const neuron);
+
 /**
  * @brief Update neuron parameters
  * @param neuron instance
@@ -91,5 +140,15 @@ extern void rac_neuron_zero_grad(rac_neuron_t *const neuron);
  */
 extern void rac_neuron_update(rac_neuron_t *const neuron, const rac_float lr);
 
+/**
+ * @brief Update the weights of active input columns and the bias
+ * @param neuron instance
+ * @param input sparse vector the neuron was run on (see `rac_neuron_forward_sparse`)
+ * @param lr learning rate
+ * @returns None
+ * @note Indices of `input` must be unique (as produced by `rac_sparse_make_dense`).
+ */
+extern void rac_neuron_update_sparse(rac_neuron_t *const neuron, const rac_sparse_t *const input, const rac_float lr);
+
 #endif // RACCOON_NN_NEURON_H
 
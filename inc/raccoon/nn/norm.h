@@ -0,0 +1,136 @@
+#ifndef RACCOON_NN_NORM_H
+#define RACCOON_NN_NORM_H
+
+/** NORM MODULE (layer and batch normalization without a graph)
+ * Functions:
+    - rac_norm_make
+    - rac_norm_free
+    - rac_norm_forward
+    - rac_norm_backward
+    - rac_norm_zero_grad
+    - rac_norm_update
+    - rac_norm_fold
+*/
+
+#include "raccoon/core/core.h"
+#include "raccoon/nn/layer.h"
+
+// defaults of `rac_norm_t::eps` and `rac_norm_t::momentum`
+#define RAC_NORM_EPSILON 1e-5
+#define RAC_NORM_MOMENTUM 0.1
+
+// normalization axis
+enum RaccoonNormType {
+    RAC_NORM_LAYER, // each sample over its features
+    RAC_NORM_BATCH, // each feature over the batch; running statistics for inference
+};
+
+/*
+    Normalization layer over a batch stored `[batch][features]` row-major: `y = gamma * (x - mean) / sqrt(var + eps) + beta`
+        statistics: mean and variance in one pass (Welford), then normalization, scale and shift in a single loop
+        backward:   closed-form gradient from the cached normalized values and inverse deviations
+*/
+typedef struct RaccoonNorm {
+    // normalization axis and sizes
+    enum RaccoonNormType type;
+    size_t features;
+    size_t max_batch;
+
+    // parameters `gamma[features]`, `beta[features]`, then their gradients
+    rac_float *gamma;
+    rac_float *beta;
+    rac_float *grad_gamma;
+    rac_float *grad_beta;
+
+    // batch norm: statistics for inference, updated by training forwards with `momentum` (variance is unbiased)
+    rac_float *running_mean;
+    rac_float *running_var;
+
+    // settings: batch norm uses batch statistics when training and running statistics otherwise
+    rac_float eps;
+    rac_float momentum;
+    bool training;
+
+    // last forward: normalized values `[batch][features]` and inverse deviations (per sample or per feature)
+    size_t batch;
+    rac_float *normalized;
+    rac_float *inv_std;
+
+    // batch norm: per-feature mean of the last forward, and Welford statistics or backward sums (`2 * features`)
+    rac_float *mean;
+    rac_acc_float *scratch;
+
+    // allocator: if `NULL`, then calloc/realloc/free is used
+    struct VitaBaseAllocatorType *alloctr;
+} rac_norm_t;
+
+/*
+    Normalization creation/destruction
+*/
+
+/**
+ * @brief Creates a normalization layer with `gamma = 1`, `beta = 0` in training mode
+ * @param alloctr allocator instance
+ * @param type normalization axis
+ * @param features values per sample
+ * @param max_batch largest batch passed to forward
+ * @returns valid `rac_norm_t*` or asserts on failure
+ */
+extern rac_norm_t *rac_norm_make(struct VitaBaseAllocatorType *const alloctr, const enum RaccoonNormType type, const size_t features, const size_t max_batch);
+
+/**
+ * @brief Frees a normalization layer
+ * @param norm instance
+ * @returns None
+ */
+extern void rac_norm_free(rac_norm_t *norm);
+
+/*
+    Normalization operations
+*/
+
+/**
+ * @brief Forward operation
+ * @param norm instance
+ * @param input `[batch][features]`
+ * @param batch number of samples, at most `max_batch` (batch norm needs at least 2 when training)
+ * @param output `[batch][features]`; can be the same as `input`
+ * @returns None
+ */
+extern void rac_norm_forward(rac_norm_t *const norm, const rac_float *const input, const size_t batch, rac_float *const output);
+
+/**
+ * @brief Backward operation for the last forward: accumulates `gamma` and `beta` gradients
+ * @param norm instance
+ * @param grad_output `[batch][features]`
+ * @param grad_input `[batch][features]` (overwritten); can be `NULL` or the same as `grad_output`
+ * @returns None
+ */
+extern void rac_norm_backward(rac_norm_t *const norm, const rac_float *const grad_output, rac_float *const grad_input);
+
+/**
+ * @brief Zeroes parameter gradients
+ * @param norm instance
+ * @returns None
+ */
+extern void rac_norm_zero_grad(rac_norm_t *const norm);
+
+/**
+ * @brief Gradient descent step: `params -= lr * grad`
+ * @param norm instance
+ * @param lr learning rate
+ * @returns None
+ */
+extern void rac_norm_update(rac_norm_t *const norm, const rac_float lr);
+
+/**
+ * @brief Folds inference batch normalization into the preceding linear layer, so the norm layer can be dropped
+ * @param norm batch norm instance
+ * @param layer layer producing the normalized features, without activation
+ * @returns None
+ * @note Neuron `j`: `w *= s`, `b = (b - running_mean) * s + beta` with `s = gamma / sqrt(running_var + eps)`.
+ */
+extern void rac_norm_fold(const rac_norm_t *const norm, rac_layer_t *const layer);
+
+#endif // RACCOON_NN_NORM_H
+
@@ -0,0 +1,129 @@
+#ifndef RACCOON_NN_PACKED_MLP_H
+#define RACCOON_NN_PACKED_MLP_H
+
+/** PACKED MLP MODULE (16-bit parameter storage for inference)
+ * Functions:
+    - rac_packed_mlp_make
+    - rac_packed_mlp_free
+    - rac_packed_mlp_pack
+    - rac_packed_mlp_unpack
+    - rac_packed_mlp_pack_grad
+    - rac_packed_mlp_unpack_grad
+    - rac_packed_mlp_forward
+*/
+
+#include "raccoon/core/core.h"
+#include "raccoon/core/half.h"
+#include "raccoon/nn/mlp.h"
+
+// MLP snapshot with 16-bit parameters and activations; values are widened to `rac_float` as they are loaded
+typedef struct RaccoonPackedMLP {
+    // storage format
+    enum RaccoonHalfType type;
+
+    // shape including the input layer
+    size_t num_layers;
+    size_t *shape;
+
+    // per layer: weights `[out][in]` row-major, then biases `[out]`
+    rac_half_t *params;
+    size_t params_len;
+
+    // gradients with the same layout as `params`; `NULL` if not requested
+    rac_half_t *grads;
+
+    // two buffers of the widest layer: activations between layers are stored in 16 bits
+    rac_half_t *activations;
+    size_t width;
+
+    // scalar activation functions; if `NULL`, the layer's graph activation is used
+    rac_float (*activate_hidden)(const rac_float);
+    rac_float (*activate_output)(const rac_float);
+
+    // graph activations of the source model per layer (`num_layers - 1`); `NULL` entries are linear
+    rac_var_t *(**activate_layers)(rac_var_t *const);
+
+    // allocator: if `NULL`, then calloc/realloc/free is used
+    struct VitaBaseAllocatorType *alloctr;
+} rac_packed_mlp_t;
+
+/*
+    Packed MLP creation/destruction
+*/
+
+/**
+ * @brief Creates a packed copy of an MLP
+ * @param alloctr allocator instance
+ * @param mlp model to pack
+ * @param type storage format
+ * @param with_grads allocate 16-bit gradient storage
+ * @param activate_hidden activation for hidden layers, the scalar counterpart of the model's; if `NULL`, the model's own is used
+ * @param activate_output activation for the output layer; if `NULL`, the model's own is used
+ * @returns valid `rac_packed_mlp_t*` or asserts on failure
+ * @note Parameters and layer activations are taken from the model, so `rac_packed_mlp_make(alloctr, mlp, type, false, NULL, NULL)`
+ *       converts a trained model as is. Graph activations are evaluated on a temporary node per value (nodes created by the
+ *       activation are freed right away); pass the scalar counterparts (e.g. `rac_static_act_relu`) for speed.
+ */
+extern rac_packed_mlp_t *rac_packed_mlp_make(
+    struct VitaBaseAllocatorType *const alloctr,
+    const rac_mlp_t *const mlp,
+    const enum RaccoonHalfType type,
+    const bool with_grads,
+    rac_float (*activate_hidden)(const rac_float),
+    rac_float (*activate_output)(const rac_float)
+);
+
+/**
+ * @brief Frees a packed mlp instance
+ * @param packed instance
+ * @returns None
+ */
+extern void rac_packed_mlp_free(rac_packed_mlp_t *packed);
+
+/*
+    Packed MLP operations
+*/
+
+/**
+ * @brief Converts model parameters into the packed storage
+ * @param packed instance
+ * @param mlp model with the same shape
+ * @returns None
+ */
+extern void rac_packed_mlp_pack(rac_packed_mlp_t *const packed, const rac_mlp_t *const mlp);
+
+/**
+ * @brief Writes packed parameters back into a model (rounded to the storage format)
+ * @param packed instance
+ * @param mlp model with the same shape
+ * @returns None
+ */
+extern void rac_packed_mlp_unpack(const rac_packed_mlp_t *const packed, rac_mlp_t *const mlp);
+
+/**
+ * @brief Converts model parameter gradients into the packed gradient storage
+ * @param packed instance created with `with_grads`
+ * @param mlp model with the same shape
+ * @returns None
+ */
+extern void rac_packed_mlp_pack_grad(rac_packed_mlp_t *const packed, const rac_mlp_t *const mlp);
+
+/**
+ * @brief Writes packed gradients back into model parameter gradients
+ * @param packed instance created with `with_grads`
+ * @param mlp model with the same shape
+ * @returns None
+ */
+extern void rac_packed_mlp_unpack_grad(const rac_packed_mlp_t *const packed, rac_mlp_t *const mlp);
+
+/**
+ * @brief Forward operation without a graph
+ * @param packed instance
+ * @param input `shape[0]` values
+ * @param output `shape[num_layers-1]` values
+ * @returns None
+ */
+extern void rac_packed_mlp_forward(rac_packed_mlp_t *const packed, const rac_float *const input, rac_float *const output);
+
+#endif // RACCOON_NN_PACKED_MLP_H
+
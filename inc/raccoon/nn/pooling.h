@@ -0,0 +1,112 @@
+#ifndef RACCOON_NN_POOLING_H
+#define RACCOON_NN_POOLING_H
+
+/** POOLING MODULE (1D/2D max and average pooling without a graph)
+ * Functions:
+    - rac_pooling1d_make
+    - rac_pooling2d_make
+    - rac_pooling_free
+    - rac_pooling_forward
+    - rac_pooling_backward
+*/
+
+#include "raccoon/core/core.h"
+
+// pooling function
+enum RaccoonPoolingType {
+    RAC_POOLING_MAX,    // largest value of the window; backward routes the gradient to it
+    RAC_POOLING_AVG,    // mean of the window; backward spreads the gradient evenly
+};
+
+// Pooling layer over one sample stored `[channels][height][width]` row-major (1D: height 1); windows never cross the border
+typedef struct RaccoonPooling {
+    // pooling function
+    enum RaccoonPoolingType type;
+
+    // geometry: `[0]` height, `[1]` width
+    size_t channels;
+    size_t in_size[2];
+    size_t out_size[2];
+    size_t kernel[2];
+    size_t stride[2];
+
+    // input position of each output's maximum from the last forward (max pooling only)
+    size_t *argmax;
+
+    // allocator: if `NULL`, then calloc/realloc/free is used
+    struct VitaBaseAllocatorType *alloctr;
+} rac_pooling_t;
+
+/*
+    Pooling creation/destruction
+*/
+
+/**
+ * @brief Creates a 1D pooling layer
+ * @param alloctr allocator instance
+ * @param type pooling function
+ * @param channels number of channels
+ * @param length input length
+ * @param kernel window length
+ * @param stride step between windows (>= 1)
+ * @returns valid `rac_pooling_t*` or asserts on failure
+ */
+extern rac_pooling_t *rac_pooling1d_make(
+    struct VitaBaseAllocatorType *const alloctr,
+    const enum RaccoonPoolingType type,
+    const size_t channels,
+    const size_t length,
+    const size_t kernel,
+    const size_t stride
+);
+
+/**
+ * @brief Creates a 2D pooling layer
+ * @param alloctr allocator instance
+ * @param type pooling function
+ * @param channels number of channels
+ * @param in_size input `{ height, width }`
+ * @param kernel window `{ height, width }`
+ * @param stride `{ height, width }` steps between windows; `NULL` for non-overlapping windows (stride = kernel)
+ * @returns valid `rac_pooling_t*` or asserts on failure
+ */
+extern rac_pooling_t *rac_pooling2d_make(
+    struct VitaBaseAllocatorType *const alloctr,
+    const enum RaccoonPoolingType type,
+    const size_t channels,
+    const size_t in_size[2],
+    const size_t kernel[2],
+    const size_t stride[2]
+);
+
+/**
+ * @brief Frees a pooling layer
+ * @param pooling instance
+ * @returns None
+ */
+extern void rac_pooling_free(rac_pooling_t *pooling);
+
+/*
+    Pooling operations
+*/
+
+/**
+ * @brief Forward operation
+ * @param pooling instance
+ * @param input `channels * in_size[0] * in_size[1]` values
+ * @param output `channels * out_size[0] * out_size[1]` values
+ * @returns None
+ */
+extern void rac_pooling_forward(rac_pooling_t *const pooling, const rac_float *const input, rac_float *const output);
+
+/**
+ * @brief Backward operation for the last forward
+ * @param pooling instance
+ * @param grad_output gradient of the loss with respect to the output
+ * @param grad_input gradient with respect to the input (overwritten)
+ * @returns None
+ */
+extern void rac_pooling_backward(const rac_pooling_t *const pooling, const rac_float *const grad_output, rac_float *const grad_input);
+
+#endif // RACCOON_NN_POOLING_H
+
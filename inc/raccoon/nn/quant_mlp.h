@@ -0,0 +1,117 @@
+#ifndef RACCOON_NN_QUANT_MLP_H
+#define RACCOON_NN_QUANT_MLP_H
+
+/** QUANTIZED MLP MODULE (post-training int8 inference)
+ * Functions:
+    - rac_quant_mlp_make
+    - rac_quant_mlp_free
+    - rac_quant_mlp_calibrate
+    - rac_quant_mlp_forward
+*/
+
+#include "raccoon/core/core.h"
+#include "raccoon/nn/mlp.h"
+
+// weight rows are padded to this many values so that the SIMD kernels need no tail handling
+#define RAC_QUANT_ROW_ALIGN 32
+
+// largest quantized activation: 7-bit unsigned activations times 8-bit signed weights keep `maddubs` pair sums below INT16_MAX
+#define RAC_QUANT_ACTIVATION_MAX 127
+
+/*
+    Quantized MLP:
+        weights:        int8, symmetric, one scale per output channel
+        activations:    uint8 in [0, RAC_QUANT_ACTIVATION_MAX], one scale and zero point per layer input (from calibration)
+        accumulation:   int32, then requantized to the next layer's input in `rac_float`
+*/
+typedef struct RaccoonQuantMLP {
+    // shape including the input layer
+    size_t num_layers;
+    size_t *shape;
+
+    // per layer: weights `[out][RAC_QUANT_ROW_ALIGN-padded in]` row-major
+    int8_t *weights;
+
+    // per output channel (all layers): weight scale, bias and sum of quantized weights (zero point correction)
+    rac_float *weight_scales;
+    rac_float *biases;
+    int32_t *row_sums;
+
+    // per layer input: calibrated activation scale and zero point
+    rac_float *input_scales;
+    int32_t *input_zero_points;
+
+    // two buffers of the widest (padded) layer
+    uint8_t *activations;
+    size_t width;
+
+    // scalar activation functions; if `NULL`, the layer's graph activation is used
+    rac_float (*activate_hidden)(const rac_float);
+    rac_float (*activate_output)(const rac_float);
+
+    // graph activations of the source model per layer (`num_layers - 1`); `NULL` entries are linear
+    rac_var_t *(**activate_layers)(rac_var_t *const);
+
+    // allocator: if `NULL`, then calloc/realloc/free is used
+    struct VitaBaseAllocatorType *alloctr;
+} rac_quant_mlp_t;
+
+/*
+    Quantized MLP creation/destruction
+*/
+
+/**
+ * @brief Quantizes a trained MLP and calibrates activation ranges on sample inputs
+ * @param alloctr allocator instance
+ * @param mlp trained model
+ * @param samples `samples_len` inputs of `shape[0]` values each, row-major
+ * @param samples_len number of samples (at least 1)
+ * @param activate_hidden activation for hidden layers, the scalar counterpart of the model's; if `NULL`, the model's own is used
+ * @param activate_output activation for the output layer; if `NULL`, the model's own is used
+ * @returns valid `rac_quant_mlp_t*` or asserts on failure
+ * @note Layer activations are taken from the model, so calibration and inference match it with `NULL` scalar activations.
+ *       Graph activations are evaluated on a temporary node per value; pass the scalar counterparts for speed.
+ */
+extern rac_quant_mlp_t *rac_quant_mlp_make(
+    struct VitaBaseAllocatorType *const alloctr,
+    const rac_mlp_t *const mlp,
+    const rac_float *const samples,
+    const size_t samples_len,
+    rac_float (*activate_hidden)(const rac_float),
+    rac_float (*activate_output)(const rac_float)
+);
+
+/**
+ * @brief Frees a quantized mlp instance
+ * @param quant instance
+ * @returns None
+ */
+extern void rac_quant_mlp_free(rac_quant_mlp_t *quant);
+
+/*
+    Quantized MLP operations
+*/
+
+/**
+ * @brief Recomputes activation scales and zero points from the float model run on sample inputs
+ * @param quant instance
+ * @param mlp model the instance was made from
+ * @param samples `samples_len` inputs of `shape[0]` values each, row-major
+ * @param samples_len number of samples (at least 1)
+ * @returns None
+ */
+extern void rac_quant_mlp_calibrate(rac_quant_mlp_t *const quant, const rac_mlp_t *const mlp, const rac_float *const samples, const size_t samples_len);
+
+/**
+ * @brief Forward operation without a graph
+ * @param quant instance
+ * @param input `shape[0]` values
+ * @param output `shape[num_layers-1]` values
+ * @returns None
+ *
+ * @note Uses a VNNI (`vpdpbusd`) or AVX2 (`vpmaddubsw`) kernel when the library is compiled for it, the portable kernel otherwise; all produce the same result.
+ */
+extern void rac_quant_mlp_forward(rac_quant_mlp_t *const quant, const rac_float *const input, rac_float *const output);
+
+#endif // RACCOON_NN_QUANT_MLP_H
+
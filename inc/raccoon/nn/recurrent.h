@@ -0,0 +1,162 @@
+#ifndef RACCOON_NN_RECURRENT_H
+#define RACCOON_NN_RECURRENT_H
+
+/** RECURRENT MODULE (RNN/GRU/LSTM layers with truncated backpropagation through time)
+ * Functions:
+    - rac_recurrent_make
+    - rac_recurrent_free
+    - rac_recurrent_reset
+    - rac_recurrent_forward
+    - rac_recurrent_backward
+    - rac_recurrent_zero_grad
+    - rac_recurrent_update
+    - rac_recurrent_init
+*/
+
+#include "raccoon/core/core.h"
+#include "raccoon/core/gemm.h"
+#include "raccoon/core/random.h"
+
+// recurrent cell
+enum RaccoonRecurrentType {
+    RAC_RECURRENT_RNN,  // h = tanh(Wx x + Wh h + b)
+    RAC_RECURRENT_GRU,  // gates `{ r, u, n }`: n = tanh(Wx_n x + b_n + r * Wh_n h), h = (1 - u) * n + u * h
+    RAC_RECURRENT_LSTM, // gates `{ i, f, g, o }`: c = f * c + i * g, h = o * tanh(c)
+};
+
+/*
+    Recurrent layer over sequences stored `[steps][features]` row-major:
+        gates:      all gates of a step come from one product `weights_hidden * h` (`gates` rows); the input
+                    products of a whole window are one `rac_gemm` before the time loop
+        window:     `rac_recurrent_forward` runs up to `window` steps from the carried state and keeps what backward needs;
+                    the next call starts a new window, so gradients never flow further back than one window (truncated BPTT)
+        memory:     all buffers are allocated once for `window` steps and reused
+*/
+typedef struct RaccoonRecurrent {
+    // cell and sizes
+    enum RaccoonRecurrentType type;
+    size_t input_size;
+    size_t hidden_size;
+    size_t gates; // `hidden_size` times the number of gates
+    size_t window;
+
+    // parameters: `weights_input[gates][input_size]`, `weights_hidden[gates][hidden_size]`, `bias[gates]`
+    rac_float *weights_input;
+    rac_float *weights_hidden;
+    rac_float *bias;
+    size_t params_len;
+
+    // gradients with the same layout as the parameters
+    rac_float *grad_weights_input;
+    rac_float *grad_weights_hidden;
+    rac_float *grad_bias;
+
+    // state carried between windows
+    rac_float *hidden;
+    rac_float *cell; // LSTM only
+
+    // last window: input (read by backward), states before/after each step, gate activations
+    const rac_float *input;
+    size_t steps;
+    rac_float *hiddens;     // `[window + 1][hidden_size]`
+    rac_float *cells;       // `[window + 1][hidden_size]`, LSTM only
+    rac_float *activations; // `[window][gates]`
+    rac_float *candidates;  // `[window][hidden_size]`, GRU only: `Wh_n h` before the reset gate
+
+    // backward buffers: gate gradients for the input and the hidden products (the same except for GRU candidates)
+    rac_float *grad_gates;      // `[window][gates]`
+    rac_float *grad_recurrent;  // `[window][gates]`
+    rac_float *scratch;         // `gates + 3 * hidden_size`
+
+    // allocator: if `NULL`, then calloc/realloc/free is used
+    struct VitaBaseAllocatorType *alloctr;
+} rac_recurrent_t;
+
+/*
+    Recurrent layer creation/destruction
+*/
+
+/**
+ * @brief Creates a recurrent layer with Xavier initialized weights (see `rac_recurrent_init`), zero biases and a zero state
+ * @param alloctr allocator instance
+ * @param type recurrent cell
+ * @param input_size features per step
+ * @param hidden_size hidden state size
+ * @param window largest number of steps per forward (truncation length)
+ * @param rng random stream for the weights
+ * @returns valid `rac_recurrent_t*` or asserts on failure
+ */
+extern rac_recurrent_t *rac_recurrent_make(
+    struct VitaBaseAllocatorType *const alloctr,
+    const enum RaccoonRecurrentType type,
+    const size_t input_size,
+    const size_t hidden_size,
+    const size_t window,
+    rac_random_t *const rng
+);
+
+/**
+ * @brief Frees a recurrent layer
+ * @param rnn instance
+ * @returns None
+ */
+extern void rac_recurrent_free(rac_recurrent_t *rnn);
+
+/*
+    Recurrent layer operations
+*/
+
+/**
+ * @brief Zeroes the carried state (start of a new sequence)
+ * @param rnn instance
+ * @returns None
+ */
+extern void rac_recurrent_reset(rac_recurrent_t *const rnn);
+
+/**
+ * @brief Runs the next window of a sequence from the carried state
+ * @param rnn instance
+ * @param input `[steps][input_size]`; must stay valid until backward
+ * @param steps number of steps, at most `window`
+ * @param output `[steps][hidden_size]` hidden states
+ * @returns None
+ */
+extern void rac_recurrent_forward(rac_recurrent_t *const rnn, const rac_float *const input, const size_t steps, rac_float *const output);
+
+/**
+ * @brief Backpropagates through the last window: accumulates parameter gradients
+ * @param rnn instance
+ * @param grad_output `[steps][hidden_size]` gradient of the loss with respect to the hidden states
+ * @param grad_input `[steps][input_size]` gradient with respect to the input (overwritten); can be `NULL`
+ * @returns None
+ * @note The state the window started from is treated as a constant.
+ */
+extern void rac_recurrent_backward(rac_recurrent_t *const rnn, const rac_float *const grad_output, rac_float *const grad_input);
+
+/**
+ * @brief Zeroes parameter gradients
+ * @param rnn instance
+ * @returns None
+ */
+extern void rac_recurrent_zero_grad(rac_recurrent_t *const rnn);
+
+/**
+ * @brief Gradient descent step: `params -= lr * grad`
+ * @param rnn instance
+ * @param lr learning rate
+ * @returns None
+ */
+extern void rac_recurrent_update(rac_recurrent_t *const rnn, const rac_float lr);
+
+/**
+ * @brief Reinitializes parameters: weights by the scheme (`fan_in` is `input_size` for input weights, `hidden_size` for
+ *        hidden weights; `fan_out` is `hidden_size`), biases to zero
+ * @param rnn instance
+ * @param init initialization scheme
+ * @param rng random stream
+ * @returns None
+ */
+extern void rac_recurrent_init(rac_recurrent_t *const rnn, const enum RaccoonRandomInit init, rac_random_t *const rng);
+
+#endif // RACCOON_NN_RECURRENT_H
+
@@ -0,0 +1,200 @@
+#ifndef RACCOON_NN_STATIC_MLP_H
+#define RACCOON_NN_STATIC_MLP_H
+
+/** STATIC MLP MODULE (fixed-shape multi-layer perceptron without a graph)
+ * Macros:
+    - RAC_DEFINE_MLP
+ * Functions (generated for `name`):
+    - name_load
+    - name_store
+    - name_forward
+    - name_backward
+    - name_update
+ * Activations (`act` argument):
+    - linear
+    - relu
+    - tanh
+    - sigmoid
+*/
+
+#include "raccoon/core/core.h"
+#include "raccoon/nn/mlp.h"
+
+/*
+    Activations: value and derivative expressed through the activation output
+*/
+
+static inline rac_float rac_static_act_linear(const rac_float x) { return x; }
+static inline rac_float rac_static_act_linear_grad(const rac_float y) { (void)y; return 1; }
+static inline rac_float rac_static_act_relu(const rac_float x) { return x > 0 ? x : 0; }
+static inline rac_float rac_static_act_relu_grad(const rac_float y) { return y > 0 ? 1 : 0; }
+static inline rac_float rac_static_act_tanh(const rac_float x) { return RAC_TANH(x); }
+static inline rac_float rac_static_act_tanh_grad(const rac_float y) { return 1 - y * y; }
+static inline rac_float rac_static_act_sigmoid(const rac_float x) { return 1 / (1 + RAC_EXP(-x)); }
+static inline rac_float rac_static_act_sigmoid_grad(const rac_float y) { return y * (1 - y); }
+
+// whether the hidden layer of a `rac_mlp_t` loaded into the kernel must have an activation
+#define RAC_STATIC_ACT_ACTIVATED_linear false
+#define RAC_STATIC_ACT_ACTIVATED_relu true
+#define RAC_STATIC_ACT_ACTIVATED_tanh true
+#define RAC_STATIC_ACT_ACTIVATED_sigmoid true
+
+/**
+ * @brief Checks that a `rac_mlp_t` has the `{ in, hid, out }` shape
+ * @param mlp instance
+ * @param in input size
+ * @param hid hidden layer size
+ * @param out output size
+ * @returns None, asserts on shape mismatch
+ */
+static inline void rac_static_mlp_check_shape(const rac_mlp_t *const mlp, const size_t in, const size_t hid, const size_t out) {
+    VT_ENFORCE(mlp != NULL && vt_plist_len(mlp->layers) == 2, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    const rac_layer_t *hidden = vt_plist_get(mlp->layers, 0);
+    const rac_layer_t *output = vt_plist_get(mlp->layers, 1);
+    VT_ENFORCE(vt_plist_len(hidden->neurons) == hid && vt_plist_len(output->neurons) == out, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(vt_plist_len(((const rac_neuron_t*)vt_plist_get(hidden->neurons, 0))->params) == in + 1, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(vt_plist_len(((const rac_neuron_t*)vt_plist_get(output->neurons, 0))->params) == hid + 1, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+}
+
+/**
+ * @brief Checks that the layer activations of a `rac_mlp_t` match the generated kernel
+ * @param mlp instance of the `{ in, hid, out }` shape
+ * @param activated whether the kernel's hidden layer has an activation
+ * @returns None, asserts on mismatch
+ * @note Only the presence of the hidden activation can be checked; it must be the graph counterpart of `act`.
+ */
+static inline void rac_static_mlp_check_activations(const rac_mlp_t *const mlp, const bool activated) {
+    const rac_layer_t *hidden = vt_plist_get(mlp->layers, 0);
+    const rac_layer_t *output = vt_plist_get(mlp->layers, 1);
+    VT_ENFORCE((hidden->activate != NULL) == activated, "%s\n", "Hidden layer activation does not match the static MLP!");
+    VT_ENFORCE(output->activate == NULL, "%s\n", "Output layer of a static MLP must be linear!");
+}
+
+/**
+ * @brief Copies neuron parameters (weights + bias) between a `rac_mlp_t` layer and flat arrays
+ * @param layer layer instance
+ * @param inputs number of neuron inputs
+ * @param w weights, `[neurons][inputs]` row-major
+ * @param b biases, `[neurons]`
+ * @param store `true`: arrays -> layer, `false`: layer -> arrays
+ * @returns None
+ */
+static inline void rac_static_mlp_copy_layer(const rac_layer_t *const layer, const size_t inputs, rac_float *const w, rac_float *const b, const bool store) {
+    const size_t neurons_len = vt_plist_len(layer->neurons);
+    VT_FOREACH(j, 0, neurons_len) {
+        const rac_neuron_t *neuron = vt_plist_get(layer->neurons, j);
+        VT_FOREACH(i, 0, inputs + 1) {
+            rac_var_t *p = vt_plist_get(neuron->params, i);
+            rac_float *value = (i < inputs) ? &w[j * inputs + i] : &b[j];
+            if (store) {
+                p->data = *value;
+            } else {
+                *value = p->data;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Defines a fixed-shape `{ in, hid, out }` MLP over stack arrays
+ * @param name prefix of the generated types and functions
+ * @param in input size (constant)
+ * @param hid hidden layer size (constant)
+ * @param out output size (constant)
+ * @param act hidden layer activation: `linear`, `relu`, `tanh` or `sigmoid`; the output layer is linear
+ *
+ * @note Generates:
+ *  - `name_params_t`: weights and biases (also used for gradients)
+ *  - `name_cache_t`: forward activations needed by backward
+ *  - `name_load(params, mlp)`, `name_store(params, mlp)`: copy parameters from/to a `rac_mlp_t` of the same shape;
+ *    `name_load` also asserts that the model's hidden layer is activated exactly when `act` is not `linear`, and that
+ *    its output layer is linear
+ *  - `name_forward(params, x, y, cache)`: `cache` can be `NULL` for inference
+ *  - `name_backward(params, cache, dy, grad, dx)`: accumulates parameter gradients into `grad`; `dx` can be `NULL`
+ *  - `name_update(params, grad, lr)`: `params -= lr * grad`
+ * @note Loop bounds are compile-time constants, so the compiler fully unrolls and vectorizes the kernels.
+ * @note Sums are accumulated in the same order as `rac_neuron_forward` (weights first, then bias).
+ */
+#define RAC_DEFINE_MLP(name, in, hid, out, act)                                                                     \
+    typedef struct {                                                                                                \
+        rac_float w1[hid][in];                                                                                      \
+        rac_float b1[hid];                                                                                          \
+        rac_float w2[out][hid];                                                                                     \
+        rac_float b2[out];                                                                                          \
+    } name##_params_t;                                                                                              \
+                                                                                                                    \
+    typedef struct {                                                                                                \
+        rac_float x[in];                                                                                            \
+        rac_float h[hid];                                                                                           \
+    } name##_cache_t;                                                                                               \
+                                                                                                                    \
+    static inline void name##_load(name##_params_t *const params, const rac_mlp_t *const mlp) {                     \
+        rac_static_mlp_check_shape(mlp, in, hid, out);                                                              \
+        rac_static_mlp_check_activations(mlp, RAC_STATIC_ACT_ACTIVATED_##act);                                      \
+        rac_static_mlp_copy_layer(vt_plist_get(mlp->layers, 0), in, &params->w1[0][0], params->b1, false);          \
+        rac_static_mlp_copy_layer(vt_plist_get(mlp->layers, 1), hid, &params->w2[0][0], params->b2, false);         \
+    }                                                                                                               \
+                                                                                                                    \
+    static inline void name##_store(const name##_params_t *const params, rac_mlp_t *const mlp) {                    \
+        rac_static_mlp_check_shape(mlp, in, hid, out);                                                              \
+        name##_params_t tmp = *params;                                                                              \
+        rac_static_mlp_copy_layer(vt_plist_get(mlp->layers, 0), in, &tmp.w1[0][0], tmp.b1, true);                   \
+        rac_static_mlp_copy_layer(vt_plist_get(mlp->layers, 1), hid, &tmp.w2[0][0], tmp.b2, true);                  \
+    }                                                                                                               \
+                                                                                                                    \
+    static inline void name##_forward(                                                                              \
+        const name##_params_t *const params, const rac_float x[in], rac_float y[out], name##_cache_t *const cache   \
+    ) {                                                                                                             \
+        rac_float h[hid];                                                                                           \
+        for (size_t j = 0; j < (hid); j++) {                                                                        \
+            rac_acc_float sum = 0;                                                                                  \
+            for (size_t i = 0; i < (in); i++) sum += (rac_acc_float)params->w1[j][i] * x[i];                        \
+            h[j] = rac_static_act_##act((rac_float)(sum + params->b1[j]));                                          \
+        }                                                                                                           \
+        for (size_t k = 0; k < (out); k++) {                                                                        \
+            rac_acc_float sum = 0;                                                                                  \
+            for (size_t j = 0; j < (hid); j++) sum += (rac_acc_float)params->w2[k][j] * h[j];                       \
+            y[k] = (rac_float)(sum + params->b2[k]);                                                                \
+        }                                                                                                           \
+        if (cache) {                                                                                                \
+            for (size_t i = 0; i < (in); i++) cache->x[i] = x[i];                                                   \
+            for (size_t j = 0; j < (hid); j++) cache->h[j] = h[j];                                                  \
+        }                                                                                                           \
+    }                                                                                                               \
+                                                                                                                    \
+    static inline void name##_backward(                                                                             \
+        const name##_params_t *const params, const name##_cache_t *const cache,                                     \
+        const rac_float dy[out], name##_params_t *const grad, rac_float dx[in]                                      \
+    ) {                                                                                                             \
+        rac_float dh[hid] = {0};                                                                                    \
+        for (size_t k = 0; k < (out); k++) {                                                                        \
+            grad->b2[k] += dy[k];                                                                                   \
+            for (size_t j = 0; j < (hid); j++) {                                                                    \
+                grad->w2[k][j] += cache->h[j] * dy[k];                                                              \
+                dh[j] += params->w2[k][j] * dy[k];                                                                  \
+            }                                                                                                       \
+        }                                                                                                           \
+        for (size_t j = 0; j < (hid); j++) dh[j] *= rac_static_act_##act##_grad(cache->h[j]);                       \
+        if (dx) for (size_t i = 0; i < (in); i++) dx[i] = 0;                                                        \
+        for (size_t j = 0; j < (hid); j++) {                                                                        \
+            grad->b1[j] += dh[j];                                                                                   \
+            for (size_t i = 0; i < (in); i++) {                                                                     \
+                grad->w1[j][i] += cache->x[i] * dh[j];                                                              \
+                if (dx) dx[i] += params->w1[j][i] * dh[j];                                                          \
+            }                                                                                                       \
+        }                                                                                                           \
+    }                                                                                                               \
+                                                                                                                    \
+    static inline void name##_update(name##_params_t *const params, const name##_params_t *const grad, const rac_float lr) { \
+        for (size_t j = 0; j < (hid); j++) {                                                                        \
+            params->b1[j] -= lr * grad->b1[j];                                                                      \
+            for (size_t i = 0; i < (in); i++) params->w1[j][i] -= lr * grad->w1[j][i];                              \
+        }                                                                                                           \
+        for (size_t k = 0; k < (out); k++) {                                                                        \
+            params->b2[k] -= lr * grad->b2[k];                                                                      \
+            for (size_t j = 0; j < (hid); j++) params->w2[k][j] -= lr * grad->w2[k][j];                             \
+        }                                                                                                           \
+    }
+
+#endif // RACCOON_NN_STATIC_MLP_H
+
@@ -4,11 +4,35 @@
 #include "raccoon/core/core.h"
 #include "raccoon/core/version.h"
 #include "raccoon/core/variable.h"
+#include "raccoon/core/graph.h"
+#include "raccoon/core/half.h"
+#include "raccoon/core/sparse.h"
+#include "raccoon/core/schedule.h"
+#include "raccoon/core/pool.h"
+#include "raccoon/core/counter.h"
+#include "raccoon/core/gemm.h"
+#include "raccoon/core/random.h"
 #include "raccoon/nn/neuron.h"
 #include "raccoon/nn/layer.h"
 #include "raccoon/nn/mlp.h"
+#include "raccoon/nn/checkpoint.h"
+#include "raccoon/nn/static_mlp.h"
+#include "raccoon/nn/packed_mlp.h"
+#include "raccoon/nn/quant_mlp.h"
+#include "raccoon/nn/conv.h"
+#include "raccoon/nn/pooling.h"
+#include "raccoon/nn/recurrent.h"
+#include "raccoon/nn/embedding.h"
+#include "raccoon/nn/norm.h"
+#include "raccoon/nn/dropout.h"
 #include "raccoon/auxiliary/tape.h"
 #include "raccoon/auxiliary/loss.h"
+#include "raccoon/auxiliary/instrument.h"
+#include "raccoon/auxiliary/memory.h"
+#include "raccoon/auxiliary/jit.h"
+#include "raccoon/auxiliary/jvp.h"
+#include "raccoon/auxiliary/grad.h"
+#include "raccoon/auxiliary/static_graph.h"
 
 #endif // RACCOON_H
 
@@ -0,0 +1,212 @@
+#include "raccoon/auxiliary/grad.h"
+
+static rac_var_t *rac_grad_push(rac_grad_t *const grad, rac_var_t *const var);
+static void rac_grad_accumulate(rac_grad_t *const grad, const rac_var_t *const var, rac_var_t *const contribution);
+static bool rac_grad_is_builtin(const rac_var_t *const var);
+
+/*
+    Grad creation/destruction
+*/
+
+rac_grad_t *rac_grad_make(struct VitaBaseAllocatorType *const alloctr, rac_var_t *const root) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(root != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // order nodes; derivatives are recorded as graph operations, so only built-in operations are supported
+    vt_plist_t *nodes = rac_graph_topo_sort(root);
+    const size_t len = vt_plist_len(nodes);
+    VT_FOREACH(i, 0, len) {
+        const rac_var_t *var = vt_plist_get(nodes, i);
+        VT_ENFORCE(var->op != 'd', "%s\n", "Dot products keep their weights outside of the graph! Use variable inputs (`rac_mlp_forward`) instead!");
+        const bool leaf = var->parents[0] == NULL && var->parents[1] == NULL;
+        VT_ENFORCE(
+            leaf || (rac_grad_is_builtin(var) && rac_var_has_rule(var)),
+            "Operation '%c' cannot be differentiated as a graph! Build it from `{ +, -, *, /, f, q, a }`!\n", var->op
+        );
+    }
+    rac_graph_map_t *index = rac_graph_map_make(alloctr, len);
+    VT_FOREACH(i, 0, len) rac_graph_map_set(index, vt_plist_get(nodes, i), i);
+
+    // allocate grad instance
+    rac_grad_t *grad = (alloctr == NULL)
+        ? VT_CALLOC(sizeof(rac_grad_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, sizeof(rac_grad_t));
+    rac_var_t **adjoints = (alloctr == NULL)
+        ? VT_CALLOC(len * sizeof(rac_var_t*))
+        : VT_ALLOCATOR_ALLOC(alloctr, len * sizeof(rac_var_t*));
+
+    // init
+    *grad = (rac_grad_t) {
+        .nodes = nodes,
+        .index = index,
+        .adjoints = adjoints,
+        .created = vt_plist_create(2 * len, alloctr),
+        .alloctr = alloctr,
+    };
+
+    // constants; `a - b` is recorded as `fma(-1, b, a)`
+    rac_var_t *one = rac_grad_push(grad, rac_var_make_const(alloctr, 1));
+    rac_var_t *two = rac_grad_push(grad, rac_var_make_const(alloctr, 2));
+    rac_var_t *minus_one = rac_grad_push(grad, rac_var_make_const(alloctr, -1));
+
+    // reverse sweep: record the backward rules as operations
+    adjoints[len-1] = one;
+    for (size_t i = len; i-- > 0;) {
+        rac_var_t *var = vt_plist_get(nodes, i);
+        rac_var_t *adj = adjoints[i];
+        if (adj == NULL || (var->parents[0] == NULL && var->parents[1] == NULL)) continue;
+
+        rac_var_t *lhs = var->parents[0], *rhs = var->parents[1];
+        switch(var->op) {
+            case '+':
+                rac_grad_accumulate(grad, lhs, adj);
+                rac_grad_accumulate(grad, rhs, adj);
+                break;
+            case '-':
+                rac_grad_accumulate(grad, lhs, adj);
+                rac_grad_accumulate(grad, rhs, rac_grad_push(grad, rac_var_mul(minus_one, adj)));
+                break;
+            case '*':
+                rac_grad_accumulate(grad, lhs, rac_grad_push(grad, rac_var_mul(rhs, adj)));
+                rac_grad_accumulate(grad, rhs, rac_grad_push(grad, rac_var_mul(lhs, adj)));
+                break;
+            case '/': {
+                // d/d(lhs) = adj / rhs, d/d(rhs) = -adj * lhs / rhs^2 = -(adj / rhs) * var
+                rac_var_t *scaled = rac_grad_push(grad, rac_var_div(adj, rhs));
+                rac_grad_accumulate(grad, lhs, scaled);
+                rac_grad_accumulate(grad, rhs, rac_grad_push(grad, rac_var_mul(minus_one, rac_grad_push(grad, rac_var_mul(scaled, var)))));
+            } break;
+            case 'f':
+                rac_grad_accumulate(grad, lhs, rac_grad_push(grad, rac_var_mul(rhs, adj)));
+                rac_grad_accumulate(grad, rhs, rac_grad_push(grad, rac_var_mul(lhs, adj)));
+                rac_grad_accumulate(grad, rac_var_operand(var, 2), adj);
+                break;
+            case 'q':
+            case 'a': {
+                rac_var_t *diff = rac_grad_push(grad, rac_var_fma(minus_one, rhs, lhs));
+                rac_var_t *scaled = rac_grad_push(grad, rac_var_mul(two, rac_grad_push(grad, rac_var_mul(diff, adj))));
+                rac_grad_accumulate(grad, lhs, scaled);
+                rac_grad_accumulate(grad, rhs, rac_grad_push(grad, rac_var_mul(minus_one, scaled)));
+                if (var->op == 'a') rac_grad_accumulate(grad, rac_var_operand(var, 2), adj);
+            } break;
+            default:
+                VT_ENFORCE(false, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+        }
+    }
+
+    // forward mode over the original graph and everything the gradients depend on
+    vt_plist_t *outputs = vt_plist_create(vt_plist_len(grad->created) + 1, alloctr);
+    vt_plist_push_back(outputs, root);
+    VT_FOREACH(i, 0, vt_plist_len(grad->created)) vt_plist_push_back(outputs, vt_plist_get(grad->created, i));
+    grad->jvp = rac_jvp_make(alloctr, outputs);
+    vt_plist_destroy(outputs);
+
+    return grad;
+}
+
+void rac_grad_free(rac_grad_t *grad) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(grad != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // free created nodes
+    VT_FOREACH(i, 0, vt_plist_len(grad->created)) rac_var_free(vt_plist_get(grad->created, i));
+    vt_plist_destroy(grad->created);
+
+    // free jvp, node list, index and adjoints
+    rac_jvp_free(grad->jvp);
+    vt_plist_destroy(grad->nodes);
+    rac_graph_map_free(grad->index);
+    if (grad->alloctr) {
+        VT_ALLOCATOR_FREE(grad->alloctr, grad->adjoints);
+        VT_ALLOCATOR_FREE(grad->alloctr, grad);
+    } else {
+        VT_FREE(grad->adjoints);
+        VT_FREE(grad);
+    }
+}
+
+/*
+    Grad operations
+*/
+
+rac_var_t *rac_grad_get(const rac_grad_t *const grad, const rac_var_t *const var) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(grad != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(var != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // find node
+    size_t idx = 0;
+    return rac_graph_map_get(grad->index, var, &idx) ? grad->adjoints[idx] : NULL;
+}
+
+void rac_grad_update(rac_grad_t *const grad) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(grad != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // parents come first in the jvp order
+    VT_FOREACH(i, 0, vt_plist_len(grad->jvp->nodes)) rac_var_update(vt_plist_get(grad->jvp->nodes, i));
+}
+
+void rac_grad_hvp(rac_grad_t *const grad, const size_t len, rac_var_t *const wrt[len], const rac_float *const v, rac_float *const hv) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(grad != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(wrt != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(v != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(hv != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // seed the direction; variables that do not affect the root have no gradient node and contribute nothing
+    rac_jvp_zero(grad->jvp);
+    VT_FOREACH(k, 0, len) {
+        if (rac_grad_get(grad, wrt[k])) rac_jvp_seed(grad->jvp, wrt[k], v[k]);
+    }
+
+    // d(gradient)/d(v) = H v
+    rac_jvp_forward(grad->jvp);
+    VT_FOREACH(k, 0, len) {
+        const rac_var_t *adj = rac_grad_get(grad, wrt[k]);
+        hv[k] = adj ? rac_jvp_tangent(grad->jvp, adj) : 0;
+    }
+}
+
+// -------------------------- PRIVATE -------------------------- //
+
+/**
+ * @brief Records a created node, so that it is freed with the grad instance
+ * @param grad instance
+ * @param var created node
+ * @returns `var`
+ */
+static rac_var_t *rac_grad_push(rac_grad_t *const grad, rac_var_t *const var) {
+    vt_plist_push_back(grad->created, var);
+    return var;
+}
+
+/**
+ * @brief Adds a contribution to the gradient node of a parent
+ * @param grad instance
+ * @param var parent node
+ * @param contribution gradient contribution
+ * @returns None
+ */
+static void rac_grad_accumulate(rac_grad_t *const grad, const rac_var_t *const var, rac_var_t *const contribution) {
+    size_t idx = 0;
+    rac_graph_map_get(grad->index, var, &idx);
+    grad->adjoints[idx] = grad->adjoints[idx]
+        ? rac_grad_push(grad, rac_var_add(grad->adjoints[idx], contribution))
+        : contribution;
+}
+
+
+/**
+ * @brief Checks if a node is a built-in operation whose derivative can be recorded as graph operations
+ * @param var graph node
+ * @returns `true` for `{ +, -, *, /, f, q, a }`; custom operations only have numeric derivatives (see `rac_var_register_op`)
+ */
+static bool rac_grad_is_builtin(const rac_var_t *const var) {
+    switch (var->op) {
+        case '+': case '-': case '*': case '/': case 'f': case 'q': case 'a':
+            return true;
+        default:
+            return false;
+    }
+}
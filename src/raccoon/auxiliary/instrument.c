@@ -0,0 +1,210 @@
+#include <time.h>
+#include <stdatomic.h>
+#include "raccoon/auxiliary/instrument.h"
+
+// Trace event: a complete ("ph": "X") event
+struct RaccoonInstrumentEvent {
+    enum RaccoonInstrumentSpan span;
+    double start_secs;
+    double duration_secs;
+};
+
+static const char *const rac_instrument_span_str[] = {
+    "rac_mlp_forward",
+    "rac_layer_forward",
+    "rac_var_backward",
+    "rac_mlp_update",
+    "rac_layer_update",
+};
+
+static struct RaccoonInstrumentStats gi_stats = {0};
+static struct RaccoonInstrumentEvent *gi_events = NULL;
+static size_t gi_events_len = 0;
+static size_t gi_events_capacity = 0;
+static double gi_epoch_secs = -1;
+static atomic_flag gi_lock = ATOMIC_FLAG_INIT;
+
+static double rac_instrument_time_now_secs(void);
+static void rac_instrument_lock(void);
+static void rac_instrument_unlock(void);
+
+/*
+    Instrumentation control
+*/
+
+void rac_instrument_reset(void) {
+    rac_instrument_lock();
+    gi_stats = (struct RaccoonInstrumentStats) {0};
+    gi_events_len = 0;
+    gi_epoch_secs = rac_instrument_time_now_secs();
+    rac_instrument_unlock();
+}
+
+void rac_instrument_free(void) {
+    rac_instrument_lock();
+    VT_FREE(gi_events);
+    gi_events = NULL;
+    gi_events_len = gi_events_capacity = 0;
+    gi_stats = (struct RaccoonInstrumentStats) {0};
+    gi_epoch_secs = -1;
+    rac_instrument_unlock();
+}
+
+const struct RaccoonInstrumentStats *rac_instrument_get_stats(void) {
+    return &gi_stats;
+}
+
+void rac_instrument_print_stats(void) {
+    rac_instrument_lock();
+    printf("nodes: %zu total\n", gi_stats.nodes_total);
+    VT_FOREACH(i, 0, 256) {
+        if (gi_stats.nodes[i] == 0) continue;
+        (i == 0)
+            ? printf("    leaf: %zu\n", gi_stats.nodes[i])
+            : printf("    '%c': %zu\n", (char)i, gi_stats.nodes[i]);
+    }
+    printf("backward: %zu calls, %zu nodes\n", gi_stats.backward_calls, gi_stats.backward_nodes);
+    printf("allocator: %zu allocs (%zu bytes), %zu frees\n", gi_stats.alloc_calls, gi_stats.alloc_bytes, gi_stats.free_calls);
+    VT_FOREACH(i, 0, RAC_INSTRUMENT_SPAN_COUNT) {
+        printf("%s: %zu calls, %.6f secs\n", rac_instrument_span_str[i], gi_stats.span_calls[i], gi_stats.span_secs[i]);
+    }
+    rac_instrument_unlock();
+}
+
+bool rac_instrument_dump_trace(const char *const path) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(path != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // open file
+    FILE *fp = fopen(path, "w");
+    if (fp == NULL) return false;
+
+    // write events
+    rac_instrument_lock();
+    fprintf(fp, "{\"traceEvents\":[\n");
+    VT_FOREACH(i, 0, gi_events_len) {
+        const struct RaccoonInstrumentEvent e = gi_events[i];
+        fprintf(
+            fp,
+            "{\"name\":\"%s\",\"cat\":\"raccoon\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":0,\"tid\":0},\n",
+            rac_instrument_span_str[e.span], e.start_secs * 1e6, e.duration_secs * 1e6
+        );
+    }
+
+    // write counters as the last event
+    fprintf(
+        fp,
+        "{\"name\":\"counters\",\"cat\":\"raccoon\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":0,\"tid\":0,\"args\":{"
+        "\"nodes\":%zu,\"backward_calls\":%zu,\"backward_nodes\":%zu,\"alloc_calls\":%zu,\"alloc_bytes\":%zu,\"free_calls\":%zu}}\n",
+        (gi_epoch_secs < 0) ? 0 : (rac_instrument_time_now_secs() - gi_epoch_secs) * 1e6,
+        gi_stats.nodes_total, gi_stats.backward_calls, gi_stats.backward_nodes,
+        gi_stats.alloc_calls, gi_stats.alloc_bytes, gi_stats.free_calls
+    );
+    fprintf(fp, "],\"otherData\":{\"trace_dropped\":%zu}}\n", gi_stats.trace_dropped);
+    rac_instrument_unlock();
+
+    return fclose(fp) == 0;
+}
+
+/*
+    Hooks
+*/
+
+void rac_instrument_count_node(const char op) {
+    rac_instrument_lock();
+    gi_stats.nodes[(unsigned char)op]++;
+    gi_stats.nodes_total++;
+    rac_instrument_unlock();
+}
+
+void rac_instrument_count_alloc(const size_t bytes) {
+    rac_instrument_lock();
+    gi_stats.alloc_calls++;
+    gi_stats.alloc_bytes += bytes;
+    rac_instrument_unlock();
+}
+
+void rac_instrument_count_free(void) {
+    rac_instrument_lock();
+    gi_stats.free_calls++;
+    rac_instrument_unlock();
+}
+
+void rac_instrument_count_backward(const size_t nodes) {
+    rac_instrument_lock();
+    gi_stats.backward_calls++;
+    gi_stats.backward_nodes += nodes;
+    rac_instrument_unlock();
+}
+
+double rac_instrument_span_begin(void) {
+    return rac_instrument_time_now_secs();
+}
+
+void rac_instrument_span_end(const enum RaccoonInstrumentSpan span, const double start_secs) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(span < RAC_INSTRUMENT_SPAN_COUNT, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // update counters
+    const double duration_secs = rac_instrument_time_now_secs() - start_secs;
+    rac_instrument_lock();
+    gi_stats.span_calls[span]++;
+    gi_stats.span_secs[span] += duration_secs;
+
+    // grow event buffer (it is not tracked by the user allocator on purpose)
+    if (gi_events_len == gi_events_capacity) {
+        if (gi_events_capacity >= RAC_INSTRUMENT_TRACE_EVENTS_MAX) {
+            gi_stats.trace_dropped++;
+            rac_instrument_unlock();
+            return;
+        }
+
+        size_t capacity = gi_events_capacity ? 2 * gi_events_capacity : VT_ARRAY_DEFAULT_INIT_ELEMENTS;
+        if (capacity > RAC_INSTRUMENT_TRACE_EVENTS_MAX) capacity = RAC_INSTRUMENT_TRACE_EVENTS_MAX;
+        struct RaccoonInstrumentEvent *events = VT_REALLOC(gi_events, capacity * sizeof(struct RaccoonInstrumentEvent));
+        if (events == NULL) {
+            gi_stats.trace_dropped++;
+            rac_instrument_unlock();
+            return;
+        }
+        gi_events = events;
+        gi_events_capacity = capacity;
+    }
+
+    // record event relative to the first recorded event
+    if (gi_epoch_secs < 0) gi_epoch_secs = start_secs;
+    gi_events[gi_events_len++] = (struct RaccoonInstrumentEvent) {
+        .span = span,
+        .start_secs = start_secs - gi_epoch_secs,
+        .duration_secs = duration_secs,
+    };
+    rac_instrument_unlock();
+}
+
+// -------------------------- PRIVATE -------------------------- //
+
+/**
+ * @brief Returns current time in seconds
+ * @returns ditto
+ */
+static double rac_instrument_time_now_secs(void) {
+    struct timespec ts = {0};
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Acquires the spin lock guarding counters and trace events
+ * @returns None
+ */
+static void rac_instrument_lock(void) {
+    while (atomic_flag_test_and_set_explicit(&gi_lock, memory_order_acquire));
+}
+
+/**
+ * @brief Releases the spin lock guarding counters and trace events
+ * @returns None
+ */
+static void rac_instrument_unlock(void) {
+    atomic_flag_clear_explicit(&gi_lock, memory_order_release);
+}
@@ -0,0 +1,472 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+    #define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdatomic.h>
+#include "raccoon/auxiliary/jit.h"
+#include "raccoon/core/graph.h"
+
+#if !defined(_WIN32)
+    #include <dlfcn.h>
+    #include <unistd.h>
+    #include <sys/wait.h>
+#endif
+
+// bump when the generated code changes, so that stale cached objects are not reused
+#define RAC_JIT_CODEGEN_VERSION 4
+
+// maximum number of compiler command arguments
+#define RAC_JIT_ARGS_MAX 64
+
+#define RAC_JIT_STR(x) RAC_JIT_STR_IMPL(x)
+#define RAC_JIT_STR_IMPL(x) #x
+
+static vt_plist_t *rac_jit_collect(const rac_tape_t *const tape, rac_graph_map_t *const index, size_t *const external_len);
+static bool rac_jit_is_supported(const rac_var_t *const var, const rac_graph_map_t *const index, const size_t slot);
+static uint64_t rac_jit_fnv(uint64_t hash, const void *const bytes, const size_t len);
+static bool rac_jit_emit(const char *const path, const rac_jit_t *const jit, const rac_graph_map_t *const index);
+static bool rac_jit_load(rac_jit_t *const jit, const char *const path);
+static bool rac_jit_build(const char *const cc, const char *const src_path, const char *const out_path);
+
+// makes temporary file names unique across threads of a process
+static atomic_size_t rac_jit_build_counter = 0;
+
+/*
+    JIT creation/destruction
+*/
+
+rac_jit_t *rac_jit_make(const rac_tape_t *const tape, const char *const cache_dir) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(tape != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(cache_dir != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(rac_tape_compiled(tape), "%s\n", "Tape is not compiled! Need to `rac_tape_compile(tape)` first!");
+    if (vt_plist_len(tape->list) == 0) return NULL;
+
+    // index graph nodes and check that every operation can be generated
+    rac_graph_map_t *index = rac_graph_map_make(tape->alloctr, vt_plist_len(tape->list));
+    size_t external_len = 0;
+    vt_plist_t *nodes = rac_jit_collect(tape, index, &external_len);
+    const size_t len = vt_plist_len(nodes);
+    bool supported = true;
+    VT_FOREACH(i, external_len, len) supported = supported && rac_jit_is_supported(vt_plist_get(nodes, i), index, i);
+    if (!supported) {
+        vt_plist_destroy(nodes);
+        rac_graph_map_free(index);
+        return NULL;
+    }
+
+    // allocate jit instance
+    rac_jit_t *jit = (tape->alloctr == NULL)
+        ? VT_CALLOC(sizeof(rac_jit_t))
+        : VT_ALLOCATOR_ALLOC(tape->alloctr, sizeof(rac_jit_t));
+    rac_var_t **slots = (tape->alloctr == NULL)
+        ? VT_CALLOC(len * sizeof(rac_var_t*))
+        : VT_ALLOCATOR_ALLOC(tape->alloctr, len * sizeof(rac_var_t*));
+    rac_float *buffers = (tape->alloctr == NULL)
+        ? VT_CALLOC(2 * len * sizeof(rac_float))
+        : VT_ALLOCATOR_ALLOC(tape->alloctr, 2 * len * sizeof(rac_float));
+
+    // init
+    *jit = (rac_jit_t) {
+        .nodes = slots,
+        .len = len,
+        .external_len = external_len,
+        .data = buffers,
+        .grad = buffers + len,
+        .hash = rac_jit_hash(tape),
+        .alloctr = tape->alloctr,
+    };
+    VT_FOREACH(i, 0, len) jit->nodes[i] = vt_plist_get(nodes, i);
+    vt_plist_destroy(nodes);
+
+    // load from the cache or generate, compile and load
+    char so_path[RAC_JIT_PATH_MAX] = {0}, src_path[RAC_JIT_PATH_MAX] = {0}, tmp_path[RAC_JIT_PATH_MAX] = {0};
+    const int n = snprintf(so_path, sizeof(so_path), "%s/rac_jit_%016" PRIx64 ".so", cache_dir, jit->hash);
+    bool loaded = false;
+    if (n > 0 && (size_t)n < sizeof(so_path)) {
+        jit->cached = loaded = rac_jit_load(jit, so_path);
+    }
+    if (!loaded) {
+        // temporary files are unique per process and thread: concurrent builds never share or load partial files
+        const size_t id = atomic_fetch_add(&rac_jit_build_counter, 1);
+#if defined(_WIN32)
+        const long pid = 0;
+#else
+        const long pid = (long)getpid();
+#endif
+        const int ns = snprintf(src_path, sizeof(src_path), "%s/rac_jit_%016" PRIx64 ".%ld.%zu.c", cache_dir, jit->hash, pid, id);
+        const int nt = snprintf(tmp_path, sizeof(tmp_path), "%s/rac_jit_%016" PRIx64 ".%ld.%zu.so.tmp", cache_dir, jit->hash, pid, id);
+        if (ns > 0 && (size_t)ns < sizeof(src_path) && nt > 0 && (size_t)nt < sizeof(tmp_path) && rac_jit_emit(src_path, jit, index)) {
+            // the object is published with an atomic rename, so other processes only see complete files
+            const char *cc = getenv("RAC_JIT_CC") ? getenv("RAC_JIT_CC") : getenv("CC") ? getenv("CC") : RAC_JIT_CC_DEFAULT;
+            loaded = rac_jit_build(cc, src_path, tmp_path) && rename(tmp_path, so_path) == 0 && rac_jit_load(jit, so_path);
+
+            // remove intermediate files whether the build succeeded or not
+            remove(src_path);
+            remove(tmp_path);
+        }
+    }
+    rac_graph_map_free(index);
+
+    // failed to build native code
+    if (!loaded) {
+        rac_jit_free(jit);
+        return NULL;
+    }
+
+    return jit;
+}
+
+void rac_jit_free(rac_jit_t *jit) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(jit != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // unload
+#if !defined(_WIN32)
+    if (jit->handle) dlclose(jit->handle);
+#endif
+
+    // free buffers and jit instance
+    if (jit->alloctr) {
+        VT_ALLOCATOR_FREE(jit->alloctr, jit->nodes);
+        VT_ALLOCATOR_FREE(jit->alloctr, jit->data);
+        VT_ALLOCATOR_FREE(jit->alloctr, jit);
+    } else {
+        VT_FREE(jit->nodes);
+        VT_FREE(jit->data);
+        VT_FREE(jit);
+    }
+}
+
+/*
+    JIT operations
+*/
+
+void rac_jit_update(rac_jit_t *const jit) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(jit != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // gather inputs
+    VT_FOREACH(i, 0, jit->len) {
+        const rac_var_t *var = jit->nodes[i];
+        if (i < jit->external_len || var->parents[0] == NULL) jit->data[i] = var->data;
+    }
+
+    // run
+    jit->forward(jit->data);
+
+    // scatter results, zero tape gradients
+    VT_FOREACH(i, jit->external_len, jit->len) {
+        rac_var_t *var = jit->nodes[i];
+        if (var->parents[0]) var->data = jit->data[i];
+        var->grad = 0;
+    }
+}
+
+void rac_jit_backward(rac_jit_t *const jit) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(jit != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // gather values and gradients (gradients accumulate like in `rac_var_backward`)
+    VT_FOREACH(i, 0, jit->len) {
+        jit->data[i] = jit->nodes[i]->data;
+        jit->grad[i] = jit->nodes[i]->grad;
+    }
+
+    // base case
+    jit->grad[jit->len-1] = 1;
+
+    // run
+    jit->backward(jit->data, jit->grad);
+
+    // scatter gradients
+    VT_FOREACH(i, 0, jit->len) jit->nodes[i]->grad = jit->grad[i];
+}
+
+uint64_t rac_jit_hash(const rac_tape_t *const tape) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(tape != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // index graph nodes
+    rac_graph_map_t *index = rac_graph_map_make(tape->alloctr, vt_plist_len(tape->list));
+    size_t external_len = 0;
+    vt_plist_t *nodes = rac_jit_collect(tape, index, &external_len);
+    const size_t len = vt_plist_len(nodes);
+
+    // hash codegen version, float type and wiring
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    const uint64_t header[] = { RAC_JIT_CODEGEN_VERSION, sizeof(rac_float), len, external_len };
+    hash = rac_jit_fnv(hash, header, sizeof(header));
+    VT_FOREACH(i, external_len, len) {
+        const rac_var_t *var = vt_plist_get(nodes, i);
+        uint64_t node[1 + RAC_VAR_OPERANDS_LEN] = { (unsigned char)var->op };
+        VT_FOREACH(p, 0, RAC_VAR_OPERANDS_LEN) {
+            size_t slot = SIZE_MAX;
+            rac_graph_map_get(index, rac_var_operand(var, p), &slot);
+            node[1 + p] = slot;
+        }
+        hash = rac_jit_fnv(hash, node, sizeof(node));
+    }
+
+    // free
+    vt_plist_destroy(nodes);
+    rac_graph_map_free(index);
+
+    return hash;
+}
+
+// -------------------------- PRIVATE -------------------------- //
+
+/**
+ * @brief Lists graph nodes: parents missing from the tape first, then tape nodes
+ * @param tape tape instance
+ * @param index filled with node -> slot
+ * @param external_len number of parents missing from the tape
+ * @returns node list
+ */
+static vt_plist_t *rac_jit_collect(const rac_tape_t *const tape, rac_graph_map_t *const index, size_t *const external_len) {
+    const size_t len = vt_plist_len(tape->list);
+
+    // mark tape nodes
+    rac_graph_map_t *taped = rac_graph_map_make(tape->alloctr, len);
+    VT_FOREACH(i, 0, len) rac_graph_map_set(taped, vt_plist_get(tape->list, i), i);
+
+    // external parents
+    vt_plist_t *nodes = vt_plist_create(len + 1, tape->alloctr);
+    VT_FOREACH(i, 0, len) {
+        const rac_var_t *var = vt_plist_get(tape->list, i);
+        VT_FOREACH(p, 0, RAC_VAR_OPERANDS_LEN) {
+            rac_var_t *parent = rac_var_operand(var, p);
+            if (parent == NULL || rac_graph_map_get(taped, parent, NULL) || rac_graph_map_get(index, parent, NULL)) continue;
+            rac_graph_map_set(index, parent, vt_plist_len(nodes));
+            vt_plist_push_back(nodes, parent);
+        }
+    }
+    *external_len = vt_plist_len(nodes);
+
+    // tape nodes
+    VT_FOREACH(i, 0, len) {
+        rac_var_t *var = vt_plist_get(tape->list, i);
+        rac_graph_map_set(index, var, vt_plist_len(nodes));
+        vt_plist_push_back(nodes, var);
+    }
+    rac_graph_map_free(taped);
+
+    return nodes;
+}
+
+/**
+ * @brief Checks if code can be generated for a tape node
+ * @param var tape node
+ * @param index node -> slot
+ * @param slot node slot
+ * @returns `true` for leaves and known operations whose parents precede the node
+ */
+static bool rac_jit_is_supported(const rac_var_t *const var, const rac_graph_map_t *const index, const size_t slot) {
+    // leaves are inputs (dot products have no parents but depend on their weights)
+    if (var->op != 'd' && var->parents[0] == NULL && var->parents[1] == NULL && rac_var_operand(var, 2) == NULL) return true;
+
+    // known operations
+    size_t required = 0;
+    switch (var->op) {
+        case '+': case '-': case '*': case '/': case 'q': required = 2; break;
+        case 'f': case 'a': required = 3; break;
+        default: return false;
+    }
+
+    // operands are computed before the node
+    VT_FOREACH(p, 0, RAC_VAR_OPERANDS_LEN) {
+        size_t parent_slot = 0;
+        const bool present = rac_graph_map_get(index, rac_var_operand(var, p), &parent_slot);
+        if (present != (p < required)) return false;
+        if (present && parent_slot >= slot) return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief FNV-1a hash step
+ * @param hash current hash
+ * @param bytes data
+ * @param len number of bytes
+ * @returns updated hash
+ */
+static uint64_t rac_jit_fnv(uint64_t hash, const void *const bytes, const size_t len) {
+    const unsigned char *b = bytes;
+    VT_FOREACH(i, 0, len) {
+        hash ^= b[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Writes C source with straight-line forward and backward functions
+ * @param path output file
+ * @param jit jit instance with filled nodes
+ * @param index node -> slot
+ * @returns `true` on success
+ * @note Backward visits nodes in reverse tape order with the rules of `rac_var_backward`.
+ */
+static bool rac_jit_emit(const char *const path, const rac_jit_t *const jit, const rac_graph_map_t *const index) {
+    // exclusive create: never write into a file that belongs to another build
+    FILE *fp = fopen(path, "wx");
+    if (fp == NULL) return false;
+
+    // header
+    fprintf(fp, "/* generated by raccoon: %zu nodes */\n", jit->len);
+    fprintf(fp, "#include <math.h>\n");
+    fprintf(fp, "typedef %s rac_float;\n\n", RAC_JIT_STR(RAC_FLOAT));
+
+    // forward
+    fprintf(fp, "void rac_jit_forward(rac_float *const d) {\n");
+    VT_FOREACH(i, jit->external_len, jit->len) {
+        const rac_var_t *var = jit->nodes[i];
+        if (var->parents[0] == NULL) continue;
+        size_t a = 0, b = 0, c = 0;
+        rac_graph_map_get(index, var->parents[0], &a);
+        rac_graph_map_get(index, var->parents[1], &b);
+        rac_graph_map_get(index, rac_var_operand(var, 2), &c);
+        switch (var->op) {
+            case '+': case '-': case '*': case '/':
+                fprintf(fp, "    d[%zu] = d[%zu] %c d[%zu];\n", i, a, var->op, b);
+                break;
+            case 'f':
+                fprintf(fp, "    d[%zu] = %s(d[%zu], d[%zu], d[%zu]);\n", i, RAC_JIT_STR(RAC_FMA), a, b, c);
+                break;
+            case 'q':
+                fprintf(fp, "    d[%zu] = (d[%zu] - d[%zu]) * (d[%zu] - d[%zu]);\n", i, a, b, a, b);
+                break;
+            case 'a':
+                fprintf(fp, "    d[%zu] = %s(d[%zu] - d[%zu], d[%zu] - d[%zu], d[%zu]);\n", i, RAC_JIT_STR(RAC_FMA), a, b, a, b, c);
+                break;
+            default: break;
+        }
+    }
+    fprintf(fp, "}\n\n");
+
+    // backward
+    fprintf(fp, "void rac_jit_backward(const rac_float *const d, rac_float *const g) {\n");
+    fprintf(fp, "    rac_float t = 0; (void)t;\n");
+    for (size_t i = jit->len; i-- > jit->external_len;) {
+        const rac_var_t *var = jit->nodes[i];
+        if (var->parents[0] == NULL) continue;
+        size_t a = 0, b = 0, c = 0;
+        rac_graph_map_get(index, var->parents[0], &a);
+        rac_graph_map_get(index, var->parents[1], &b);
+        rac_graph_map_get(index, rac_var_operand(var, 2), &c);
+        switch (var->op) {
+            case '+':
+                fprintf(fp, "    g[%zu] += g[%zu]; g[%zu] += g[%zu];\n", a, i, b, i);
+                break;
+            case '-':
+                fprintf(fp, "    g[%zu] += g[%zu]; g[%zu] -= g[%zu];\n", a, i, b, i);
+                break;
+            case '*':
+                fprintf(fp, "    g[%zu] += d[%zu] * g[%zu]; g[%zu] += d[%zu] * g[%zu];\n", a, b, i, b, a, i);
+                break;
+            case '/':
+                fprintf(fp, "    t = g[%zu] / d[%zu]; g[%zu] += t; g[%zu] -= t * d[%zu] / d[%zu];\n", i, b, a, b, a, b);
+                break;
+            case 'f':
+                fprintf(fp, "    g[%zu] += d[%zu] * g[%zu]; g[%zu] += d[%zu] * g[%zu]; g[%zu] += g[%zu];\n", a, b, i, b, a, i, c, i);
+                break;
+            case 'q': case 'a':
+                fprintf(fp, "    t = 2 * (d[%zu] - d[%zu]) * g[%zu]; g[%zu] += t; g[%zu] -= t;\n", a, b, i, a, b);
+                if (var->op == 'a') fprintf(fp, "    g[%zu] += g[%zu];\n", c, i);
+                break;
+            default: break;
+        }
+    }
+    fprintf(fp, "}\n");
+
+    return fclose(fp) == 0;
+}
+
+/**
+ * @brief Loads a shared object and resolves entry points
+ * @param jit jit instance
+ * @param path shared object path
+ * @returns `true` on success
+ */
+static bool rac_jit_load(rac_jit_t *const jit, const char *const path) {
+#if defined(_WIN32)
+    (void)jit;
+    (void)path;
+    return false;
+#else
+    // open
+    void *handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    if (handle == NULL) return false;
+
+    // resolve (copied through memcpy: ISO C does not convert object pointers to function pointers)
+    void *forward = dlsym(handle, "rac_jit_forward");
+    void *backward = dlsym(handle, "rac_jit_backward");
+    if (forward == NULL || backward == NULL) {
+        dlclose(handle);
+        return false;
+    }
+    memcpy(&jit->forward, &forward, sizeof(forward));
+    memcpy(&jit->backward, &backward, sizeof(backward));
+    jit->handle = handle;
+
+    return true;
+#endif
+}
+
+
+/**
+ * @brief Compiles a source file into a shared object without going through a shell
+ * @param cc compiler command; whitespace separates the program from its leading arguments (e.g. `ccache cc`)
+ * @param src_path source file
+ * @param out_path output shared object
+ * @returns `true` if the compiler ran and exited with status 0
+ * @note Arguments are passed to `execvp` as-is, so paths and the compiler command are never interpreted by a shell.
+ */
+static bool rac_jit_build(const char *const cc, const char *const src_path, const char *const out_path) {
+#if defined(_WIN32)
+    (void)cc;
+    (void)src_path;
+    (void)out_path;
+    return false;
+#else
+    // split the compiler command and flags into words
+    char words[2 * RAC_JIT_PATH_MAX] = {0};
+    const int n = snprintf(words, sizeof(words), "%s %s", cc, RAC_JIT_CFLAGS);
+    if (n <= 0 || (size_t)n >= sizeof(words)) return false;
+    char *argv[RAC_JIT_ARGS_MAX] = {0};
+    size_t argc = 0;
+    for (char *w = words; *w != '\0';) {
+        while (*w == ' ' || *w == '\t') *w++ = '\0';
+        if (*w == '\0') break;
+        if (argc + 5 >= RAC_JIT_ARGS_MAX) return false;
+        argv[argc++] = w;
+        while (*w != '\0' && *w != ' ' && *w != '\t') w++;
+    }
+    if (argc == 0) return false;
+
+    // output, input and libraries
+    argv[argc++] = "-o";
+    argv[argc++] = (char*)out_path;
+    argv[argc++] = (char*)src_path;
+    argv[argc++] = "-lm";
+    argv[argc] = NULL;
+
+    // run the compiler and wait for it
+    const pid_t pid = fork();
+    if (pid < 0) return false;
+    if (pid == 0) {
+        execvp(argv[0], argv);
+        _exit(127);
+    }
+    int status = 0;
+    while (waitpid(pid, &status, 0) < 0) {
+        if (errno != EINTR) return false;
+    }
+
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+#endif
+}
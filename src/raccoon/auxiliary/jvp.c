@@ -0,0 +1,129 @@
+#include "raccoon/auxiliary/jvp.h"
+
+/*
+    JVP creation/destruction
+*/
+
+rac_jvp_t *rac_jvp_make(struct VitaBaseAllocatorType *const alloctr, const vt_plist_t *const outputs) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(outputs != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // order nodes, every operation must have a derivative rule
+    vt_plist_t *nodes = rac_graph_topo_sort_list(outputs);
+    const size_t len = vt_plist_len(nodes);
+    VT_FOREACH(i, 0, len) {
+        const rac_var_t *var = vt_plist_get(nodes, i);
+        VT_ENFORCE(var->op != 'd', "%s\n", "Dot products keep their weights outside of the graph! Use variable inputs (`rac_mlp_forward`) instead!");
+        VT_ENFORCE(rac_var_has_rule(var), "Operation '%c' has no derivative rule! Register it with `rac_var_register_op`!\n", var->op);
+    }
+    rac_graph_map_t *index = rac_graph_map_make(alloctr, len);
+    VT_FOREACH(i, 0, len) rac_graph_map_set(index, vt_plist_get(nodes, i), i);
+
+    // allocate jvp instance
+    rac_jvp_t *jvp = (alloctr == NULL)
+        ? VT_CALLOC(sizeof(rac_jvp_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, sizeof(rac_jvp_t));
+    size_t *parents = (alloctr == NULL)
+        ? VT_CALLOC(len * RAC_VAR_OPERANDS_LEN * sizeof(size_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, len * RAC_VAR_OPERANDS_LEN * sizeof(size_t));
+    rac_float *tangents = (alloctr == NULL)
+        ? VT_CALLOC(len * sizeof(rac_float))
+        : VT_ALLOCATOR_ALLOC(alloctr, len * sizeof(rac_float));
+
+    // resolve operand positions once, so that the sweep does no lookups
+    VT_FOREACH(i, 0, len) {
+        const rac_var_t *var = vt_plist_get(nodes, i);
+        VT_FOREACH(p, 0, RAC_VAR_OPERANDS_LEN) {
+            const rac_var_t *operand = rac_var_operand(var, p);
+            if (operand) rac_graph_map_get(index, operand, &parents[i * RAC_VAR_OPERANDS_LEN + p]);
+        }
+    }
+
+    // init
+    *jvp = (rac_jvp_t) {
+        .nodes = nodes,
+        .index = index,
+        .parents = parents,
+        .tangents = tangents,
+        .alloctr = alloctr,
+    };
+
+    return jvp;
+}
+
+rac_jvp_t *rac_jvp_make_tape(const rac_tape_t *const tape) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(tape != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    return rac_jvp_make(tape->alloctr, tape->list);
+}
+
+void rac_jvp_free(rac_jvp_t *jvp) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(jvp != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // free node list, index and arrays
+    vt_plist_destroy(jvp->nodes);
+    rac_graph_map_free(jvp->index);
+    if (jvp->alloctr) {
+        VT_ALLOCATOR_FREE(jvp->alloctr, jvp->parents);
+        VT_ALLOCATOR_FREE(jvp->alloctr, jvp->tangents);
+        VT_ALLOCATOR_FREE(jvp->alloctr, jvp);
+    } else {
+        VT_FREE(jvp->parents);
+        VT_FREE(jvp->tangents);
+        VT_FREE(jvp);
+    }
+}
+
+/*
+    JVP operations
+*/
+
+void rac_jvp_zero(rac_jvp_t *const jvp) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(jvp != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_FOREACH(i, 0, vt_plist_len(jvp->nodes)) jvp->tangents[i] = 0;
+}
+
+void rac_jvp_seed(rac_jvp_t *const jvp, const rac_var_t *const var, const rac_float tangent) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(jvp != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(var != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // find node
+    size_t idx = 0;
+    VT_ENFORCE(rac_graph_map_get(jvp->index, var, &idx), "%s\n", rac_status_to_str(RAC_STATUS_ERROR_OUT_OF_BOUNDS_ACCESS));
+    jvp->tangents[idx] = tangent;
+}
+
+void rac_jvp_forward(rac_jvp_t *const jvp) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(jvp != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // parents come first: leaves keep their seeded tangents, operations combine their parents'
+    const size_t len = vt_plist_len(jvp->nodes);
+    rac_float partials[RAC_VAR_OPERANDS_LEN] = {0};
+    VT_FOREACH(i, 0, len) {
+        rac_var_t *var = vt_plist_get(jvp->nodes, i);
+        if (var->parents[0] == NULL && var->parents[1] == NULL) continue;
+        rac_var_update(var);
+
+        // tangent = sum(d(var)/d(operand) * tangent(operand))
+        const size_t operands_len = rac_var_partials(var, partials);
+        rac_float tangent = 0;
+        VT_FOREACH(p, 0, operands_len) tangent += partials[p] * jvp->tangents[jvp->parents[i * RAC_VAR_OPERANDS_LEN + p]];
+        jvp->tangents[i] = tangent;
+    }
+}
+
+rac_float rac_jvp_tangent(const rac_jvp_t *const jvp, const rac_var_t *const var) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(jvp != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(var != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // find node
+    size_t idx = 0;
+    VT_ENFORCE(rac_graph_map_get(jvp->index, var, &idx), "%s\n", rac_status_to_str(RAC_STATUS_ERROR_OUT_OF_BOUNDS_ACCESS));
+    return jvp->tangents[idx];
+}
+
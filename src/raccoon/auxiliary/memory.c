@@ -0,0 +1,135 @@
+#include "raccoon/auxiliary/memory.h"
+
+static size_t rac_memory_plist_bytes(const vt_plist_t *const list);
+static size_t rac_memory_nodes_bytes(const vt_plist_t *const list);
+
+/*
+    Reports
+*/
+
+struct RaccoonMemoryReport rac_memory_report(const rac_mlp_t *const mlp) {
+    const struct RaccoonCounterStats stats = rac_counter_get_stats();
+    struct RaccoonMemoryReport report = {
+        .leaves = stats.leaves,
+        .intermediates = stats.intermediates,
+        .bytes_nodes = stats.bytes,
+        .peak_nodes = stats.peak_nodes,
+        .peak_bytes = stats.peak_bytes,
+    };
+
+    // attribute bytes to the model
+    if (mlp) {
+        const size_t layers_len = vt_plist_len(mlp->layers);
+        VT_FOREACH(i, 0, layers_len) {
+            const rac_layer_t *layer = vt_plist_get(mlp->layers, i);
+            const size_t neurons_len = vt_plist_len(layer->neurons);
+            VT_FOREACH(j, 0, neurons_len) {
+                const rac_neuron_t *neuron = vt_plist_get(layer->neurons, j);
+                report.cached += vt_plist_len(neuron->cache);
+                report.bytes_cache += rac_memory_neuron_cache_bytes(neuron);
+                report.bytes_params += rac_memory_nodes_bytes(neuron->params) + rac_memory_plist_bytes(neuron->params);
+            }
+        }
+        report.bytes_total = rac_memory_mlp_bytes(mlp);
+    }
+
+    return report;
+}
+
+void rac_memory_print_report(const rac_mlp_t *const mlp) {
+    const struct RaccoonMemoryReport report = rac_memory_report(mlp);
+    printf("nodes: %zu leaves, %zu intermediates (%zu bytes), %zu cached\n", report.leaves, report.intermediates, report.bytes_nodes, report.cached);
+    printf("peak: %zu nodes (%zu bytes)\n", report.peak_nodes, report.peak_bytes);
+    if (mlp == NULL) return;
+
+    // per-layer breakdown
+    printf("model: %zu bytes (params %zu, cache %zu)\n", report.bytes_total, report.bytes_params, report.bytes_cache);
+    const size_t layers_len = vt_plist_len(mlp->layers);
+    VT_FOREACH(i, 0, layers_len) {
+        const rac_layer_t *layer = vt_plist_get(mlp->layers, i);
+        size_t cached = 0, bytes_cache = 0;
+        const size_t neurons_len = vt_plist_len(layer->neurons);
+        VT_FOREACH(j, 0, neurons_len) {
+            const rac_neuron_t *neuron = vt_plist_get(layer->neurons, j);
+            cached += vt_plist_len(neuron->cache);
+            bytes_cache += rac_memory_neuron_cache_bytes(neuron);
+        }
+        printf("    layer %zu: %zu bytes, %zu neurons, %zu cached nodes (%zu bytes)\n", i, rac_memory_layer_bytes(layer), neurons_len, cached, bytes_cache);
+    }
+}
+
+void rac_memory_step_begin(void) {
+    rac_counter_step_begin();
+}
+
+/*
+    Bytes attributed to objects
+*/
+
+size_t rac_memory_neuron_cache_bytes(const rac_neuron_t *const neuron) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(neuron != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    return rac_memory_nodes_bytes(neuron->cache) + rac_memory_plist_bytes(neuron->cache);
+}
+
+size_t rac_memory_neuron_bytes(const rac_neuron_t *const neuron) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(neuron != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    return sizeof(rac_neuron_t)
+        + rac_memory_nodes_bytes(neuron->params) + rac_memory_plist_bytes(neuron->params)
+        + rac_memory_neuron_cache_bytes(neuron)
+        + (neuron->tape ? rac_memory_tape_bytes(neuron->tape) : 0);
+}
+
+size_t rac_memory_layer_bytes(const rac_layer_t *const layer) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(layer != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // neurons
+    size_t bytes = sizeof(rac_layer_t) + rac_memory_plist_bytes(layer->neurons) + rac_memory_plist_bytes(layer->last_prediction);
+    const size_t neurons_len = vt_plist_len(layer->neurons);
+    VT_FOREACH(i, 0, neurons_len) bytes += rac_memory_neuron_bytes(vt_plist_get(layer->neurons, i));
+
+    return bytes;
+}
+
+size_t rac_memory_mlp_bytes(const rac_mlp_t *const mlp) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(mlp != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // layers
+    size_t bytes = sizeof(rac_mlp_t) + rac_memory_plist_bytes(mlp->layers);
+    const size_t layers_len = vt_plist_len(mlp->layers);
+    VT_FOREACH(i, 0, layers_len) bytes += rac_memory_layer_bytes(vt_plist_get(mlp->layers, i));
+
+    return bytes;
+}
+
+size_t rac_memory_tape_bytes(const rac_tape_t *const tape) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(tape != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    return sizeof(rac_tape_t) + rac_memory_nodes_bytes(tape->list) + rac_memory_plist_bytes(tape->list);
+}
+
+// -------------------------- PRIVATE -------------------------- //
+
+/**
+ * @brief Bytes held by the list storage
+ * @param list pointer list
+ * @returns number of bytes
+ */
+static size_t rac_memory_plist_bytes(const vt_plist_t *const list) {
+    return vt_plist_capacity(list) * sizeof(void*);
+}
+
+/**
+ * @brief Bytes allocated for the nodes of a list
+ * @param list node list
+ * @returns number of bytes
+ */
+static size_t rac_memory_nodes_bytes(const vt_plist_t *const list) {
+    size_t bytes = 0;
+    const size_t len = vt_plist_len(list);
+    VT_FOREACH(i, 0, len) bytes += rac_var_bytes(vt_plist_get(list, i));
+    return bytes;
+}
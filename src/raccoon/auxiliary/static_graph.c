@@ -0,0 +1,85 @@
+#include "raccoon/auxiliary/static_graph.h"
+#include "raccoon/auxiliary/instrument.h"
+
+/*
+    Static graph creation/destruction
+*/
+
+rac_static_graph_t *rac_static_graph_make(struct VitaBaseAllocatorType *const alloctr, rac_var_t *const root) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(root != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // order nodes once
+    vt_plist_t *nodes = rac_graph_topo_sort(root);
+    vt_plist_t *placeholders = vt_plist_create(VT_ARRAY_DEFAULT_INIT_ELEMENTS, alloctr);
+    VT_FOREACH(i, 0, vt_plist_len(nodes)) {
+        rac_var_t *var = vt_plist_get(nodes, i);
+        VT_ENFORCE(var->op == 'd' || rac_var_has_rule(var), "Operation '%c' cannot be recomputed! Register it with `rac_var_register_op`!\n", var->op);
+        if (var->flags & RAC_VAR_FLAG_PLACEHOLDER) vt_plist_push_back(placeholders, var);
+    }
+
+    // allocate static graph instance
+    rac_static_graph_t *graph = (alloctr == NULL)
+        ? VT_CALLOC(sizeof(rac_static_graph_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, sizeof(rac_static_graph_t));
+
+    // init
+    *graph = (rac_static_graph_t) {
+        .root = root,
+        .nodes = nodes,
+        .placeholders = placeholders,
+        .alloctr = alloctr,
+    };
+
+    return graph;
+}
+
+void rac_static_graph_free(rac_static_graph_t *graph) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(graph != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // free lists and instance
+    vt_plist_destroy(graph->nodes);
+    vt_plist_destroy(graph->placeholders);
+    (graph->alloctr) ? VT_ALLOCATOR_FREE(graph->alloctr, graph) : VT_FREE(graph);
+}
+
+/*
+    Static graph operations
+*/
+
+rac_float rac_static_graph_forward(rac_static_graph_t *const graph) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(graph != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // parents before consumers: recompute in place (leaves only have their gradients zeroed)
+    const size_t len = vt_plist_len(graph->nodes);
+    VT_FOREACH(i, 0, len) rac_var_update(vt_plist_get(graph->nodes, i));
+
+    return graph->root->data;
+}
+
+void rac_static_graph_backward(rac_static_graph_t *const graph) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(graph != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    RAC_INSTRUMENT_SPAN_BEGIN(backward);
+
+    // base case
+    graph->root->grad = 1;
+
+    // consumers before the nodes they use
+    const size_t len = vt_plist_len(graph->nodes);
+    for (size_t i = len; i-- > 0;) {
+        rac_var_t *node = vt_plist_get(graph->nodes, i);
+        if (node->backward) node->backward(node);
+    }
+    RAC_INSTRUMENT_BACKWARD(len);
+    RAC_INSTRUMENT_SPAN_END(backward, RAC_INSTRUMENT_SPAN_BACKWARD);
+}
+
+rac_float rac_static_graph_step(rac_static_graph_t *const graph) {
+    const rac_float value = rac_static_graph_forward(graph);
+    rac_static_graph_backward(graph);
+    return value;
+}
+
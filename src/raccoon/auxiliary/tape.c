@@ -1,4 +1,15 @@
 #include "raccoon/auxiliary/tape.h"
+#include "raccoon/auxiliary/instrument.h"
+
+static bool rac_tape_is_op_node(const rac_var_t *const var);
+static void rac_tape_pass_fold(rac_tape_t *const tape);
+static void rac_tape_pass_cse(rac_tape_t *const tape);
+static void rac_tape_pass_dce(rac_tape_t *const tape);
+static void rac_tape_pass_fuse(rac_tape_t *const tape);
+static void rac_tape_levels_build(rac_tape_t *const tape);
+static void rac_tape_levels_free(rac_tape_t *const tape);
+static void rac_tape_dependents_build(rac_tape_t *const tape);
+static void rac_tape_dependents_free(rac_tape_t *const tape);
 
 /* 
     Tape creation/destruction
@@ -9,11 +20,13 @@ rac_tape_t *rac_tape_make(struct VitaBaseAllocatorType *const alloctr) {
     rac_tape_t *tape = (alloctr == NULL)
         ? VT_CALLOC(sizeof(rac_tape_t))
         : VT_ALLOCATOR_ALLOC(alloctr, sizeof(rac_tape_t));
+    RAC_INSTRUMENT_ALLOC(sizeof(rac_tape_t));
     
     // init
     *tape = (rac_tape_t) {
         .list = vt_plist_create(VT_ARRAY_DEFAULT_INIT_ELEMENTS, alloctr),
         .alloctr = alloctr,
+        .pruned = vt_plist_create(VT_ARRAY_DEFAULT_INIT_ELEMENTS, alloctr),
     };
 
     return tape;
@@ -24,16 +37,15 @@ void rac_tape_free(rac_tape_t *tape) {
     VT_DEBUG_ASSERT(tape != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
 
     // free list elements
-    rac_var_t *tmp = NULL;
-    while ((tmp = vt_plist_pop_get(tape->list)) != NULL) {
-        rac_var_free(tmp);
-    }
+    rac_tape_reset(tape);
 
     // free list
     vt_plist_destroy(tape->list);
+    vt_plist_destroy(tape->pruned);
 
     // free tape
     (tape->alloctr) ? VT_ALLOCATOR_FREE(tape->alloctr, tape) : VT_FREE(tape);
+    RAC_INSTRUMENT_FREE();
 }
 
 /* 
@@ -49,8 +61,13 @@ void rac_tape_reset(rac_tape_t *const tape) {
     while ((tmp = vt_plist_pop_get(tape->list)) != NULL) {
         rac_var_free(tmp);
     }
+    while ((tmp = vt_plist_pop_get(tape->pruned)) != NULL) {
+        rac_var_free(tmp);
+    }
 
     // unlock
+    rac_tape_levels_free(tape);
+    rac_tape_dependents_free(tape);
     tape->locked = false;
 }
 
@@ -58,13 +75,69 @@ void rac_tape_update(rac_tape_t *const tape) {
     // check for invalid input
     VT_DEBUG_ASSERT(tape != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
 
-    // update
-    rac_var_t *tmp = NULL;
-    while ((tmp = vt_plist_slide_front(tape->list)) != NULL) {
-        rac_var_update(tmp);
+    // not compiled: in push order
+    if (tape->levels == NULL) {
+        rac_var_t *tmp = NULL;
+        while ((tmp = vt_plist_slide_front(tape->list)) != NULL) {
+            rac_var_update(tmp);
+        }
+        return;
+    }
+
+    // compiled: level by level (implicit barrier), nodes within a level are split between threads
+#if defined(_OPENMP)
+    #pragma omp parallel if(tape->width >= RAC_TAPE_PARALLEL_MIN)
+#endif
+    for (size_t l = 0; l < tape->levels_len; l++) {
+        const size_t begin = tape->level_offsets[l], end = tape->level_offsets[l + 1];
+#if defined(_OPENMP)
+        #pragma omp for schedule(static)
+#endif
+        for (size_t k = begin; k < end; k++) rac_var_update(vt_plist_get(tape->list, tape->levels[k]));
     }
 }
 
+void rac_tape_mark_changed(rac_tape_t *const tape, const rac_var_t *const var) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(tape != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(var != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(tape->locked, "%s\n", "Tape is not compiled! Need to `rac_tape_compile(tape)` first!");
+    if (tape->index == NULL) return; // whole tape is replayed
+
+    // tape nodes are recomputed themselves, inputs that are not on the tape mark their consumers
+    size_t id = 0;
+    if (!rac_graph_map_get(tape->index, var, &id)) return;
+    const size_t len = vt_plist_len(tape->list);
+    if (id < len) {
+        tape->changed[id] = true;
+    } else {
+        VT_FOREACH(e, tape->consumer_offsets[id], tape->consumer_offsets[id + 1]) tape->changed[tape->consumers[e]] = true;
+    }
+}
+
+size_t rac_tape_update_changed(rac_tape_t *const tape) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(tape != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(tape->locked, "%s\n", "Tape is not compiled! Need to `rac_tape_compile(tape)` first!");
+    const size_t len = vt_plist_len(tape->list);
+    if (tape->index == NULL) {
+        rac_tape_update(tape);
+        return len;
+    }
+
+    // consumers come after the nodes they use, so one pass in tape order reaches every dependent
+    size_t updated = 0;
+    VT_FOREACH(i, 0, len) {
+        if (!tape->changed[i]) continue;
+        tape->changed[i] = false;
+        rac_var_update(vt_plist_get(tape->list, i));
+        VT_FOREACH(e, tape->consumer_offsets[i], tape->consumer_offsets[i + 1]) tape->changed[tape->consumers[e]] = true;
+        updated++;
+    }
+
+    return updated;
+}
+
 void rac_tape_push(rac_tape_t *const tape, const rac_var_t *const var) {
     // check for invalid input
     VT_DEBUG_ASSERT(tape != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
@@ -117,8 +190,27 @@ rac_var_t *rac_tape_last(const rac_tape_t *const tape) {
 }
 
 void rac_tape_compile(rac_tape_t *const tape) {
+    rac_tape_compile_ex(tape, RAC_TAPE_OPTIMIZE_DEFAULT);
+}
+
+void rac_tape_compile_ex(rac_tape_t *const tape, const int passes) {
     // check for invalid input
     VT_DEBUG_ASSERT(tape != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(!tape->locked, "%s\n", "Tape is already compiled! Need to `rac_tape_reset(tape)` first!");
+
+    // optimize
+    if (vt_plist_len(tape->list)) {
+        if (passes & RAC_TAPE_OPTIMIZE_FOLD) rac_tape_pass_fold(tape);
+        if (passes & RAC_TAPE_OPTIMIZE_CSE) rac_tape_pass_cse(tape);
+        if (passes & RAC_TAPE_OPTIMIZE_FUSE) rac_tape_pass_fuse(tape);
+        if (passes & RAC_TAPE_OPTIMIZE_DCE) rac_tape_pass_dce(tape);
+    }
+
+    // replay schedule and dependents
+    rac_tape_levels_build(tape);
+    rac_tape_dependents_build(tape);
+
+    // lock
     tape->locked = true;
 }
 
@@ -128,3 +220,355 @@ bool rac_tape_compiled(const rac_tape_t *const tape) {
     return tape->locked;
 }
 
+
+// -------------------------- PRIVATE -------------------------- //
+
+/**
+ * @brief Checks if variable is a result of a basic `{ +, -, *, / }` or fused `{ f, q, a }` operation
+ * @param var variable instance
+ * @returns ditto
+ */
+static bool rac_tape_is_op_node(const rac_var_t *const var) {
+    if (var->parents[0] == NULL || var->parents[1] == NULL) return false;
+    switch (var->op) {
+        case '+': case '-': case '*': case '/': return true;
+        case 'q': return true;
+        case 'f': case 'a': return rac_var_operand(var, 2) != NULL;
+        default: return false;
+    }
+}
+
+/**
+ * @brief Constant folding: turns nodes with constant parents into constants
+ * @param tape tape instance
+ * @returns None
+ */
+static void rac_tape_pass_fold(rac_tape_t *const tape) {
+    const size_t len = vt_plist_len(tape->list);
+    VT_FOREACH(i, 0, len) {
+        rac_var_t *var = vt_plist_get(tape->list, i);
+        if (!rac_tape_is_op_node(var)) continue;
+        if (!(var->parents[0]->flags & RAC_VAR_FLAG_CONST) || !(var->parents[1]->flags & RAC_VAR_FLAG_CONST)) continue;
+        const rac_var_t *acc = rac_var_operand(var, 2);
+        if (acc && !(acc->flags & RAC_VAR_FLAG_CONST)) continue;
+
+        // compute value and detach from parents
+        rac_var_update(var);
+        rac_var_remake(var, var->data, 0, NULL, NULL);
+        var->flags |= RAC_VAR_FLAG_CONST;
+    }
+}
+
+/**
+ * @brief Common subexpression elimination: rewires consumers of duplicate nodes to the first occurrence
+ * @param tape tape instance
+ * @returns None
+ */
+static void rac_tape_pass_cse(rac_tape_t *const tape) {
+    const size_t len = vt_plist_len(tape->list);
+
+    // signature hash -> last tape index with that hash; `next` chains earlier indices with the same hash
+    rac_graph_map_t *table = rac_graph_map_make(tape->alloctr, len);
+    size_t *next = (tape->alloctr == NULL)
+        ? VT_CALLOC(len * sizeof(size_t))
+        : VT_ALLOCATOR_ALLOC(tape->alloctr, len * sizeof(size_t));
+
+    // duplicate -> first occurrence
+    rac_graph_map_t *replaced = rac_graph_map_make(tape->alloctr, 0);
+    VT_FOREACH(i, 0, len) {
+        rac_var_t *var = vt_plist_get(tape->list, i);
+
+        // rewire operands that were deduplicated
+        size_t idx = 0;
+        VT_FOREACH(p, 0, RAC_VAR_PARENTS_LEN) {
+            if (rac_graph_map_get(replaced, var->parents[p], &idx)) var->parents[p] = vt_plist_get(tape->list, idx);
+        }
+        if ((var->flags & RAC_VAR_FLAG_FUSED) && rac_graph_map_get(replaced, ((rac_var_fused_t*)var)->acc, &idx)) {
+            ((rac_var_fused_t*)var)->acc = vt_plist_get(tape->list, idx);
+        }
+        if (!rac_tape_is_op_node(var)) continue;
+
+        // signature: commutative operations are order-independent
+        const rac_var_t *lhs = var->parents[0], *rhs = var->parents[1];
+        const rac_var_t *acc = rac_var_operand(var, 2);
+        const bool commutative = var->op == '+' || var->op == '*' || var->op == 'f';
+        if (commutative && (uintptr_t)lhs > (uintptr_t)rhs) {
+            const rac_var_t *tmp = lhs; lhs = rhs; rhs = tmp;
+        }
+        uint64_t hash = (uint64_t)(uintptr_t)lhs * 0x9e3779b97f4a7c15ULL;
+        hash ^= (uint64_t)(uintptr_t)rhs + 0x7f4a7c159e3779b9ULL + (hash << 6) + (hash >> 2);
+        hash ^= (uint64_t)(uintptr_t)acc * 0x94d049bb133111ebULL;
+        hash ^= (uint64_t)(unsigned char)var->op * 0xbf58476d1ce4e5b9ULL;
+        hash ^= hash >> 31;
+        const void *key = (const void*)(uintptr_t)(hash | 1); // map keys are non-NULL
+
+        // walk nodes with the same hash
+        size_t head = 0;
+        const bool has_head = rac_graph_map_get(table, key, &head);
+        size_t first = len;
+        for (size_t j = head; has_head && j != len; j = next[j]) {
+            const rac_var_t *other = vt_plist_get(tape->list, j);
+            const bool same_order = other->parents[0] == lhs && other->parents[1] == rhs;
+            const bool swapped = other->parents[0] == rhs && other->parents[1] == lhs && commutative;
+            if (other->op == var->op && rac_var_operand(other, 2) == acc && (same_order || swapped)) first = j;
+        }
+
+        // the output itself is never replaced
+        if (first != len && i + 1 != len) {
+            rac_graph_map_set(replaced, var, first);
+        } else if (first == len) {
+            next[i] = has_head ? head : len;
+            rac_graph_map_set(table, key, i);
+        }
+    }
+
+    // free
+    rac_graph_map_free(replaced);
+    rac_graph_map_free(table);
+    (tape->alloctr) ? VT_ALLOCATOR_FREE(tape->alloctr, next) : VT_FREE(next);
+}
+
+/**
+ * @brief Dead node elimination: moves nodes that do not reach the output to `tape->pruned`
+ * @param tape tape instance
+ * @returns None
+ */
+static void rac_tape_pass_dce(rac_tape_t *const tape) {
+    const size_t len = vt_plist_len(tape->list);
+
+    // index nodes
+    rac_graph_map_t *index = rac_graph_map_make(tape->alloctr, len);
+    VT_FOREACH(i, 0, len) rac_graph_map_set(index, vt_plist_get(tape->list, i), i);
+
+    // mark nodes reaching the output
+    bool *live = (tape->alloctr == NULL)
+        ? VT_CALLOC(len * sizeof(bool))
+        : VT_ALLOCATOR_ALLOC(tape->alloctr, len * sizeof(bool));
+    VT_ENFORCE(live != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_ALLOCATION));
+    memset(live, 0, len * sizeof(bool));
+    live[len-1] = true;
+    for (size_t i = len; i-- > 0;) {
+        if (!live[i]) continue;
+        const rac_var_t *var = vt_plist_get(tape->list, i);
+        VT_FOREACH(p, 0, rac_var_inputs_len(var)) {
+            size_t idx = 0;
+            if (rac_graph_map_get(index, rac_var_input(var, p), &idx)) live[idx] = true;
+        }
+    }
+
+    // compact the tape preserving order
+    size_t live_len = 0;
+    VT_FOREACH(i, 0, len) {
+        rac_var_t *var = vt_plist_get(tape->list, i);
+        if (live[i]) {
+            vt_plist_set(tape->list, var, live_len++);
+        } else {
+            vt_plist_push_back(tape->pruned, var);
+        }
+    }
+    while (vt_plist_len(tape->list) > live_len) vt_plist_pop_get(tape->list);
+
+    // free
+    (tape->alloctr) ? VT_ALLOCATOR_FREE(tape->alloctr, live) : VT_FREE(live);
+    rac_graph_map_free(index);
+}
+
+/**
+ * @brief Operator fusion: rewrites `mul -> add`, `sub -> mul` and `sqdiff -> add` chains into fused nodes
+ * @param tape tape instance
+ * @returns None
+ * @note Replaced nodes go to `tape->pruned`. Absorbed nodes no longer reach the output and are moved there by the DCE pass.
+ */
+static void rac_tape_pass_fuse(rac_tape_t *const tape) {
+    // the output (last node) is neither replaced nor absorbed
+    rac_graph_fuse_list(tape->list, tape->pruned);
+}
+
+/**
+ * @brief Groups tape positions into replay levels: a node's level is one more than that of its deepest parent on the tape
+ * @param tape tape instance
+ * @returns None
+ * @note If a node uses a parent pushed after it, the sequential replay reads the parent's old value; in that case every
+ *       node gets its own level, so that the replay order stays the push order.
+ */
+static void rac_tape_levels_build(rac_tape_t *const tape) {
+    const size_t len = vt_plist_len(tape->list);
+    if (len == 0) return;
+
+    // index tape nodes
+    rac_graph_map_t *index = rac_graph_map_make(tape->alloctr, len);
+    VT_FOREACH(i, 0, len) rac_graph_map_set(index, vt_plist_get(tape->list, i), i);
+
+    // depth of each node
+    size_t *depth = (tape->alloctr == NULL)
+        ? VT_CALLOC(len * sizeof(size_t))
+        : VT_ALLOCATOR_ALLOC(tape->alloctr, len * sizeof(size_t));
+    size_t levels_len = 1;
+    bool ordered = true;
+    VT_FOREACH(i, 0, len) {
+        const rac_var_t *var = vt_plist_get(tape->list, i);
+        depth[i] = 0;
+        VT_FOREACH(p, 0, rac_var_inputs_len(var)) {
+            size_t idx = 0;
+            if (!rac_graph_map_get(index, rac_var_input(var, p), &idx)) continue;
+            if (idx >= i) ordered = false;
+            else if (depth[idx] + 1 > depth[i]) depth[i] = depth[idx] + 1;
+        }
+        if (depth[i] + 1 > levels_len) levels_len = depth[i] + 1;
+    }
+    if (!ordered) {
+        VT_FOREACH(i, 0, len) depth[i] = i;
+        levels_len = len;
+    }
+
+    // group positions by level, keeping push order within a level
+    tape->levels = (tape->alloctr == NULL)
+        ? VT_CALLOC(len * sizeof(size_t))
+        : VT_ALLOCATOR_ALLOC(tape->alloctr, len * sizeof(size_t));
+    tape->level_offsets = (tape->alloctr == NULL)
+        ? VT_CALLOC((levels_len + 1) * sizeof(size_t))
+        : VT_ALLOCATOR_ALLOC(tape->alloctr, (levels_len + 1) * sizeof(size_t));
+    memset(tape->level_offsets, 0, (levels_len + 1) * sizeof(size_t));
+    VT_FOREACH(i, 0, len) tape->level_offsets[depth[i] + 1]++;
+    tape->width = 0;
+    VT_FOREACH(l, 0, levels_len) {
+        if (tape->level_offsets[l + 1] > tape->width) tape->width = tape->level_offsets[l + 1];
+        tape->level_offsets[l + 1] += tape->level_offsets[l];
+    }
+    tape->levels_len = levels_len;
+
+    // fill
+    size_t *fill = (tape->alloctr == NULL)
+        ? VT_CALLOC(levels_len * sizeof(size_t))
+        : VT_ALLOCATOR_ALLOC(tape->alloctr, levels_len * sizeof(size_t));
+    memcpy(fill, tape->level_offsets, levels_len * sizeof(size_t));
+    VT_FOREACH(i, 0, len) tape->levels[fill[depth[i]]++] = i;
+
+    // free
+    rac_graph_map_free(index);
+    if (tape->alloctr) {
+        VT_ALLOCATOR_FREE(tape->alloctr, depth);
+        VT_ALLOCATOR_FREE(tape->alloctr, fill);
+    } else {
+        VT_FREE(depth);
+        VT_FREE(fill);
+    }
+}
+
+/**
+ * @brief Frees replay levels
+ * @param tape tape instance
+ * @returns None
+ */
+static void rac_tape_levels_free(rac_tape_t *const tape) {
+    if (tape->levels == NULL) return;
+    if (tape->alloctr) {
+        VT_ALLOCATOR_FREE(tape->alloctr, tape->levels);
+        VT_ALLOCATOR_FREE(tape->alloctr, tape->level_offsets);
+    } else {
+        VT_FREE(tape->levels);
+        VT_FREE(tape->level_offsets);
+    }
+    tape->levels = tape->level_offsets = NULL;
+    tape->levels_len = tape->width = 0;
+}
+
+/**
+ * @brief Lists the tape consumers of every tape node and of every input used by the tape (including dot product weights)
+ * @param tape tape instance
+ * @returns None
+ * @note Not built (`tape->index` stays `NULL`) if a node uses a parent pushed after it.
+ */
+static void rac_tape_dependents_build(rac_tape_t *const tape) {
+    const size_t len = vt_plist_len(tape->list);
+    if (len == 0) return;
+
+    // ids: tape positions first, then inputs that are not on the tape
+    rac_graph_map_t *index = rac_graph_map_make(tape->alloctr, len);
+    VT_FOREACH(i, 0, len) rac_graph_map_set(index, vt_plist_get(tape->list, i), i);
+    size_t edges_len = 0;
+    VT_FOREACH(i, 0, len) {
+        const rac_var_t *var = vt_plist_get(tape->list, i);
+        VT_FOREACH(p, 0, rac_var_inputs_len(var)) {
+            size_t id = 0;
+            const rac_var_t *operand = rac_var_input(var, p);
+            if (operand == NULL) continue;
+            if (!rac_graph_map_get(index, operand, &id)) {
+                rac_graph_map_set(index, operand, rac_graph_map_len(index));
+            } else if (id >= i) {
+                rac_graph_map_free(index);
+                return;
+            }
+            edges_len++;
+        }
+    }
+
+    // count consumers of each id
+    const size_t ids_len = rac_graph_map_len(index);
+    size_t *consumer_offsets = (tape->alloctr == NULL)
+        ? VT_CALLOC((ids_len + 1) * sizeof(size_t))
+        : VT_ALLOCATOR_ALLOC(tape->alloctr, (ids_len + 1) * sizeof(size_t));
+    memset(consumer_offsets, 0, (ids_len + 1) * sizeof(size_t));
+    VT_FOREACH(i, 0, len) {
+        const rac_var_t *var = vt_plist_get(tape->list, i);
+        VT_FOREACH(p, 0, rac_var_inputs_len(var)) {
+            size_t id = 0;
+            if (rac_graph_map_get(index, rac_var_input(var, p), &id)) consumer_offsets[id + 1]++;
+        }
+    }
+    VT_FOREACH(i, 0, ids_len) consumer_offsets[i + 1] += consumer_offsets[i];
+
+    // fill consumers in tape order
+    size_t *consumers = (tape->alloctr == NULL)
+        ? VT_CALLOC((edges_len + 1) * sizeof(size_t))
+        : VT_ALLOCATOR_ALLOC(tape->alloctr, (edges_len + 1) * sizeof(size_t));
+    size_t *fill = (tape->alloctr == NULL)
+        ? VT_CALLOC(ids_len * sizeof(size_t))
+        : VT_ALLOCATOR_ALLOC(tape->alloctr, ids_len * sizeof(size_t));
+    memcpy(fill, consumer_offsets, ids_len * sizeof(size_t));
+    VT_FOREACH(i, 0, len) {
+        const rac_var_t *var = vt_plist_get(tape->list, i);
+        VT_FOREACH(p, 0, rac_var_inputs_len(var)) {
+            size_t id = 0;
+            if (rac_graph_map_get(index, rac_var_input(var, p), &id)) consumers[fill[id]++] = i;
+        }
+    }
+
+    // no changes yet
+    bool *changed = (tape->alloctr == NULL)
+        ? VT_CALLOC(len * sizeof(bool))
+        : VT_ALLOCATOR_ALLOC(tape->alloctr, len * sizeof(bool));
+    VT_FOREACH(i, 0, len) changed[i] = false;
+
+    // update
+    tape->index = index;
+    tape->consumer_offsets = consumer_offsets;
+    tape->consumers = consumers;
+    tape->changed = changed;
+
+    // free
+    (tape->alloctr) ? VT_ALLOCATOR_FREE(tape->alloctr, fill) : VT_FREE(fill);
+}
+
+/**
+ * @brief Frees dependents and change marks
+ * @param tape tape instance
+ * @returns None
+ */
+static void rac_tape_dependents_free(rac_tape_t *const tape) {
+    if (tape->index == NULL) return;
+    rac_graph_map_free(tape->index);
+    if (tape->alloctr) {
+        VT_ALLOCATOR_FREE(tape->alloctr, tape->consumer_offsets);
+        VT_ALLOCATOR_FREE(tape->alloctr, tape->consumers);
+        VT_ALLOCATOR_FREE(tape->alloctr, tape->changed);
+    } else {
+        VT_FREE(tape->consumer_offsets);
+        VT_FREE(tape->consumers);
+        VT_FREE(tape->changed);
+    }
+    tape->index = NULL;
+    tape->consumer_offsets = tape->consumers = NULL;
+    tape->changed = NULL;
+}
+
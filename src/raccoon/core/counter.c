@@ -0,0 +1,55 @@
+#include <stdatomic.h>
+#include "raccoon/core/counter.h"
+
+// updated from any thread (OpenMP forward passes, cross-thread pool frees)
+static _Atomic size_t gi_live_leaves = 0;
+static _Atomic size_t gi_live_intermediates = 0;
+static _Atomic size_t gi_live_bytes = 0;
+static _Atomic size_t gi_peak_nodes = 0;
+static _Atomic size_t gi_peak_bytes = 0;
+
+static void rac_counter_raise(_Atomic size_t *const peak, const size_t value);
+
+struct RaccoonCounterStats rac_counter_get_stats(void) {
+    return (struct RaccoonCounterStats) {
+        .leaves = atomic_load_explicit(&gi_live_leaves, memory_order_relaxed),
+        .intermediates = atomic_load_explicit(&gi_live_intermediates, memory_order_relaxed),
+        .bytes = atomic_load_explicit(&gi_live_bytes, memory_order_relaxed),
+        .peak_nodes = atomic_load_explicit(&gi_peak_nodes, memory_order_relaxed),
+        .peak_bytes = atomic_load_explicit(&gi_peak_bytes, memory_order_relaxed),
+    };
+}
+
+void rac_counter_step_begin(void) {
+    atomic_store(&gi_peak_nodes, atomic_load(&gi_live_leaves) + atomic_load(&gi_live_intermediates));
+    atomic_store(&gi_peak_bytes, atomic_load(&gi_live_bytes));
+}
+
+/*
+    Hooks
+*/
+
+void rac_counter_count_node(const bool leaf, const size_t bytes, const int delta) {
+    // update live nodes and bytes (unsigned wrap-around handles the decrement)
+    _Atomic size_t *counter = leaf ? &gi_live_leaves : &gi_live_intermediates;
+    atomic_fetch_add_explicit(counter, (size_t)delta, memory_order_relaxed);
+    const size_t live_bytes = atomic_fetch_add_explicit(&gi_live_bytes, (size_t)delta * bytes, memory_order_relaxed) + (size_t)delta * bytes;
+    if (delta < 0) return;
+
+    // update high-water marks
+    rac_counter_raise(&gi_peak_nodes, atomic_load_explicit(&gi_live_leaves, memory_order_relaxed) + atomic_load_explicit(&gi_live_intermediates, memory_order_relaxed));
+    rac_counter_raise(&gi_peak_bytes, live_bytes);
+}
+
+// -------------------------- PRIVATE -------------------------- //
+
+/**
+ * @brief Raises a high-water mark to `value` if it is lower
+ * @param peak high-water mark
+ * @param value current value
+ * @returns None
+ */
+static void rac_counter_raise(_Atomic size_t *const peak, const size_t value) {
+    size_t curr = atomic_load_explicit(peak, memory_order_relaxed);
+    while (value > curr && !atomic_compare_exchange_weak_explicit(peak, &curr, value, memory_order_relaxed, memory_order_relaxed));
+}
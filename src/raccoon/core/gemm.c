@@ -0,0 +1,59 @@
+#include "raccoon/core/gemm.h"
+
+/*
+    GEMM
+*/
+
+void rac_gemm(
+    const bool trans_a,
+    const bool trans_b,
+    const size_t m,
+    const size_t n,
+    const size_t k,
+    const rac_float *const a,
+    const rac_float *const b,
+    const bool accumulate,
+    rac_float *const c
+) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(a != NULL || m * k == 0, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(b != NULL || k * n == 0, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(c != NULL || m * n == 0, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // overwrite
+    if (!accumulate) memset(c, 0, m * n * sizeof(rac_float));
+
+    // block of `op(b)` packed row-major, so the inner loop always runs over contiguous memory
+    rac_float packed[RAC_GEMM_BLOCK_K * RAC_GEMM_BLOCK_N];
+    rac_acc_float acc[RAC_GEMM_BLOCK_N];
+    for (size_t j0 = 0; j0 < n; j0 += RAC_GEMM_BLOCK_N) {
+        const size_t nb = (n - j0 < RAC_GEMM_BLOCK_N) ? n - j0 : RAC_GEMM_BLOCK_N;
+        for (size_t p0 = 0; p0 < k; p0 += RAC_GEMM_BLOCK_K) {
+            const size_t kb = (k - p0 < RAC_GEMM_BLOCK_K) ? k - p0 : RAC_GEMM_BLOCK_K;
+
+            // pack
+            VT_FOREACH(p, 0, kb) {
+                rac_float *row = &packed[p * nb];
+                if (trans_b) {
+                    VT_FOREACH(j, 0, nb) row[j] = b[(j0 + j) * k + p0 + p];
+                } else {
+                    memcpy(row, &b[(p0 + p) * n + j0], nb * sizeof(rac_float));
+                }
+            }
+
+            // rows of `op(a)` against the packed block
+            VT_FOREACH(i, 0, m) {
+                VT_FOREACH(j, 0, nb) acc[j] = 0;
+                VT_FOREACH(p, 0, kb) {
+                    const rac_acc_float aip = trans_a ? a[(p0 + p) * m + i] : a[i * k + p0 + p];
+                    if (aip == 0) continue;
+                    const rac_float *row = &packed[p * nb];
+                    VT_FOREACH(j, 0, nb) acc[j] += aip * row[j];
+                }
+                rac_float *ci = &c[i * n + j0];
+                VT_FOREACH(j, 0, nb) ci[j] += (rac_float)acc[j];
+            }
+        }
+    }
+}
+
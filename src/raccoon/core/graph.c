@@ -0,0 +1,355 @@
+#include "raccoon/core/graph.h"
+
+static size_t rac_graph_map_hash(const void *const key);
+static void rac_graph_map_rehash(rac_graph_map_t *const map, const size_t capacity);
+static bool rac_graph_is_absorbable(const rac_var_t *const var, const char op, const rac_graph_map_t *const index, const size_t *const uses);
+static void rac_graph_rewire(rac_var_t *const var, const rac_graph_map_t *const renamed, const vt_plist_t *const nodes);
+static void rac_graph_topo_visit(rac_var_t *const root, rac_graph_map_t *const state, vt_plist_t *const stack, vt_plist_t *const order);
+
+/*
+    Map creation/destruction
+*/
+
+rac_graph_map_t *rac_graph_map_make(struct VitaBaseAllocatorType *const alloctr, const size_t expected_len) {
+    // allocate map instance
+    rac_graph_map_t *map = (alloctr == NULL)
+        ? VT_CALLOC(sizeof(rac_graph_map_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, sizeof(rac_graph_map_t));
+
+    // init map
+    *map = (rac_graph_map_t) {
+        .alloctr = alloctr,
+    };
+
+    // keep load factor below 1/2
+    size_t capacity = 16;
+    while (capacity < 2 * expected_len) capacity *= 2;
+    rac_graph_map_rehash(map, capacity);
+
+    return map;
+}
+
+void rac_graph_map_free(rac_graph_map_t *map) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(map != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // free slots and map
+    if (map->alloctr) {
+        VT_ALLOCATOR_FREE(map->alloctr, map->keys);
+        VT_ALLOCATOR_FREE(map->alloctr, map->values);
+        VT_ALLOCATOR_FREE(map->alloctr, map);
+    } else {
+        VT_FREE(map->keys);
+        VT_FREE(map->values);
+        VT_FREE(map);
+    }
+}
+
+/*
+    Map operations
+*/
+
+void rac_graph_map_set(rac_graph_map_t *const map, const void *const key, const size_t value) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(map != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(key != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // grow
+    if (2 * (map->len + 1) > map->capacity) rac_graph_map_rehash(map, 2 * map->capacity);
+
+    // find slot
+    const size_t mask = map->capacity - 1;
+    size_t slot = rac_graph_map_hash(key) & mask;
+    while (map->keys[slot] != NULL && map->keys[slot] != key) slot = (slot + 1) & mask;
+
+    // insert or update
+    if (map->keys[slot] == NULL) map->len++;
+    map->keys[slot] = key;
+    map->values[slot] = value;
+}
+
+bool rac_graph_map_get(const rac_graph_map_t *const map, const void *const key, size_t *const value) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(map != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    if (key == NULL) return false;
+
+    // probe
+    const size_t mask = map->capacity - 1;
+    size_t slot = rac_graph_map_hash(key) & mask;
+    while (map->keys[slot] != NULL) {
+        if (map->keys[slot] == key) {
+            if (value) *value = map->values[slot];
+            return true;
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    return false;
+}
+
+size_t rac_graph_map_len(const rac_graph_map_t *const map) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(map != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    return map->len;
+}
+
+void rac_graph_map_clear(rac_graph_map_t *const map) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(map != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // empty slots
+    memset(map->keys, 0, map->capacity * sizeof(void*));
+    map->len = 0;
+}
+
+/*
+    Graph passes
+*/
+
+vt_plist_t *rac_graph_topo_sort(rac_var_t *const root) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(root != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // node -> 0 (expanded), 1 (emitted)
+    vt_plist_t *order = vt_plist_create(VT_ARRAY_DEFAULT_INIT_ELEMENTS, root->alloctr);
+    vt_plist_t *stack = vt_plist_create(VT_ARRAY_DEFAULT_INIT_ELEMENTS, root->alloctr);
+    rac_graph_map_t *state = rac_graph_map_make(root->alloctr, 0);
+    rac_graph_topo_visit(root, state, stack, order);
+
+    // free
+    rac_graph_map_free(state);
+    vt_plist_destroy(stack);
+
+    return order;
+}
+
+vt_plist_t *rac_graph_topo_sort_list(const vt_plist_t *const roots) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(roots != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(vt_plist_len(roots) > 0, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // one walk shared by all roots, so every node is emitted once
+    struct VitaBaseAllocatorType *alloctr = ((const rac_var_t*)vt_plist_get(roots, 0))->alloctr;
+    vt_plist_t *order = vt_plist_create(VT_ARRAY_DEFAULT_INIT_ELEMENTS, alloctr);
+    vt_plist_t *stack = vt_plist_create(VT_ARRAY_DEFAULT_INIT_ELEMENTS, alloctr);
+    rac_graph_map_t *state = rac_graph_map_make(alloctr, vt_plist_len(roots));
+    VT_FOREACH(i, 0, vt_plist_len(roots)) rac_graph_topo_visit(vt_plist_get(roots, i), state, stack, order);
+
+    // free
+    rac_graph_map_free(state);
+    vt_plist_destroy(stack);
+
+    return order;
+}
+
+void rac_graph_backward(const vt_plist_t *const roots) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(roots != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // consumers before the nodes they use
+    vt_plist_t *order = rac_graph_topo_sort_list(roots);
+    for (size_t i = vt_plist_len(order); i-- > 0;) {
+        rac_var_t *var = vt_plist_get(order, i);
+        if (var->backward) var->backward(var);
+    }
+    vt_plist_destroy(order);
+}
+
+size_t rac_graph_fuse_list(vt_plist_t *const nodes, vt_plist_t *const replaced) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(nodes != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(replaced != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    const size_t len = vt_plist_len(nodes);
+    if (len == 0) return 0;
+
+    // index nodes and count uses (edges) from consumers in the list
+    struct VitaBaseAllocatorType *alloctr = ((rac_var_t*)vt_plist_get(nodes, 0))->alloctr;
+    rac_graph_map_t *index = rac_graph_map_make(alloctr, len);
+    VT_FOREACH(i, 0, len) rac_graph_map_set(index, vt_plist_get(nodes, i), i);
+    size_t *uses = (alloctr == NULL)
+        ? VT_CALLOC(len * sizeof(size_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, len * sizeof(size_t));
+    VT_ENFORCE(uses != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_ALLOCATION));
+    memset(uses, 0, len * sizeof(size_t));
+    VT_FOREACH(i, 0, len) {
+        const rac_var_t *var = vt_plist_get(nodes, i);
+        VT_FOREACH(p, 0, RAC_VAR_OPERANDS_LEN) {
+            size_t idx = 0;
+            if (rac_graph_map_get(index, rac_var_operand(var, p), &idx)) uses[idx]++;
+        }
+    }
+
+    // rewrite consumers; parents are visited first, so chains fuse bottom-up
+    rac_graph_map_t *renamed = rac_graph_map_make(alloctr, 0);
+    size_t fused = 0;
+    VT_FOREACH(i, 0, len) {
+        rac_var_t *var = vt_plist_get(nodes, i);
+        rac_graph_rewire(var, renamed, nodes);
+        if (var->parents[0] == NULL || var->parents[1] == NULL || (var->flags & RAC_VAR_FLAG_FUSED)) continue;
+        rac_var_t *lhs = var->parents[0], *rhs = var->parents[1];
+        if (var->op == '*' && lhs == rhs && rac_graph_is_absorbable(lhs, '-', index, uses)) {
+            // (a - b) * (a - b) -> sqdiff(a, b), squaring uses the node twice; same operand count, so rewritten in place
+            rac_var_sqdiff_inplace(var, lhs->parents[0], lhs->parents[1]);
+        } else if (var->op == '+' && i + 1 != len) {
+            // acc + (a - b)^2 -> sqdiff_acc(a, b, acc), acc + a * b -> fma(a, b, acc)
+            rac_var_t *acc = NULL, *absorbed = NULL;
+            if (rac_graph_is_absorbable(rhs, 'q', index, uses)) { absorbed = rhs; acc = lhs; }
+            else if (rac_graph_is_absorbable(lhs, 'q', index, uses)) { absorbed = lhs; acc = rhs; }
+            else if (rac_graph_is_absorbable(rhs, '*', index, uses)) { absorbed = rhs; acc = lhs; }
+            else if (rac_graph_is_absorbable(lhs, '*', index, uses)) { absorbed = lhs; acc = rhs; }
+            if (absorbed == NULL) continue;
+
+            // the fused node has a third operand, so it replaces `var` in the list and its consumers
+            rac_var_t *node = (absorbed->op == 'q')
+                ? rac_var_sqdiff_acc(absorbed->parents[0], absorbed->parents[1], acc)
+                : rac_var_fma(absorbed->parents[0], absorbed->parents[1], acc);
+            vt_plist_set(nodes, node, i);
+            rac_graph_map_set(renamed, var, i);
+            vt_plist_push_back(replaced, var);
+        } else {
+            continue;
+        }
+        fused++;
+    }
+
+    // consumers listed before their parents
+    if (rac_graph_map_len(renamed)) VT_FOREACH(i, 0, len) rac_graph_rewire(vt_plist_get(nodes, i), renamed, nodes);
+
+    // free
+    (alloctr) ? VT_ALLOCATOR_FREE(alloctr, uses) : VT_FREE(uses);
+    rac_graph_map_free(renamed);
+    rac_graph_map_free(index);
+
+    return fused;
+}
+
+// -------------------------- PRIVATE -------------------------- //
+
+/**
+ * @brief Hashes a pointer (splitmix64 finalizer)
+ * @param key pointer
+ * @returns hash value
+ */
+static size_t rac_graph_map_hash(const void *const key) {
+    uint64_t h = (uint64_t)(uintptr_t)key;
+    h ^= h >> 30; h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27; h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return (size_t)h;
+}
+
+/**
+ * @brief Resizes the map and reinserts all elements
+ * @param map instance
+ * @param capacity new number of slots (power of two)
+ * @returns None
+ */
+static void rac_graph_map_rehash(rac_graph_map_t *const map, const size_t capacity) {
+    // allocate new slots
+    const void **keys = (map->alloctr == NULL)
+        ? VT_CALLOC(capacity * sizeof(void*))
+        : VT_ALLOCATOR_ALLOC(map->alloctr, capacity * sizeof(void*));
+    size_t *values = (map->alloctr == NULL)
+        ? VT_CALLOC(capacity * sizeof(size_t))
+        : VT_ALLOCATOR_ALLOC(map->alloctr, capacity * sizeof(size_t));
+    VT_ENFORCE(keys != NULL && values != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_ALLOCATION));
+    memset(keys, 0, capacity * sizeof(void*));
+
+    // reinsert
+    const size_t mask = capacity - 1;
+    VT_FOREACH(i, 0, map->capacity) {
+        if (map->keys[i] == NULL) continue;
+        size_t slot = rac_graph_map_hash(map->keys[i]) & mask;
+        while (keys[slot] != NULL) slot = (slot + 1) & mask;
+        keys[slot] = map->keys[i];
+        values[slot] = map->values[i];
+    }
+
+    // free old slots
+    if (map->keys) {
+        if (map->alloctr) {
+            VT_ALLOCATOR_FREE(map->alloctr, map->keys);
+            VT_ALLOCATOR_FREE(map->alloctr, map->values);
+        } else {
+            VT_FREE(map->keys);
+            VT_FREE(map->values);
+        }
+    }
+
+    // update
+    map->keys = keys;
+    map->values = values;
+    map->capacity = capacity;
+}
+
+/**
+ * @brief Checks if a node can be absorbed into its only consumer
+ * @param var node
+ * @param op expected operation
+ * @param index node -> list index
+ * @param uses number of uses of each list node
+ * @returns `true` if `var` is a two-parent `op` node used only once (squares use it twice from the same consumer)
+ */
+static bool rac_graph_is_absorbable(const rac_var_t *const var, const char op, const rac_graph_map_t *const index, const size_t *const uses) {
+    size_t idx = 0;
+    if (var->op != op || var->parents[0] == NULL || var->parents[1] == NULL || (var->flags & RAC_VAR_FLAG_FUSED)) return false;
+    if (!rac_graph_map_get(index, var, &idx)) return false;
+    return uses[idx] == ((op == '-') ? 2 : 1);
+}
+
+/**
+ * @brief Points the operands of a node at the nodes that replaced them
+ * @param var node
+ * @param renamed replaced node -> list index of its replacement
+ * @param nodes node list
+ * @returns None
+ */
+static void rac_graph_rewire(rac_var_t *const var, const rac_graph_map_t *const renamed, const vt_plist_t *const nodes) {
+    size_t idx = 0;
+    VT_FOREACH(p, 0, RAC_VAR_PARENTS_LEN) {
+        if (rac_graph_map_get(renamed, var->parents[p], &idx)) var->parents[p] = vt_plist_get(nodes, idx);
+    }
+    if ((var->flags & RAC_VAR_FLAG_FUSED) && rac_graph_map_get(renamed, ((rac_var_fused_t*)var)->acc, &idx)) {
+        ((rac_var_fused_t*)var)->acc = vt_plist_get(nodes, idx);
+    }
+}
+
+/**
+ * @brief Appends nodes reachable from the root to a topological order (iterative post-order walk)
+ * @param root start node
+ * @param state node -> 0 (expanded), 1 (emitted); shared between walks
+ * @param stack empty work stack
+ * @param order output list, parents before their consumers
+ * @returns None
+ */
+static void rac_graph_topo_visit(rac_var_t *const root, rac_graph_map_t *const state, vt_plist_t *const stack, vt_plist_t *const order) {
+    if (rac_graph_map_get(state, root, NULL)) return;
+    vt_plist_push_back(stack, root);
+    while (vt_plist_len(stack)) {
+        rac_var_t *var = vt_plist_get(stack, vt_plist_len(stack)-1);
+        size_t visited = 0;
+        if (!rac_graph_map_get(state, var, &visited)) {
+            rac_graph_map_set(state, var, 0);
+            VT_FOREACH(p, 0, RAC_VAR_OPERANDS_LEN) {
+                rac_var_t *operand = rac_var_operand(var, p);
+                if (operand && !rac_graph_map_get(state, operand, NULL)) vt_plist_push_back(stack, operand);
+            }
+
+            // dot products also depend on their weights
+            if (var->op == 'd') {
+                const rac_var_dot_t *dot = (const rac_var_dot_t*)var;
+                VT_FOREACH(i, 0, dot->len) {
+                    rac_var_t *w = vt_plist_get(dot->weights, i);
+                    if (!rac_graph_map_get(state, w, NULL)) vt_plist_push_back(stack, w);
+                }
+            }
+        } else {
+            vt_plist_pop_get(stack);
+            if (visited == 0) {
+                rac_graph_map_set(state, var, 1);
+                vt_plist_push_back(order, var);
+            }
+        }
+    }
+}
+
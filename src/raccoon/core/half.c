@@ -0,0 +1,32 @@
+#include "raccoon/core/half.h"
+
+/*
+    Array conversions
+*/
+
+void rac_half_pack(const enum RaccoonHalfType type, const size_t len, const rac_float *const src, rac_half_t *const dst) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(src != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(dst != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // convert (the format is checked once, so that each loop vectorizes)
+    if (type == RAC_HALF_BF16) {
+        VT_FOREACH(i, 0, len) dst[i] = rac_bf16_from_float((float)src[i]);
+    } else {
+        VT_FOREACH(i, 0, len) dst[i] = rac_fp16_from_float((float)src[i]);
+    }
+}
+
+void rac_half_unpack(const enum RaccoonHalfType type, const size_t len, const rac_half_t *const src, rac_float *const dst) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(src != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(dst != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // convert
+    if (type == RAC_HALF_BF16) {
+        VT_FOREACH(i, 0, len) dst[i] = rac_bf16_to_float(src[i]);
+    } else {
+        VT_FOREACH(i, 0, len) dst[i] = rac_fp16_to_float(src[i]);
+    }
+}
+
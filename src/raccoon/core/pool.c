@@ -0,0 +1,170 @@
+#include "raccoon/core/pool.h"
+#include "raccoon/core/variable.h"
+
+// slab header, stored at the start of each aligned slab
+struct RaccoonPoolSlab {
+    rac_pool_t *owner;
+    struct RaccoonPoolSlab *next;
+    void *raw; // allocation the slab was carved from
+    struct RaccoonPoolSlab *next_alloc; // first slab of the next allocation (set on first slabs only)
+    size_t cls; // size class of its slots
+};
+
+// slot and header sizes keep every slot aligned like `malloc` memory
+#define RAC_POOL_ROUND_UP(size) (((size) + sizeof(max_align_t) - 1) / sizeof(max_align_t) * sizeof(max_align_t))
+#define RAC_POOL_HEADER_SIZE RAC_POOL_ROUND_UP(sizeof(struct RaccoonPoolSlab))
+
+// slot size of each class
+static const size_t rac_pool_slot_size[RAC_POOL_CLASSES_LEN] = {
+    RAC_POOL_ROUND_UP(sizeof(rac_var_t)),
+    RAC_POOL_ROUND_UP(sizeof(rac_var_fused_t)),
+};
+
+// pool bound to this thread
+static _Thread_local rac_pool_t *rac_pool_current = NULL;
+
+static void rac_pool_grow(rac_pool_t *const pool, const size_t cls);
+
+/*
+    Pool creation/destruction
+*/
+
+rac_pool_t *rac_pool_make(struct VitaBaseAllocatorType *const alloctr) {
+    // allocate pool instance
+    rac_pool_t *pool = (alloctr == NULL)
+        ? VT_CALLOC(sizeof(rac_pool_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, sizeof(rac_pool_t));
+
+    // init
+    *pool = (rac_pool_t) {
+        .slabs = NULL,
+        .spare = NULL,
+        .allocs = NULL,
+        .alloctr = alloctr,
+    };
+    VT_FOREACH(c, 0, RAC_POOL_CLASSES_LEN) atomic_init(&pool->remote_list[c], NULL);
+
+    return pool;
+}
+
+void rac_pool_free(rac_pool_t *pool) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(pool != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // unbind
+    if (rac_pool_current == pool) rac_pool_current = NULL;
+
+    // free slab allocations (the list links live inside them) and pool
+    struct RaccoonPoolSlab *first = pool->allocs;
+    while (first != NULL) {
+        struct RaccoonPoolSlab *next = first->next_alloc;
+        (pool->alloctr) ? VT_ALLOCATOR_FREE(pool->alloctr, first->raw) : VT_FREE(first->raw);
+        first = next;
+    }
+    (pool->alloctr) ? VT_ALLOCATOR_FREE(pool->alloctr, pool) : VT_FREE(pool);
+}
+
+/*
+    Pool operations
+*/
+
+rac_pool_t *rac_pool_bind(rac_pool_t *const pool) {
+    rac_pool_t *prev = rac_pool_current;
+    rac_pool_current = pool;
+    return prev;
+}
+
+rac_pool_t *rac_pool_bound(void) {
+    return rac_pool_current;
+}
+
+void *rac_pool_alloc(rac_pool_t *const pool, const size_t size) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(pool != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(size <= rac_pool_slot_size[RAC_POOL_CLASSES_LEN - 1], "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // smallest class that fits
+    size_t cls = 0;
+    while (rac_pool_slot_size[cls] < size) cls++;
+
+    // refill: take over slots released by other threads, then carve a new slab
+    if (pool->free_list[cls] == NULL) pool->free_list[cls] = atomic_exchange_explicit(&pool->remote_list[cls], NULL, memory_order_acquire);
+    if (pool->free_list[cls] == NULL) rac_pool_grow(pool, cls);
+
+    // pop
+    void *slot = pool->free_list[cls];
+    pool->free_list[cls] = *(void**)slot;
+
+    return slot;
+}
+
+void rac_pool_release(void *const ptr) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(ptr != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // find the owner and size class through the slab header
+    const struct RaccoonPoolSlab *slab = (const struct RaccoonPoolSlab*)((uintptr_t)ptr & ~(uintptr_t)(RAC_POOL_SLAB_SIZE - 1));
+    rac_pool_t *pool = slab->owner;
+    const size_t cls = slab->cls;
+
+    // owner thread: plain push
+    if (pool == rac_pool_current) {
+        *(void**)ptr = pool->free_list[cls];
+        pool->free_list[cls] = ptr;
+        return;
+    }
+
+    // other threads: lock-free push (the owner only ever takes the whole list, so there is no ABA problem)
+    void *head = atomic_load_explicit(&pool->remote_list[cls], memory_order_relaxed);
+    do {
+        *(void**)ptr = head;
+    } while (!atomic_compare_exchange_weak_explicit(&pool->remote_list[cls], &head, ptr, memory_order_release, memory_order_relaxed));
+}
+
+// -------------------------- PRIVATE -------------------------- //
+
+/**
+ * @brief Takes a spare slab (carving new ones if there are none) and puts all of its slots onto the free list of their class
+ * @param pool instance
+ * @param cls size class
+ * @returns None
+ */
+static void rac_pool_grow(rac_pool_t *const pool, const size_t cls) {
+    // carve aligned slabs from one allocation: one extra slab of room covers the alignment
+    if (pool->spare == NULL) {
+        void *raw = (pool->alloctr == NULL)
+            ? VT_CALLOC((RAC_POOL_SLABS_PER_ALLOC + 1) * RAC_POOL_SLAB_SIZE)
+            : VT_ALLOCATOR_ALLOC(pool->alloctr, (RAC_POOL_SLABS_PER_ALLOC + 1) * RAC_POOL_SLAB_SIZE);
+        VT_ENFORCE(raw != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_ALLOCATION));
+        const uintptr_t aligned = ((uintptr_t)raw + RAC_POOL_SLAB_SIZE - 1) & ~(uintptr_t)(RAC_POOL_SLAB_SIZE - 1);
+        for (size_t i = RAC_POOL_SLABS_PER_ALLOC; i-- > 0;) {
+            struct RaccoonPoolSlab *spare = (struct RaccoonPoolSlab*)(aligned + i * RAC_POOL_SLAB_SIZE);
+            *spare = (struct RaccoonPoolSlab) {
+                .owner = pool,
+                .next = pool->spare,
+                .raw = raw,
+            };
+            pool->spare = spare;
+        }
+        pool->spare->next_alloc = pool->allocs;
+        pool->allocs = pool->spare;
+    }
+
+    // header
+    struct RaccoonPoolSlab *slab = pool->spare;
+    pool->spare = slab->next;
+    slab->next = pool->slabs;
+    slab->cls = cls;
+    pool->slabs = slab;
+    pool->slabs_len++;
+
+    // link slots in address order
+    const size_t slot_size = rac_pool_slot_size[cls];
+    const size_t slots_len = (RAC_POOL_SLAB_SIZE - RAC_POOL_HEADER_SIZE) / slot_size;
+    char *slots = (char*)slab + RAC_POOL_HEADER_SIZE;
+    VT_FOREACH(i, 0, slots_len) {
+        *(void**)(slots + i * slot_size) = (i + 1 < slots_len) ? slots + (i + 1) * slot_size : pool->free_list[cls];
+    }
+    pool->free_list[cls] = slots;
+    pool->capacity += slots_len;
+}
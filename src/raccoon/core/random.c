@@ -0,0 +1,110 @@
+#include "raccoon/core/random.h"
+
+// values taken from one 128-bit block: 4 x 24 bits in float builds, 2 x 53 bits otherwise
+#if defined(RACCOON_USE_TYPE_DOUBLE) || defined(RACCOON_USE_TYPE_LONG_DOUBLE)
+    #define RAC_RANDOM_PER_BLOCK 2
+#else
+    #define RAC_RANDOM_PER_BLOCK 4
+#endif
+
+static void rac_random_block_to_unit(const uint32_t bits[4], rac_float unit[RAC_RANDOM_PER_BLOCK]);
+
+/*
+    Random stream creation
+*/
+
+rac_random_t rac_random_make(const uint64_t seed, const uint64_t stream) {
+    return (rac_random_t) {
+        .key = { (uint32_t)seed, (uint32_t)(seed >> 32) },
+        .stream = stream,
+        .counter = 0,
+    };
+}
+
+/*
+    Random fills
+*/
+
+void rac_random_uniform(rac_random_t *const rng, rac_float *const out, const size_t len, const rac_float low, const rac_float high) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(rng != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(out != NULL || len == 0, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // every block is computed from its own counter, so blocks can be filled in any order
+    const size_t blocks = (len + RAC_RANDOM_PER_BLOCK - 1) / RAC_RANDOM_PER_BLOCK;
+    const uint64_t first = rng->counter;
+    const rac_float scale = high - low;
+#if defined(_OPENMP)
+    #pragma omp parallel for schedule(static) if(blocks >= RAC_RANDOM_PARALLEL_MIN)
+#endif
+    for (size_t b = 0; b < blocks; b++) {
+        const uint64_t n = first + b;
+        const uint32_t counter[4] = { (uint32_t)n, (uint32_t)(n >> 32), (uint32_t)rng->stream, (uint32_t)(rng->stream >> 32) };
+        uint32_t bits[4];
+        rac_float unit[RAC_RANDOM_PER_BLOCK];
+        rac_random_philox(counter, rng->key, bits);
+        rac_random_block_to_unit(bits, unit);
+        const size_t begin = b * RAC_RANDOM_PER_BLOCK;
+        const size_t end = (len - begin < RAC_RANDOM_PER_BLOCK) ? len : begin + RAC_RANDOM_PER_BLOCK;
+        for (size_t i = begin; i < end; i++) out[i] = low + scale * unit[i - begin];
+    }
+    rng->counter += blocks;
+}
+
+void rac_random_normal(rac_random_t *const rng, rac_float *const out, const size_t len, const rac_float mean, const rac_float std) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(rng != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(out != NULL || len == 0, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // pairs of uniforms become pairs of normals; an odd last value uses its own pair
+    const size_t pairs = len / 2;
+    rac_random_uniform(rng, out, 2 * pairs, 0, 1);
+    rac_float tail[2] = {0};
+    if (len % 2) rac_random_uniform(rng, tail, 2, 0, 1);
+    const rac_float two_pi = (rac_float)6.283185307179586476925286766559;
+    for (size_t p = 0; p < pairs + len % 2; p++) {
+        rac_float *u = (p < pairs) ? &out[2 * p] : tail;
+        const rac_float r = RAC_SQRT(-2 * RAC_LOG(1 - u[0])); // 1 - u is in (0; 1]
+        const rac_float theta = two_pi * u[1];
+        u[0] = mean + std * r * RAC_COS(theta);
+        u[1] = mean + std * r * RAC_SIN(theta);
+    }
+    if (len % 2) out[len - 1] = tail[0];
+}
+
+void rac_random_xavier(rac_random_t *const rng, rac_float *const out, const size_t len, const size_t fan_in, const size_t fan_out) {
+    // check for invalid input
+    VT_ENFORCE(fan_in + fan_out > 0, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // variance 2 / (fan_in + fan_out)
+    const rac_float limit = RAC_SQRT((rac_float)6 / (rac_float)(fan_in + fan_out));
+    rac_random_uniform(rng, out, len, -limit, limit);
+}
+
+void rac_random_he(rac_random_t *const rng, rac_float *const out, const size_t len, const size_t fan_in) {
+    // check for invalid input
+    VT_ENFORCE(fan_in > 0, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // variance 2 / fan_in
+    rac_random_normal(rng, out, len, 0, RAC_SQRT((rac_float)2 / (rac_float)fan_in));
+}
+
+// -------------------------- PRIVATE -------------------------- //
+
+/**
+ * @brief Converts random bits to values in `[0; 1)` with the full `rac_float` resolution
+ * @param bits 128 random bits
+ * @param unit `RAC_RANDOM_PER_BLOCK` values
+ * @returns None
+ */
+static void rac_random_block_to_unit(const uint32_t bits[4], rac_float unit[RAC_RANDOM_PER_BLOCK]) {
+#if RAC_RANDOM_PER_BLOCK == 4
+    VT_FOREACH(i, 0, 4) unit[i] = (rac_float)(bits[i] >> 8) * 0x1p-24f;
+#else
+    VT_FOREACH(i, 0, 2) {
+        const uint64_t mantissa = ((uint64_t)(bits[2 * i] >> 5) << 26) | (bits[2 * i + 1] >> 6);
+        unit[i] = (rac_float)mantissa * 0x1p-53;
+    }
+#endif
+}
+
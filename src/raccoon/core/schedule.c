@@ -0,0 +1,203 @@
+#include "raccoon/core/schedule.h"
+
+static void rac_schedule_pull(rac_schedule_t *const schedule, const size_t i);
+
+/*
+    Schedule creation/destruction
+*/
+
+rac_schedule_t *rac_schedule_make(struct VitaBaseAllocatorType *const alloctr, const vt_plist_t *const outputs) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(outputs != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // order nodes, every operation must have a derivative rule
+    vt_plist_t *nodes = rac_graph_topo_sort_list(outputs);
+    const size_t len = vt_plist_len(nodes);
+    VT_FOREACH(i, 0, len) {
+        const rac_var_t *var = vt_plist_get(nodes, i);
+        VT_ENFORCE(var->op != 'd', "%s\n", "Dot products keep their weights outside of the graph! Use variable inputs (`rac_mlp_forward`) instead!");
+        VT_ENFORCE(rac_var_has_rule(var), "Operation '%c' has no derivative rule! Register it with `rac_var_register_op`!\n", var->op);
+    }
+    rac_graph_map_t *index = rac_graph_map_make(alloctr, len);
+    VT_FOREACH(i, 0, len) rac_graph_map_set(index, vt_plist_get(nodes, i), i);
+
+    // allocate schedule instance
+    rac_schedule_t *schedule = (alloctr == NULL)
+        ? VT_CALLOC(sizeof(rac_schedule_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, sizeof(rac_schedule_t));
+    size_t *consumer_offsets = (alloctr == NULL)
+        ? VT_CALLOC((len + 1) * sizeof(size_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, (len + 1) * sizeof(size_t));
+    size_t *height = (alloctr == NULL)
+        ? VT_CALLOC(len * sizeof(size_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, len * sizeof(size_t));
+    rac_float *partials = (alloctr == NULL)
+        ? VT_CALLOC(len * RAC_VAR_OPERANDS_LEN * sizeof(rac_float))
+        : VT_ALLOCATOR_ALLOC(alloctr, len * RAC_VAR_OPERANDS_LEN * sizeof(rac_float));
+    memset(consumer_offsets, 0, (len + 1) * sizeof(size_t));
+    memset(height, 0, len * sizeof(size_t));
+
+    // count consumer edges (a node used twice by the same consumer has two edges)
+    size_t edges_len = 0;
+    VT_FOREACH(i, 0, len) {
+        const rac_var_t *var = vt_plist_get(nodes, i);
+        VT_FOREACH(p, 0, RAC_VAR_OPERANDS_LEN) {
+            size_t idx = 0;
+            if (!rac_graph_map_get(index, rac_var_operand(var, p), &idx)) continue;
+            consumer_offsets[idx + 1]++;
+            edges_len++;
+        }
+    }
+    VT_FOREACH(i, 0, len) consumer_offsets[i + 1] += consumer_offsets[i];
+
+    // fill consumer edges in topological order of the consumers
+    size_t *consumers = (alloctr == NULL)
+        ? VT_CALLOC((edges_len + 1) * sizeof(size_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, (edges_len + 1) * sizeof(size_t));
+    size_t *slots = (alloctr == NULL)
+        ? VT_CALLOC((edges_len + 1) * sizeof(size_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, (edges_len + 1) * sizeof(size_t));
+    size_t *fill = (alloctr == NULL)
+        ? VT_CALLOC((len + 1) * sizeof(size_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, (len + 1) * sizeof(size_t));
+    memcpy(fill, consumer_offsets, (len + 1) * sizeof(size_t));
+    VT_FOREACH(i, 0, len) {
+        const rac_var_t *var = vt_plist_get(nodes, i);
+        VT_FOREACH(p, 0, RAC_VAR_OPERANDS_LEN) {
+            size_t idx = 0;
+            if (!rac_graph_map_get(index, rac_var_operand(var, p), &idx)) continue;
+            consumers[fill[idx]] = i;
+            slots[fill[idx]] = p;
+            fill[idx]++;
+        }
+    }
+
+    // level of a node: one more than its furthest consumer (consumers are visited first)
+    size_t levels_len = (len > 0) ? 1 : 0;
+    for (size_t i = len; i-- > 0;) {
+        VT_FOREACH(e, consumer_offsets[i], consumer_offsets[i + 1]) {
+            if (height[consumers[e]] + 1 > height[i]) height[i] = height[consumers[e]] + 1;
+        }
+        if (height[i] + 1 > levels_len) levels_len = height[i] + 1;
+    }
+
+    // group nodes by level, keeping topological order within a level
+    size_t *levels = (alloctr == NULL)
+        ? VT_CALLOC((len + 1) * sizeof(size_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, (len + 1) * sizeof(size_t));
+    size_t *level_offsets = (alloctr == NULL)
+        ? VT_CALLOC((levels_len + 1) * sizeof(size_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, (levels_len + 1) * sizeof(size_t));
+    memset(level_offsets, 0, (levels_len + 1) * sizeof(size_t));
+    VT_FOREACH(i, 0, len) level_offsets[height[i] + 1]++;
+    size_t width = 0;
+    VT_FOREACH(l, 0, levels_len) {
+        if (level_offsets[l + 1] > width) width = level_offsets[l + 1];
+        level_offsets[l + 1] += level_offsets[l];
+    }
+    memcpy(fill, level_offsets, levels_len * sizeof(size_t));
+    VT_FOREACH(i, 0, len) levels[fill[height[i]]++] = i;
+
+    // init
+    *schedule = (rac_schedule_t) {
+        .nodes = nodes,
+        .levels = levels,
+        .level_offsets = level_offsets,
+        .levels_len = levels_len,
+        .width = width,
+        .consumer_offsets = consumer_offsets,
+        .consumers = consumers,
+        .slots = slots,
+        .partials = partials,
+        .alloctr = alloctr,
+    };
+
+    // free
+    rac_graph_map_free(index);
+    if (alloctr) {
+        VT_ALLOCATOR_FREE(alloctr, height);
+        VT_ALLOCATOR_FREE(alloctr, fill);
+    } else {
+        VT_FREE(height);
+        VT_FREE(fill);
+    }
+
+    return schedule;
+}
+
+void rac_schedule_free(rac_schedule_t *schedule) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(schedule != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // free node list and arrays
+    vt_plist_destroy(schedule->nodes);
+    if (schedule->alloctr) {
+        VT_ALLOCATOR_FREE(schedule->alloctr, schedule->levels);
+        VT_ALLOCATOR_FREE(schedule->alloctr, schedule->level_offsets);
+        VT_ALLOCATOR_FREE(schedule->alloctr, schedule->consumer_offsets);
+        VT_ALLOCATOR_FREE(schedule->alloctr, schedule->consumers);
+        VT_ALLOCATOR_FREE(schedule->alloctr, schedule->slots);
+        VT_ALLOCATOR_FREE(schedule->alloctr, schedule->partials);
+        VT_ALLOCATOR_FREE(schedule->alloctr, schedule);
+    } else {
+        VT_FREE(schedule->levels);
+        VT_FREE(schedule->level_offsets);
+        VT_FREE(schedule->consumer_offsets);
+        VT_FREE(schedule->consumers);
+        VT_FREE(schedule->slots);
+        VT_FREE(schedule->partials);
+        VT_FREE(schedule);
+    }
+}
+
+/*
+    Schedule operations
+*/
+
+void rac_schedule_backward(rac_schedule_t *const schedule) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(schedule != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // levels run one after another (implicit barrier), nodes within a level are split between threads
+#if defined(_OPENMP)
+    #pragma omp parallel if(schedule->width >= RAC_SCHEDULE_PARALLEL_MIN)
+#endif
+    for (size_t l = 0; l < schedule->levels_len; l++) {
+        const size_t begin = schedule->level_offsets[l], end = schedule->level_offsets[l + 1];
+#if defined(_OPENMP)
+        #pragma omp for schedule(static)
+#endif
+        for (size_t k = begin; k < end; k++) rac_schedule_pull(schedule, schedule->levels[k]);
+    }
+}
+
+// -------------------------- PRIVATE -------------------------- //
+
+/**
+ * @brief Accumulates a node's gradient from its consumers and computes its own local derivatives
+ * @param schedule instance
+ * @param i node position
+ * @returns None
+ * @note Writes only to node `i`, reads only from its consumers (earlier levels), so nodes of one level can run concurrently.
+ */
+static void rac_schedule_pull(rac_schedule_t *const schedule, const size_t i) {
+    rac_var_t *var = vt_plist_get(schedule->nodes, i);
+
+    // gradient: sum of consumer gradients times the local derivative of the slot they use
+    rac_acc_float grad = 0;
+    VT_FOREACH(e, schedule->consumer_offsets[i], schedule->consumer_offsets[i + 1]) {
+        const size_t c = schedule->consumers[e];
+        const rac_var_t *consumer = vt_plist_get(schedule->nodes, c);
+        grad += (rac_acc_float)schedule->partials[c * RAC_VAR_OPERANDS_LEN + schedule->slots[e]] * consumer->grad;
+    }
+    var->grad += (rac_float)grad;
+
+    // local derivatives for the operands (nodes without a backward function do not propagate)
+    rac_float *partials = &schedule->partials[i * RAC_VAR_OPERANDS_LEN];
+    if (var->backward) {
+        rac_var_partials(var, partials);
+    } else {
+        VT_FOREACH(p, 0, RAC_VAR_OPERANDS_LEN) partials[p] = 0;
+    }
+}
+
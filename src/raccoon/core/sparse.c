@@ -0,0 +1,96 @@
+#include "raccoon/core/sparse.h"
+
+static rac_sparse_t *rac_sparse_alloc(struct VitaBaseAllocatorType *const alloctr, const size_t len, const size_t nnz);
+
+/*
+    Sparse creation/destruction
+*/
+
+rac_sparse_t *rac_sparse_make(struct VitaBaseAllocatorType *const alloctr, const size_t len, const size_t nnz, const size_t *const indices, const rac_float *const values) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(nnz == 0 || indices != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(nnz == 0 || values != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(nnz <= len, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_FOREACH(i, 0, nnz) VT_ENFORCE(indices[i] < len, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_OUT_OF_BOUNDS_ACCESS));
+
+    // copy entries
+    rac_sparse_t *sparse = rac_sparse_alloc(alloctr, len, nnz);
+    if (nnz) {
+        memcpy(sparse->indices, indices, nnz * sizeof(size_t));
+        memcpy(sparse->values, values, nnz * sizeof(rac_float));
+    }
+
+    return sparse;
+}
+
+rac_sparse_t *rac_sparse_make_dense(struct VitaBaseAllocatorType *const alloctr, const size_t len, const rac_float *const dense) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(dense != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // count nonzeros
+    size_t nnz = 0;
+    VT_FOREACH(i, 0, len) nnz += (dense[i] != 0);
+
+    // collect them in order
+    rac_sparse_t *sparse = rac_sparse_alloc(alloctr, len, nnz);
+    size_t k = 0;
+    VT_FOREACH(i, 0, len) {
+        if (dense[i] == 0) continue;
+        sparse->indices[k] = i;
+        sparse->values[k] = dense[i];
+        k++;
+    }
+
+    return sparse;
+}
+
+void rac_sparse_free(rac_sparse_t *sparse) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(sparse != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // free entries and sparse instance
+    if (sparse->alloctr) {
+        VT_ALLOCATOR_FREE(sparse->alloctr, sparse->indices);
+        VT_ALLOCATOR_FREE(sparse->alloctr, sparse->values);
+        VT_ALLOCATOR_FREE(sparse->alloctr, sparse);
+    } else {
+        VT_FREE(sparse->indices);
+        VT_FREE(sparse->values);
+        VT_FREE(sparse);
+    }
+}
+
+// -------------------------- PRIVATE -------------------------- //
+
+/**
+ * @brief Allocates a sparse vector with room for `nnz` entries
+ * @param alloctr allocator instance
+ * @param len dense length
+ * @param nnz number of entries
+ * @returns valid `rac_sparse_t*` or asserts on failure
+ */
+static rac_sparse_t *rac_sparse_alloc(struct VitaBaseAllocatorType *const alloctr, const size_t len, const size_t nnz) {
+    // allocate sparse instance and entries (at least one, so that empty vectors have valid arrays)
+    const size_t capacity = nnz ? nnz : 1;
+    rac_sparse_t *sparse = (alloctr == NULL)
+        ? VT_CALLOC(sizeof(rac_sparse_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, sizeof(rac_sparse_t));
+    size_t *indices = (alloctr == NULL)
+        ? VT_CALLOC(capacity * sizeof(size_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, capacity * sizeof(size_t));
+    rac_float *values = (alloctr == NULL)
+        ? VT_CALLOC(capacity * sizeof(rac_float))
+        : VT_ALLOCATOR_ALLOC(alloctr, capacity * sizeof(rac_float));
+
+    // init
+    *sparse = (rac_sparse_t) {
+        .len = len,
+        .nnz = nnz,
+        .indices = indices,
+        .values = values,
+        .alloctr = alloctr,
+    };
+
+    return sparse;
+}
+
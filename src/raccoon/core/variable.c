@@ -1,9 +1,26 @@
+#include <limits.h>
 #include "raccoon/core/variable.h"
+#include "raccoon/core/graph.h"
+#include "raccoon/core/pool.h"
+#include "raccoon/core/counter.h"
+#include "raccoon/auxiliary/instrument.h"
 #include "vita/math/math.h"
 
 static void rac_var_deep_walk(rac_var_t *const node_curr, vt_plist_t *const node_list);
 static void rac_var_add_backward(rac_var_t *const op_result);
+static void rac_var_sub_backward(rac_var_t *const op_result);
 static void rac_var_mul_backward(rac_var_t *const op_result);
+static void rac_var_div_backward(rac_var_t *const op_result);
+static void rac_var_fma_backward(rac_var_t *const op_result);
+static void rac_var_sqdiff_backward(rac_var_t *const op_result);
+static void rac_var_dot_backward(rac_var_t *const op_result);
+static rac_float rac_var_dot_value(const rac_var_dot_t *const dot);
+static rac_var_t *rac_var_make_fused(struct VitaBaseAllocatorType *const alloctr, const rac_float data, const char op, struct RaccoonVariable *parents[2], struct RaccoonVariable *const acc, void (*backward)(struct RaccoonVariable*));
+static rac_var_t *rac_var_alloc(struct VitaBaseAllocatorType *const alloctr, const size_t size);
+static bool rac_var_is_builtin_op(const char op);
+
+// custom operation rules, indexed by op (see `rac_var_register_op`)
+static rac_var_op_t rac_var_ops[UCHAR_MAX + 1] = {{0}};
 
 /* 
     Variable creation/destruction
@@ -15,15 +32,17 @@ rac_var_t *rac_var_make(struct VitaBaseAllocatorType *const alloctr, const rac_f
 
 rac_var_t *rac_var_make_ex(struct VitaBaseAllocatorType *const alloctr, const rac_float data, const char op, struct RaccoonVariable *parents[2], void (*backward)(struct RaccoonVariable*)) {
     // allocate for variable
-    rac_var_t *var = (alloctr == NULL)
-        ? VT_CALLOC(sizeof(rac_var_t))
-        : VT_ALLOCATOR_ALLOC(alloctr, sizeof(rac_var_t));
+    rac_var_t *var = rac_var_alloc(alloctr, sizeof(rac_var_t));
+    RAC_INSTRUMENT_ALLOC(sizeof(rac_var_t));
+    RAC_INSTRUMENT_NODE(op);
+    RAC_COUNTER_NODE(op == 0, sizeof(rac_var_t), 1);
 
-    // init
+    // init (keeps the pool flag)
     *var = (rac_var_t) {
         .data = data,
         .grad = 0,
         .op = op,
+        .flags = var->flags,
         .parents = { parents[0], parents[1] },
         .backward = backward,
         .alloctr = alloctr,
@@ -34,24 +53,55 @@ rac_var_t *rac_var_make_ex(struct VitaBaseAllocatorType *const alloctr, const ra
 
 rac_var_t *rac_var_make_rand(struct VitaBaseAllocatorType *const alloctr) {
     // allocate for variable
-    rac_var_t *var = (alloctr == NULL)
-        ? VT_CALLOC(sizeof(rac_var_t))
-        : VT_ALLOCATOR_ALLOC(alloctr, sizeof(rac_var_t));
+    rac_var_t *var = rac_var_alloc(alloctr, sizeof(rac_var_t));
+    RAC_INSTRUMENT_ALLOC(sizeof(rac_var_t));
+    RAC_INSTRUMENT_NODE(0);
+    RAC_COUNTER_NODE(true, sizeof(rac_var_t), 1);
 
-    // init
+    // init (keeps the pool flag)
     *var = (rac_var_t) {
         .data = vt_math_random_f32_uniform(0, 1),
         .grad = 0,
+        .flags = var->flags,
         .alloctr = alloctr,
     };
 
     return var;
 }
 
+rac_var_t *rac_var_make_rand_ex(struct VitaBaseAllocatorType *const alloctr, rac_random_t *const rng) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(rng != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // draw, then make a leaf
+    rac_float data = 0;
+    rac_random_uniform(rng, &data, 1, 0, 1);
+    return rac_var_make(alloctr, data);
+}
+
+rac_var_t *rac_var_make_const(struct VitaBaseAllocatorType *const alloctr, const rac_float data) {
+    rac_var_t *var = rac_var_make(alloctr, data);
+    var->flags |= RAC_VAR_FLAG_CONST;
+    return var;
+}
+
+rac_var_t *rac_var_make_placeholder(struct VitaBaseAllocatorType *const alloctr) {
+    rac_var_t *var = rac_var_make(alloctr, 0);
+    var->flags |= RAC_VAR_FLAG_PLACEHOLDER;
+    return var;
+}
+
 void rac_var_remake(rac_var_t *var, const rac_float data, const char op, struct RaccoonVariable *parents[2], void (*backward)(struct RaccoonVariable*)) {
     // check for invalid input
     VT_DEBUG_ASSERT(var != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
 
+    // track leaf <-> intermediate transitions (nodes are counted by operation)
+    if ((var->op == 0) != (op == 0)) {
+        RAC_COUNTER_NODE(var->op == 0, rac_var_bytes(var), -1);
+        RAC_COUNTER_NODE(op == 0, rac_var_bytes(var), 1);
+    }
+    const bool is_leaf = parents == NULL || (parents[0] == NULL && parents[1] == NULL);
+
     // update values
     var->grad = 0;
     var->data = data;
@@ -59,14 +109,22 @@ void rac_var_remake(rac_var_t *var, const rac_float data, const char op, struct
     var->parents[0] = parents ? parents[0] : NULL;
     var->parents[1] = parents ? parents[1] : NULL;
     var->backward = backward;
+    if (var->flags & RAC_VAR_FLAG_FUSED) ((rac_var_fused_t*)var)->acc = NULL;
+    if (!is_leaf) var->flags &= ~RAC_VAR_FLAG_CONST;
 }
 
 void rac_var_free(rac_var_t *var) {
     // check for invalid input
     VT_DEBUG_ASSERT(var != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    RAC_COUNTER_NODE(var->op == 0, rac_var_bytes(var), -1);
 
     // free variable
-    (var->alloctr) ? VT_ALLOCATOR_FREE(var->alloctr, var) : VT_FREE(var);
+    if (var->flags & RAC_VAR_FLAG_POOLED) {
+        rac_pool_release(var);
+    } else {
+        (var->alloctr) ? VT_ALLOCATOR_FREE(var->alloctr, var) : VT_FREE(var);
+    }
+    RAC_INSTRUMENT_FREE();
 }
 
 /* 
@@ -76,22 +134,25 @@ void rac_var_free(rac_var_t *var) {
 void rac_var_backward(rac_var_t *const var) {
     // check for invalid input
     VT_DEBUG_ASSERT(var != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    RAC_INSTRUMENT_SPAN_BEGIN(backward);
 
-    // build parent tree
-    vt_plist_t *node_list = rac_var_build_parent_tree(var);
+    // order nodes: every consumer is visited before the nodes it uses
+    vt_plist_t *node_list = rac_graph_topo_sort(var);
 
     // base case
     var->grad = 1;
 
-    // zero out gradients
+    // propagate gradients
     const size_t len = vt_plist_len(node_list);
-    VT_FOREACH(i, 0, len) {
+    for (size_t i = len; i-- > 0;) {
         rac_var_t *node = vt_plist_get(node_list, i);
         if (node->backward) node->backward(node);
     }
+    RAC_INSTRUMENT_BACKWARD(len);
 
     // free parent tree
     vt_plist_destroy(node_list);
+    RAC_INSTRUMENT_SPAN_END(backward, RAC_INSTRUMENT_SPAN_BACKWARD);
 }
 
 void rac_var_zero_grad(rac_var_t *const var) {
@@ -113,7 +174,7 @@ rac_var_t *rac_var_sub(rac_var_t *const lhs, rac_var_t *const rhs) {
     // check for invalid input
     VT_DEBUG_ASSERT(lhs != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
     VT_DEBUG_ASSERT(rhs != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
-    return rac_var_make_ex(lhs->alloctr, lhs->data - rhs->data, '-', (rac_var_t*[2]){lhs, rhs}, rac_var_add_backward);
+    return rac_var_make_ex(lhs->alloctr, lhs->data - rhs->data, '-', (rac_var_t*[2]){lhs, rhs}, rac_var_sub_backward);
 }
 
 rac_var_t *rac_var_mul(rac_var_t *const lhs, rac_var_t *const rhs) {
@@ -127,7 +188,7 @@ rac_var_t *rac_var_div(rac_var_t *const lhs, rac_var_t *const rhs) {
     // check for invalid input
     VT_DEBUG_ASSERT(lhs != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
     VT_DEBUG_ASSERT(rhs != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
-    return rac_var_make_ex(lhs->alloctr, lhs->data / rhs->data, '/', (rac_var_t*[2]){lhs, rhs}, rac_var_mul_backward);
+    return rac_var_make_ex(lhs->alloctr, lhs->data / rhs->data, '/', (rac_var_t*[2]){lhs, rhs}, rac_var_div_backward);
 }
 
 void rac_var_add_inplace(rac_var_t *out, rac_var_t *const lhs, rac_var_t *const rhs) {
@@ -147,7 +208,7 @@ void rac_var_sub_inplace(rac_var_t *out, rac_var_t *const lhs, rac_var_t *const
     VT_DEBUG_ASSERT(rhs != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
 
     // remake with updated variables
-    rac_var_remake(out, lhs->data - rhs->data, '-', (rac_var_t*[2]){lhs, rhs}, rac_var_add_backward);
+    rac_var_remake(out, lhs->data - rhs->data, '-', (rac_var_t*[2]){lhs, rhs}, rac_var_sub_backward);
 }
 
 void rac_var_mul_inplace(rac_var_t *out, rac_var_t *const lhs, rac_var_t *const rhs) {
@@ -167,7 +228,107 @@ void rac_var_div_inplace(rac_var_t *out, rac_var_t *const lhs, rac_var_t *const
     VT_DEBUG_ASSERT(rhs != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
 
     // remake with updated variables
-    rac_var_remake(out, lhs->data / rhs->data, '/', (rac_var_t*[2]){lhs, rhs}, rac_var_mul_backward); 
+    rac_var_remake(out, lhs->data / rhs->data, '/', (rac_var_t*[2]){lhs, rhs}, rac_var_div_backward); 
+}
+
+rac_var_t *rac_var_fma(rac_var_t *const a, rac_var_t *const b, rac_var_t *const c) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(a != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(b != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(c != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // a * b + c
+    return rac_var_make_fused(a->alloctr, RAC_FMA(a->data, b->data, c->data), 'f', (rac_var_t*[2]){a, b}, c, rac_var_fma_backward);
+}
+
+rac_var_t *rac_var_sqdiff(rac_var_t *const a, rac_var_t *const b) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(a != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(b != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // (a - b)^2
+    const rac_float diff = a->data - b->data;
+    return rac_var_make_ex(a->alloctr, diff * diff, 'q', (rac_var_t*[2]){a, b}, rac_var_sqdiff_backward);
+}
+
+rac_var_t *rac_var_sqdiff_acc(rac_var_t *const a, rac_var_t *const b, rac_var_t *const acc) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(a != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(b != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(acc != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // (a - b)^2 + acc
+    const rac_float diff = a->data - b->data;
+    return rac_var_make_fused(a->alloctr, RAC_FMA(diff, diff, acc->data), 'a', (rac_var_t*[2]){a, b}, acc, rac_var_sqdiff_backward);
+}
+
+void rac_var_fma_inplace(rac_var_t *out, rac_var_t *const a, rac_var_t *const b, rac_var_t *const c) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(out != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(a != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(b != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(c != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(out->flags & RAC_VAR_FLAG_FUSED, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // remake with updated variables
+    rac_var_remake(out, RAC_FMA(a->data, b->data, c->data), 'f', (rac_var_t*[2]){a, b}, rac_var_fma_backward);
+    ((rac_var_fused_t*)out)->acc = c;
+}
+
+void rac_var_sqdiff_inplace(rac_var_t *out, rac_var_t *const a, rac_var_t *const b) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(out != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(a != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(b != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // remake with updated variables
+    const rac_float diff = a->data - b->data;
+    rac_var_remake(out, diff * diff, 'q', (rac_var_t*[2]){a, b}, rac_var_sqdiff_backward);
+}
+
+void rac_var_sqdiff_acc_inplace(rac_var_t *out, rac_var_t *const a, rac_var_t *const b, rac_var_t *const acc) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(out != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(a != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(b != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(acc != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(out->flags & RAC_VAR_FLAG_FUSED, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // remake with updated variables
+    const rac_float diff = a->data - b->data;
+    rac_var_remake(out, RAC_FMA(diff, diff, acc->data), 'a', (rac_var_t*[2]){a, b}, rac_var_sqdiff_backward);
+    ((rac_var_fused_t*)out)->acc = acc;
+}
+
+rac_var_t *rac_var_dot(struct VitaBaseAllocatorType *const alloctr, const vt_plist_t *const weights, const rac_float *const input, const size_t len, const size_t stride) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(weights != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(input != NULL || len == 0, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(len <= vt_plist_len(weights), "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+
+    // allocate for the larger node (never from a pool)
+    rac_var_dot_t *dot = (alloctr == NULL)
+        ? VT_CALLOC(sizeof(rac_var_dot_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, sizeof(rac_var_dot_t));
+    RAC_INSTRUMENT_ALLOC(sizeof(rac_var_dot_t));
+    RAC_INSTRUMENT_NODE('d');
+    RAC_COUNTER_NODE(false, sizeof(rac_var_dot_t), 1);
+
+    // init
+    *dot = (rac_var_dot_t) {
+        .var = {
+            .op = 'd',
+            .backward = rac_var_dot_backward,
+            .alloctr = alloctr,
+        },
+        .weights = weights,
+        .input = input,
+        .len = len,
+        .stride = stride,
+    };
+    dot->var.data = rac_var_dot_value(dot);
+
+    return &dot->var;
 }
 
 void rac_var_update(rac_var_t *const var) {
@@ -175,7 +336,13 @@ void rac_var_update(rac_var_t *const var) {
     VT_DEBUG_ASSERT(var != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
 
     // update
-    if (var->parents[0] && var->parents[1]) {
+    const rac_var_op_t *rule = &rac_var_ops[(unsigned char)var->op];
+    if (var->op == 'd') {
+        var->data = rac_var_dot_value((const rac_var_dot_t*)var);
+    } else if (rule->forward && var->parents[0]) {
+        const rac_float values[RAC_VAR_PARENTS_LEN] = { var->parents[0]->data, var->parents[1] ? var->parents[1]->data : 0 };
+        var->data = rule->forward(values);
+    } else if (var->parents[0] && var->parents[1]) {
         rac_var_t *lhs = var->parents[0];
         rac_var_t *rhs = var->parents[1];
         switch(var->op) {
@@ -183,6 +350,9 @@ void rac_var_update(rac_var_t *const var) {
             case '-': rac_var_sub_inplace(var, lhs, rhs); break;
             case '*': rac_var_mul_inplace(var, lhs, rhs); break;
             case '/': rac_var_div_inplace(var, lhs, rhs); break;
+            case 'f': rac_var_fma_inplace(var, lhs, rhs, rac_var_operand(var, 2)); break;
+            case 'q': rac_var_sqdiff_inplace(var, lhs, rhs); break;
+            case 'a': rac_var_sqdiff_acc_inplace(var, lhs, rhs, rac_var_operand(var, 2)); break;
             default: break;
         }
     }
@@ -191,6 +361,126 @@ void rac_var_update(rac_var_t *const var) {
     rac_var_zero_grad(var);
 }
 
+size_t rac_var_partials(const rac_var_t *const var, rac_float partials[RAC_VAR_OPERANDS_LEN]) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(var != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(partials != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // leaves have no parents
+    VT_FOREACH(i, 0, RAC_VAR_OPERANDS_LEN) partials[i] = 0;
+    if (var->parents[0] == NULL && var->parents[1] == NULL) return 0;
+    VT_ENFORCE(rac_var_has_rule(var), "Operation '%c' has no derivative rule! Register it with `rac_var_register_op`!\n", var->op);
+
+    // custom operations
+    const rac_var_op_t *rule = &rac_var_ops[(unsigned char)var->op];
+    if (rule->derivative) {
+        const rac_float values[RAC_VAR_PARENTS_LEN] = { var->parents[0]->data, var->parents[1] ? var->parents[1]->data : 0 };
+        rule->derivative(values, var->data, partials);
+        return var->parents[1] ? 2 : 1;
+    }
+
+    // true derivatives of the built-in operations
+    const rac_var_t *lhs = var->parents[0];
+    const rac_var_t *rhs = var->parents[1];
+    switch(var->op) {
+        case '+':
+            partials[0] = partials[1] = 1;
+            return 2;
+        case '-':
+            partials[0] = 1;
+            partials[1] = -1;
+            return 2;
+        case '*':
+            partials[0] = rhs->data;
+            partials[1] = lhs->data;
+            return 2;
+        case '/':
+            partials[0] = 1 / rhs->data;
+            partials[1] = -lhs->data / (rhs->data * rhs->data);
+            return 2;
+        case 'f':
+            partials[0] = rhs->data;
+            partials[1] = lhs->data;
+            partials[2] = 1;
+            return 3;
+        case 'q':
+        case 'a':
+            partials[0] = 2 * (lhs->data - rhs->data);
+            partials[1] = -partials[0];
+            if (var->op == 'q') return 2;
+            partials[2] = 1;
+            return 3;
+        default:
+            VT_ENFORCE(false, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    }
+
+    return 0;
+}
+
+rac_var_t *rac_var_operand(const rac_var_t *const var, const size_t idx) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(var != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(idx < RAC_VAR_OPERANDS_LEN, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // parents, then the accumulator
+    if (idx < RAC_VAR_PARENTS_LEN) return var->parents[idx];
+    return (var->flags & RAC_VAR_FLAG_FUSED) ? ((const rac_var_fused_t*)var)->acc : NULL;
+}
+
+size_t rac_var_inputs_len(const rac_var_t *const var) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(var != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    return RAC_VAR_OPERANDS_LEN + ((var->op == 'd') ? ((const rac_var_dot_t*)var)->len : 0);
+}
+
+rac_var_t *rac_var_input(const rac_var_t *const var, const size_t idx) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(var != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(idx < rac_var_inputs_len(var), "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // operands, then the weights of dot products
+    if (idx < RAC_VAR_OPERANDS_LEN) return rac_var_operand(var, idx);
+    return vt_plist_get(((const rac_var_dot_t*)var)->weights, idx - RAC_VAR_OPERANDS_LEN);
+}
+
+size_t rac_var_bytes(const rac_var_t *const var) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(var != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    if (var->op == 'd') return sizeof(rac_var_dot_t);
+    return (var->flags & RAC_VAR_FLAG_FUSED) ? sizeof(rac_var_fused_t) : sizeof(rac_var_t);
+}
+
+void rac_var_register_op(const char op, const rac_var_op_t rule) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(rule.forward != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(rule.derivative != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(!rac_var_is_builtin_op(op), "Operation '%c' is built-in and cannot be registered!\n", op);
+
+    // register
+    rac_var_ops[(unsigned char)op] = rule;
+}
+
+bool rac_var_has_rule(const rac_var_t *const var) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(var != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // leaves
+    if (var->op != 'd' && var->parents[0] == NULL && var->parents[1] == NULL) return true;
+
+    // custom operations need at least the first parent
+    if (rac_var_ops[(unsigned char)var->op].forward) return var->parents[0] != NULL;
+
+    // built-in operations need all their operands
+    switch (var->op) {
+        case '+': case '-': case '*': case '/': case 'q':
+            return var->parents[0] && var->parents[1];
+        case 'f': case 'a':
+            return var->parents[0] && var->parents[1] && rac_var_operand(var, 2);
+        default:
+            return false;
+    }
+}
+
 /* 
     Other
 */
@@ -210,6 +500,20 @@ vt_plist_t *rac_var_build_parent_tree(rac_var_t *const node_start) {
 
 // -------------------------- PRIVATE -------------------------- //
 
+/**
+ * @brief Checks if an operation is implemented by the library
+ * @param op operation character
+ * @returns `true` for leaves (`0`), `{ +, -, *, / }`, fused operations `{ f, q, a }` and dot products `d`
+ */
+static bool rac_var_is_builtin_op(const char op) {
+    switch (op) {
+        case 0: case '+': case '-': case '*': case '/': case 'f': case 'q': case 'a': case 'd':
+            return true;
+        default:
+            return false;
+    }
+}
+
 /**
  * @brief Builds parent (dependency) tree
  * @param node_curr current node
@@ -226,13 +530,13 @@ static void rac_var_deep_walk(rac_var_t *const node_curr, vt_plist_t *const node
     // add node to node list
     if (vt_plist_can_find(node_list, node_curr) < 0) vt_plist_push_back(node_list, node_curr);
 
-    // traverse each parent node iteratively
-    VT_FOREACH(i, 0, RAC_VAR_PARENTS_LEN) rac_var_deep_walk(node_curr->parents[i], node_list);
+    // traverse each operand node iteratively
+    VT_FOREACH(i, 0, RAC_VAR_OPERANDS_LEN) rac_var_deep_walk(rac_var_operand(node_curr, i), node_list);
 }
 
 /**
- * @brief Performs backward operation on addition and substraction
- * @param op_result addition/substraction operation result
+ * @brief Performs backward operation on addition
+ * @param op_result addition operation result
  * @returns None
  */
 static void rac_var_add_backward(rac_var_t *const op_result) {
@@ -249,8 +553,26 @@ static void rac_var_add_backward(rac_var_t *const op_result) {
 }
 
 /**
- * @brief Performs backward operation on multiplication and division
- * @param op_result multiplication/division operation result
+ * @brief Performs backward operation on substraction
+ * @param op_result substraction operation result
+ * @returns None
+ */
+static void rac_var_sub_backward(rac_var_t *const op_result) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(op_result != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // get lhs, rhs
+    rac_var_t *const lhs = op_result->parents[0];
+    rac_var_t *const rhs = op_result->parents[1];
+
+    // perform backward operation
+    lhs->grad += op_result->grad;
+    rhs->grad -= op_result->grad;
+}
+
+/**
+ * @brief Performs backward operation on multiplication
+ * @param op_result multiplication operation result
  * @returns None
  */
 static void rac_var_mul_backward(rac_var_t *const op_result) {
@@ -266,3 +588,142 @@ static void rac_var_mul_backward(rac_var_t *const op_result) {
     rhs->grad += lhs->data * op_result->grad;
 }
 
+/**
+ * @brief Performs backward operation on division
+ * @param op_result division operation result
+ * @returns None
+ */
+static void rac_var_div_backward(rac_var_t *const op_result) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(op_result != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // get lhs, rhs
+    rac_var_t *const lhs = op_result->parents[0];
+    rac_var_t *const rhs = op_result->parents[1];
+
+    // perform backward operation: d(lhs/rhs) = 1/rhs, -lhs/rhs^2
+    const rac_float scaled = op_result->grad / rhs->data;
+    lhs->grad += scaled;
+    rhs->grad -= scaled * lhs->data / rhs->data;
+}
+
+
+/**
+ * @brief Performs backward operation on fused multiply-add
+ * @param op_result fused multiply-add operation result
+ * @returns None
+ */
+static void rac_var_fma_backward(rac_var_t *const op_result) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(op_result != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // get a, b, c
+    rac_var_t *const a = op_result->parents[0];
+    rac_var_t *const b = op_result->parents[1];
+    rac_var_t *const c = ((rac_var_fused_t*)op_result)->acc;
+
+    // perform backward operation
+    a->grad += b->data * op_result->grad;
+    b->grad += a->data * op_result->grad;
+    c->grad += op_result->grad;
+}
+
+/**
+ * @brief Performs backward operation on squared difference and its accumulation
+ * @param op_result squared difference (accumulation) operation result
+ * @returns None
+ */
+static void rac_var_sqdiff_backward(rac_var_t *const op_result) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(op_result != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // get a, b
+    rac_var_t *const a = op_result->parents[0];
+    rac_var_t *const b = op_result->parents[1];
+
+    // perform backward operation
+    const rac_float grad = 2 * (a->data - b->data) * op_result->grad;
+    a->grad += grad;
+    b->grad -= grad;
+    if (op_result->op == 'a') ((rac_var_fused_t*)op_result)->acc->grad += op_result->grad;
+}
+
+/**
+ * @brief Backward function for the dot product node
+ * @param op_result dot product node
+ * @returns None
+ */
+static void rac_var_dot_backward(rac_var_t *const op_result) {
+    const rac_var_dot_t *dot = (const rac_var_dot_t*)op_result;
+    VT_FOREACH(i, 0, dot->len) {
+        rac_var_t *w = vt_plist_get(dot->weights, i);
+        w->grad += dot->input[i * dot->stride] * op_result->grad;
+    }
+}
+
+/**
+ * @brief Computes the dot product from the current weights and input
+ * @param dot dot product node
+ * @returns ditto
+ */
+static rac_float rac_var_dot_value(const rac_var_dot_t *const dot) {
+    rac_acc_float acc = 0;
+    VT_FOREACH(i, 0, dot->len) acc += (rac_acc_float)((const rac_var_t*)vt_plist_get(dot->weights, i))->data * dot->input[i * dot->stride];
+    return (rac_float)acc;
+}
+
+/**
+ * @brief Creates a fused node with an accumulator operand
+ * @param alloctr allocator instance
+ * @param data numerical data
+ * @param op operation `{ f, a }`
+ * @param parents parent nodes
+ * @param acc accumulator node
+ * @param backward backward function
+ * @returns valid `rac_var_t*` (a `rac_var_fused_t`) or asserts on failure
+ */
+static rac_var_t *rac_var_make_fused(struct VitaBaseAllocatorType *const alloctr, const rac_float data, const char op, struct RaccoonVariable *parents[2], struct RaccoonVariable *const acc, void (*backward)(struct RaccoonVariable*)) {
+    // allocate for the larger node
+    rac_var_fused_t *fused = (rac_var_fused_t*)rac_var_alloc(alloctr, sizeof(rac_var_fused_t));
+    RAC_INSTRUMENT_ALLOC(sizeof(rac_var_fused_t));
+    RAC_INSTRUMENT_NODE(op);
+    RAC_COUNTER_NODE(false, sizeof(rac_var_fused_t), 1);
+
+    // init (keeps the pool flag)
+    *fused = (rac_var_fused_t) {
+        .var = {
+            .data = data,
+            .grad = 0,
+            .op = op,
+            .flags = fused->var.flags | RAC_VAR_FLAG_FUSED,
+            .parents = { parents[0], parents[1] },
+            .backward = backward,
+            .alloctr = alloctr,
+        },
+        .acc = acc,
+    };
+
+    return &fused->var;
+}
+
+/**
+ * @brief Allocates memory for a variable: from the thread's bound pool if there is one, from the allocator otherwise
+ * @param alloctr allocator instance
+ * @param size node size: `sizeof(rac_var_t)` or that of a larger node starting with one
+ * @returns memory for one node with only `flags` set
+ */
+static rac_var_t *rac_var_alloc(struct VitaBaseAllocatorType *const alloctr, const size_t size) {
+    rac_pool_t *pool = rac_pool_bound();
+    if (pool) {
+        rac_var_t *var = rac_pool_alloc(pool, size);
+        var->flags = RAC_VAR_FLAG_POOLED;
+        return var;
+    }
+
+    rac_var_t *var = (alloctr == NULL)
+        ? VT_CALLOC(size)
+        : VT_ALLOCATOR_ALLOC(alloctr, size);
+    var->flags = 0;
+    return var;
+}
+
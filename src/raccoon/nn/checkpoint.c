@@ -0,0 +1,152 @@
+#include "raccoon/nn/checkpoint.h"
+
+static vt_plist_t *rac_checkpoint_segment_forward(rac_checkpoint_t *const checkpoint, const size_t segment, const vt_plist_t *const input);
+static void rac_checkpoint_segment_clear(rac_checkpoint_t *const checkpoint, const size_t segment);
+static void rac_checkpoint_boundaries_clear(rac_checkpoint_t *const checkpoint);
+
+/*
+    Checkpoint creation/destruction
+*/
+
+rac_checkpoint_t *rac_checkpoint_make(struct VitaBaseAllocatorType *const alloctr, rac_mlp_t *const mlp, const size_t segment_len) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(mlp != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    const size_t layers_len = vt_plist_len(mlp->layers);
+    VT_ENFORCE(layers_len > 0, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // segment length: sqrt(layers) balances stored boundaries and recomputed layers
+    size_t len = segment_len;
+    if (len == 0) while (len * len < layers_len) len++;
+
+    // allocate checkpoint instance
+    rac_checkpoint_t *checkpoint = (alloctr == NULL)
+        ? VT_CALLOC(sizeof(rac_checkpoint_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, sizeof(rac_checkpoint_t));
+
+    // init
+    *checkpoint = (rac_checkpoint_t) {
+        .mlp = mlp,
+        .segment_len = len,
+        .segments_len = (layers_len + len - 1) / len,
+        .boundaries = vt_plist_create(VT_ARRAY_DEFAULT_INIT_ELEMENTS, alloctr),
+        .alloctr = alloctr,
+    };
+
+    return checkpoint;
+}
+
+void rac_checkpoint_free(rac_checkpoint_t *checkpoint) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(checkpoint != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // free boundaries
+    rac_checkpoint_boundaries_clear(checkpoint);
+    vt_plist_destroy(checkpoint->boundaries);
+
+    // free checkpoint
+    (checkpoint->alloctr) ? VT_ALLOCATOR_FREE(checkpoint->alloctr, checkpoint) : VT_FREE(checkpoint);
+}
+
+/*
+    Checkpoint operations
+*/
+
+vt_plist_t *rac_checkpoint_forward(rac_checkpoint_t *const checkpoint, const vt_plist_t *const input) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(checkpoint != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(input != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // release the previous step
+    rac_mlp_clear_cache(checkpoint->mlp);
+    rac_checkpoint_boundaries_clear(checkpoint);
+    checkpoint->input = input;
+
+    // forward segment by segment, keeping only boundary values
+    vt_plist_t *output = NULL;
+    const vt_plist_t *x = input;
+    VT_FOREACH(k, 0, checkpoint->segments_len) {
+        output = rac_checkpoint_segment_forward(checkpoint, k, x);
+        if (k + 1 == checkpoint->segments_len) break;
+
+        // copy the boundary into new leaves, then release the segment graph
+        const size_t output_len = vt_plist_len(output);
+        vt_plist_t *boundary = vt_plist_create(output_len, checkpoint->alloctr);
+        VT_FOREACH(j, 0, output_len) {
+            vt_plist_push_back(boundary, rac_var_make(checkpoint->alloctr, ((rac_var_t*)vt_plist_get(output, j))->data));
+        }
+        vt_plist_push_back(checkpoint->boundaries, boundary);
+        rac_checkpoint_segment_clear(checkpoint, k);
+        x = boundary;
+    }
+
+    return output;
+}
+
+void rac_checkpoint_backward(rac_checkpoint_t *const checkpoint, rac_var_t *const loss) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(checkpoint != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(loss != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(checkpoint->input != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_IS_REQUIRED));
+
+    // last segment: its graph is still alive, gradients reach the last boundary
+    rac_var_backward(loss);
+
+    // earlier segments: recompute from the stored boundary, seed with the gradients of the next boundary
+    for (size_t k = checkpoint->segments_len - 1; k-- > 0;) {
+        rac_checkpoint_segment_clear(checkpoint, k + 1);
+        const vt_plist_t *x = (k == 0) ? checkpoint->input : vt_plist_get(checkpoint->boundaries, k - 1);
+        vt_plist_t *output = rac_checkpoint_segment_forward(checkpoint, k, x);
+
+        const vt_plist_t *boundary = vt_plist_get(checkpoint->boundaries, k);
+        VT_FOREACH(j, 0, vt_plist_len(output)) {
+            ((rac_var_t*)vt_plist_get(output, j))->grad = ((const rac_var_t*)vt_plist_get(boundary, j))->grad;
+        }
+        rac_graph_backward(output);
+    }
+}
+
+// -------------------------- PRIVATE -------------------------- //
+
+/**
+ * @brief Runs the layers of a segment
+ * @param checkpoint instance
+ * @param segment segment index
+ * @param input segment input
+ * @returns output of the last layer of the segment
+ */
+static vt_plist_t *rac_checkpoint_segment_forward(rac_checkpoint_t *const checkpoint, const size_t segment, const vt_plist_t *const input) {
+    const size_t layers_len = vt_plist_len(checkpoint->mlp->layers);
+    const size_t end = ((segment + 1) * checkpoint->segment_len < layers_len) ? (segment + 1) * checkpoint->segment_len : layers_len;
+    vt_plist_t *output = (vt_plist_t*)input;
+    VT_FOREACH(i, segment * checkpoint->segment_len, end) {
+        output = rac_layer_forward(vt_plist_get(checkpoint->mlp->layers, i), output);
+    }
+    return output;
+}
+
+/**
+ * @brief Frees the graph of a segment
+ * @param checkpoint instance
+ * @param segment segment index
+ * @returns None
+ */
+static void rac_checkpoint_segment_clear(rac_checkpoint_t *const checkpoint, const size_t segment) {
+    const size_t layers_len = vt_plist_len(checkpoint->mlp->layers);
+    const size_t end = ((segment + 1) * checkpoint->segment_len < layers_len) ? (segment + 1) * checkpoint->segment_len : layers_len;
+    VT_FOREACH(i, segment * checkpoint->segment_len, end) rac_layer_clear_cache(vt_plist_get(checkpoint->mlp->layers, i));
+}
+
+/**
+ * @brief Frees all boundary activations
+ * @param checkpoint instance
+ * @returns None
+ */
+static void rac_checkpoint_boundaries_clear(rac_checkpoint_t *const checkpoint) {
+    VT_FOREACH(i, 0, vt_plist_len(checkpoint->boundaries)) {
+        vt_plist_t *boundary = vt_plist_get(checkpoint->boundaries, i);
+        VT_FOREACH(j, 0, vt_plist_len(boundary)) rac_var_free(vt_plist_get(boundary, j));
+        vt_plist_destroy(boundary);
+    }
+    vt_plist_clear(checkpoint->boundaries);
+}
+
@@ -0,0 +1,258 @@
+#include "raccoon/nn/conv.h"
+
+static void rac_conv_im2col(const rac_conv_t *const conv, const rac_float *const input, rac_float *const columns);
+static void rac_conv_col2im(const rac_conv_t *const conv, const rac_float *const columns, rac_float *const input);
+
+/*
+    Convolution creation/destruction
+*/
+
+rac_conv_t *rac_conv1d_make(
+    struct VitaBaseAllocatorType *const alloctr,
+    const size_t in_channels,
+    const size_t out_channels,
+    const size_t length,
+    const size_t kernel,
+    const size_t stride,
+    const size_t padding,
+    const size_t dilation,
+    rac_random_t *const rng
+) {
+    return rac_conv2d_make(
+        alloctr, in_channels, out_channels,
+        (size_t[]){1, length}, (size_t[]){1, kernel}, (size_t[]){1, stride}, (size_t[]){0, padding}, (size_t[]){1, dilation}, rng
+    );
+}
+
+rac_conv_t *rac_conv2d_make(
+    struct VitaBaseAllocatorType *const alloctr,
+    const size_t in_channels,
+    const size_t out_channels,
+    const size_t in_size[2],
+    const size_t kernel[2],
+    const size_t stride[2],
+    const size_t padding[2],
+    const size_t dilation[2],
+    rac_random_t *const rng
+) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(in_size != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(kernel != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(rng != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(in_channels > 0 && out_channels > 0, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // geometry
+    rac_conv_t conv = {
+        .in_channels = in_channels,
+        .out_channels = out_channels,
+        .in_size = { in_size[0], in_size[1] },
+        .kernel = { kernel[0], kernel[1] },
+        .stride = { stride ? stride[0] : 1, stride ? stride[1] : 1 },
+        .padding = { padding ? padding[0] : 0, padding ? padding[1] : 0 },
+        .dilation = { dilation ? dilation[0] : 1, dilation ? dilation[1] : 1 },
+        .alloctr = alloctr,
+    };
+    VT_FOREACH(d, 0, 2) {
+        VT_ENFORCE(conv.kernel[d] > 0 && conv.stride[d] > 0 && conv.dilation[d] > 0, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+        const size_t span = conv.dilation[d] * (conv.kernel[d] - 1) + 1;
+        VT_ENFORCE(conv.in_size[d] + 2 * conv.padding[d] >= span, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+        conv.out_size[d] = (conv.in_size[d] + 2 * conv.padding[d] - span) / conv.stride[d] + 1;
+    }
+    const size_t window = in_channels * conv.kernel[0] * conv.kernel[1];
+    const size_t positions = conv.out_size[0] * conv.out_size[1];
+    const bool direct = conv.kernel[0] * conv.kernel[1] == 1
+        && conv.stride[0] * conv.stride[1] == 1
+        && conv.padding[0] + conv.padding[1] == 0;
+
+    // allocate conv instance, parameters with gradients, and im2col buffers
+    rac_conv_t *instance = (alloctr == NULL)
+        ? VT_CALLOC(sizeof(rac_conv_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, sizeof(rac_conv_t));
+    conv.params_len = out_channels * window + out_channels;
+    rac_float *params = (alloctr == NULL)
+        ? VT_CALLOC(2 * conv.params_len * sizeof(rac_float))
+        : VT_ALLOCATOR_ALLOC(alloctr, 2 * conv.params_len * sizeof(rac_float));
+    conv.weights = params;
+    conv.bias = params + out_channels * window;
+    conv.grad_weights = params + conv.params_len;
+    conv.grad_bias = conv.grad_weights + out_channels * window;
+    if (!direct) {
+        conv.columns = (alloctr == NULL)
+            ? VT_CALLOC(2 * window * positions * sizeof(rac_float))
+            : VT_ALLOCATOR_ALLOC(alloctr, 2 * window * positions * sizeof(rac_float));
+        conv.grad_columns = conv.columns + window * positions;
+    }
+
+    // init parameters
+    *instance = conv;
+    rac_conv_init(instance, RAC_RANDOM_INIT_HE, rng);
+    memset(instance->grad_weights, 0, conv.params_len * sizeof(rac_float));
+
+    return instance;
+}
+
+void rac_conv_free(rac_conv_t *conv) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(conv != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // free buffers and conv instance
+    if (conv->alloctr) {
+        if (conv->columns) VT_ALLOCATOR_FREE(conv->alloctr, conv->columns);
+        VT_ALLOCATOR_FREE(conv->alloctr, conv->weights);
+        VT_ALLOCATOR_FREE(conv->alloctr, conv);
+    } else {
+        if (conv->columns) VT_FREE(conv->columns);
+        VT_FREE(conv->weights);
+        VT_FREE(conv);
+    }
+}
+
+/*
+    Convolution operations
+*/
+
+void rac_conv_forward(rac_conv_t *const conv, const rac_float *const input, rac_float *const output) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(conv != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(input != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(output != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // unfold windows (direct convolutions multiply the input itself)
+    const size_t window = conv->in_channels * conv->kernel[0] * conv->kernel[1];
+    const size_t positions = conv->out_size[0] * conv->out_size[1];
+    conv->input = input;
+    if (conv->columns) rac_conv_im2col(conv, input, conv->columns);
+    const rac_float *columns = conv->columns ? conv->columns : input;
+
+    // output = weights * columns + bias
+    rac_gemm(false, false, conv->out_channels, positions, window, conv->weights, columns, false, output);
+    VT_FOREACH(o, 0, conv->out_channels) {
+        rac_float *row = &output[o * positions];
+        VT_FOREACH(p, 0, positions) row[p] += conv->bias[o];
+    }
+}
+
+void rac_conv_backward(rac_conv_t *const conv, const rac_float *const grad_output, rac_float *const grad_input) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(conv != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(grad_output != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(conv->input != NULL, "%s\n", "Convolution has no forward to go back through! Call `rac_conv_forward` first!");
+
+    // parameter gradients
+    const size_t window = conv->in_channels * conv->kernel[0] * conv->kernel[1];
+    const size_t positions = conv->out_size[0] * conv->out_size[1];
+    const rac_float *columns = conv->columns ? conv->columns : conv->input;
+    rac_gemm(false, true, conv->out_channels, window, positions, grad_output, columns, true, conv->grad_weights);
+    VT_FOREACH(o, 0, conv->out_channels) {
+        rac_acc_float sum = 0;
+        VT_FOREACH(p, 0, positions) sum += grad_output[o * positions + p];
+        conv->grad_bias[o] += (rac_float)sum;
+    }
+
+    // input gradient: back through the gemm, then fold windows back onto the input
+    if (grad_input == NULL) return;
+    if (conv->columns) {
+        rac_gemm(true, false, window, positions, conv->out_channels, conv->weights, grad_output, false, conv->grad_columns);
+        rac_conv_col2im(conv, conv->grad_columns, grad_input);
+    } else {
+        rac_gemm(true, false, window, positions, conv->out_channels, conv->weights, grad_output, false, grad_input);
+    }
+}
+
+void rac_conv_zero_grad(rac_conv_t *const conv) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(conv != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    memset(conv->grad_weights, 0, conv->params_len * sizeof(rac_float));
+}
+
+void rac_conv_update(rac_conv_t *const conv, const rac_float lr) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(conv != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // weights and biases are contiguous, so are their gradients
+    VT_FOREACH(i, 0, conv->params_len) conv->weights[i] -= lr * conv->grad_weights[i];
+}
+
+void rac_conv_init(rac_conv_t *const conv, const enum RaccoonRandomInit init, rac_random_t *const rng) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(conv != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(rng != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // each output reads one window; each input feeds every filter at each tap
+    const size_t taps = conv->kernel[0] * conv->kernel[1];
+    const size_t fan_in = conv->in_channels * taps;
+    if (init == RAC_RANDOM_INIT_HE) {
+        rac_random_he(rng, conv->weights, conv->out_channels * fan_in, fan_in);
+    } else {
+        rac_random_xavier(rng, conv->weights, conv->out_channels * fan_in, fan_in, conv->out_channels * taps);
+    }
+    memset(conv->bias, 0, conv->out_channels * sizeof(rac_float));
+}
+
+// -------------------------- PRIVATE -------------------------- //
+
+/**
+ * @brief Unfolds input windows into columns: row `(c, ky, kx)`, column `(oy, ox)`; taps in the padding are zero
+ * @param conv instance
+ * @param input `[in_channels][height][width]`
+ * @param columns `[in_channels * kernel_h * kernel_w][out_h * out_w]`
+ * @returns None
+ */
+static void rac_conv_im2col(const rac_conv_t *const conv, const rac_float *const input, rac_float *const columns) {
+    const size_t height = conv->in_size[0], width = conv->in_size[1];
+    const size_t out_h = conv->out_size[0], out_w = conv->out_size[1];
+    rac_float *col = columns;
+    VT_FOREACH(c, 0, conv->in_channels) {
+        const rac_float *plane = &input[c * height * width];
+        VT_FOREACH(ky, 0, conv->kernel[0]) {
+            VT_FOREACH(kx, 0, conv->kernel[1]) {
+                VT_FOREACH(oy, 0, out_h) {
+                    const ptrdiff_t y = (ptrdiff_t)(oy * conv->stride[0] + ky * conv->dilation[0]) - (ptrdiff_t)conv->padding[0];
+                    if (y < 0 || y >= (ptrdiff_t)height) {
+                        memset(col, 0, out_w * sizeof(rac_float));
+                        col += out_w;
+                        continue;
+                    }
+                    VT_FOREACH(ox, 0, out_w) {
+                        const ptrdiff_t x = (ptrdiff_t)(ox * conv->stride[1] + kx * conv->dilation[1]) - (ptrdiff_t)conv->padding[1];
+                        *col++ = (x < 0 || x >= (ptrdiff_t)width) ? 0 : plane[(size_t)y * width + (size_t)x];
+                    }
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Folds columns back onto the input, summing overlapping windows (adjoint of `rac_conv_im2col`)
+ * @param conv instance
+ * @param columns `[in_channels * kernel_h * kernel_w][out_h * out_w]`
+ * @param input `[in_channels][height][width]` (overwritten)
+ * @returns None
+ */
+static void rac_conv_col2im(const rac_conv_t *const conv, const rac_float *const columns, rac_float *const input) {
+    const size_t height = conv->in_size[0], width = conv->in_size[1];
+    const size_t out_h = conv->out_size[0], out_w = conv->out_size[1];
+    memset(input, 0, conv->in_channels * height * width * sizeof(rac_float));
+    const rac_float *col = columns;
+    VT_FOREACH(c, 0, conv->in_channels) {
+        rac_float *plane = &input[c * height * width];
+        VT_FOREACH(ky, 0, conv->kernel[0]) {
+            VT_FOREACH(kx, 0, conv->kernel[1]) {
+                VT_FOREACH(oy, 0, out_h) {
+                    const ptrdiff_t y = (ptrdiff_t)(oy * conv->stride[0] + ky * conv->dilation[0]) - (ptrdiff_t)conv->padding[0];
+                    if (y < 0 || y >= (ptrdiff_t)height) {
+                        col += out_w;
+                        continue;
+                    }
+                    VT_FOREACH(ox, 0, out_w) {
+                        const ptrdiff_t x = (ptrdiff_t)(ox * conv->stride[1] + kx * conv->dilation[1]) - (ptrdiff_t)conv->padding[1];
+                        if (x >= 0 && x < (ptrdiff_t)width) plane[(size_t)y * width + (size_t)x] += *col;
+                        col++;
+                    }
+                }
+            }
+        }
+    }
+}
+
@@ -0,0 +1,87 @@
+#include "raccoon/nn/dropout.h"
+
+/*
+    Dropout creation/destruction
+*/
+
+rac_dropout_t *rac_dropout_make(struct VitaBaseAllocatorType *const alloctr, const rac_float rate, const size_t max_len, const rac_random_t rng) {
+    // check for invalid input
+    VT_ENFORCE(rate >= 0 && rate < 1, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(max_len > 0, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // allocate dropout instance and mask
+    rac_dropout_t *dropout = (alloctr == NULL)
+        ? VT_CALLOC(sizeof(rac_dropout_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, sizeof(rac_dropout_t));
+    rac_float *mask = (alloctr == NULL)
+        ? VT_CALLOC(max_len * sizeof(rac_float))
+        : VT_ALLOCATOR_ALLOC(alloctr, max_len * sizeof(rac_float));
+
+    // init
+    *dropout = (rac_dropout_t) {
+        .rate = rate,
+        .max_len = max_len,
+        .training = true,
+        .rng = rng,
+        .mask = mask,
+        .alloctr = alloctr,
+    };
+
+    return dropout;
+}
+
+void rac_dropout_free(rac_dropout_t *dropout) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(dropout != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // free mask and dropout instance
+    if (dropout->alloctr) {
+        VT_ALLOCATOR_FREE(dropout->alloctr, dropout->mask);
+        VT_ALLOCATOR_FREE(dropout->alloctr, dropout);
+    } else {
+        VT_FREE(dropout->mask);
+        VT_FREE(dropout);
+    }
+}
+
+/*
+    Dropout operations
+*/
+
+void rac_dropout_forward(rac_dropout_t *const dropout, const rac_float *const input, const size_t len, rac_float *const output) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(dropout != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(input != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(output != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(len <= dropout->max_len, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_OUT_OF_BOUNDS_ACCESS));
+
+    // inference: identity
+    dropout->len = len;
+    if (!dropout->training) {
+        if (output != input) memcpy(output, input, len * sizeof(rac_float));
+        return;
+    }
+
+    // uniforms in bulk, then turned into the mask in place
+    const rac_float keep = 1 / (1 - dropout->rate);
+    rac_random_uniform(&dropout->rng, dropout->mask, len, 0, 1);
+    VT_FOREACH(i, 0, len) {
+        dropout->mask[i] = (dropout->mask[i] < dropout->rate) ? 0 : keep;
+        output[i] = input[i] * dropout->mask[i];
+    }
+}
+
+void rac_dropout_backward(const rac_dropout_t *const dropout, const rac_float *const grad_output, rac_float *const grad_input) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(dropout != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(grad_output != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(grad_input != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // same mask as forward
+    if (!dropout->training) {
+        if (grad_input != grad_output) memcpy(grad_input, grad_output, dropout->len * sizeof(rac_float));
+        return;
+    }
+    VT_FOREACH(i, 0, dropout->len) grad_input[i] = grad_output[i] * dropout->mask[i];
+}
+
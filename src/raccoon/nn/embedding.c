@@ -0,0 +1,215 @@
+#include "raccoon/nn/embedding.h"
+
+static rac_float *rac_embedding_touch(rac_embedding_t *const embedding, const size_t index);
+
+/*
+    Embedding creation/destruction
+*/
+
+rac_embedding_t *rac_embedding_make(struct VitaBaseAllocatorType *const alloctr, const size_t vocab_size, const size_t dim, rac_random_t *const rng) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(rng != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(vocab_size > 0 && dim > 0, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // allocate embedding instance and table
+    rac_embedding_t *embedding = (alloctr == NULL)
+        ? VT_CALLOC(sizeof(rac_embedding_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, sizeof(rac_embedding_t));
+    rac_float *table = (alloctr == NULL)
+        ? VT_CALLOC(vocab_size * dim * sizeof(rac_float))
+        : VT_ALLOCATOR_ALLOC(alloctr, vocab_size * dim * sizeof(rac_float));
+    size_t *rows = (alloctr == NULL)
+        ? VT_CALLOC(RAC_EMBEDDING_ROWS_INIT * sizeof(size_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, RAC_EMBEDDING_ROWS_INIT * sizeof(size_t));
+    rac_float *grads = (alloctr == NULL)
+        ? VT_CALLOC(RAC_EMBEDDING_ROWS_INIT * dim * sizeof(rac_float))
+        : VT_ALLOCATOR_ALLOC(alloctr, RAC_EMBEDDING_ROWS_INIT * dim * sizeof(rac_float));
+    VT_ENFORCE(table != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_ALLOCATION));
+
+    // init
+    *embedding = (rac_embedding_t) {
+        .vocab_size = vocab_size,
+        .dim = dim,
+        .table = table,
+        .rows = rows,
+        .grads = grads,
+        .rows_capacity = RAC_EMBEDDING_ROWS_INIT,
+        .index = rac_graph_map_make(alloctr, 0),
+        .alloctr = alloctr,
+    };
+    rac_embedding_init(embedding, RAC_RANDOM_INIT_XAVIER, rng);
+
+    return embedding;
+}
+
+void rac_embedding_free(rac_embedding_t *embedding) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(embedding != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // free buffers and embedding instance
+    rac_graph_map_free(embedding->index);
+    if (embedding->alloctr) {
+        VT_ALLOCATOR_FREE(embedding->alloctr, embedding->rows);
+        VT_ALLOCATOR_FREE(embedding->alloctr, embedding->grads);
+        if (embedding->accumulators) VT_ALLOCATOR_FREE(embedding->alloctr, embedding->accumulators);
+        VT_ALLOCATOR_FREE(embedding->alloctr, embedding->table);
+        VT_ALLOCATOR_FREE(embedding->alloctr, embedding);
+    } else {
+        VT_FREE(embedding->rows);
+        VT_FREE(embedding->grads);
+        if (embedding->accumulators) VT_FREE(embedding->accumulators);
+        VT_FREE(embedding->table);
+        VT_FREE(embedding);
+    }
+}
+
+/*
+    Embedding operations
+*/
+
+const rac_float *rac_embedding_lookup(const rac_embedding_t *const embedding, const size_t index) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(embedding != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(index < embedding->vocab_size, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_OUT_OF_BOUNDS_ACCESS));
+    return &embedding->table[index * embedding->dim];
+}
+
+const rac_float *rac_embedding_grad(const rac_embedding_t *const embedding, const size_t index) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(embedding != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(index < embedding->vocab_size, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_OUT_OF_BOUNDS_ACCESS));
+
+    // untouched rows have no gradient
+    size_t k = 0;
+    if (!rac_graph_map_get(embedding->index, &embedding->table[index * embedding->dim], &k)) return NULL;
+    return &embedding->grads[k * embedding->dim];
+}
+
+void rac_embedding_forward(const rac_embedding_t *const embedding, const size_t *const indices, const size_t len, rac_float *const output) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(embedding != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(indices != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(output != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // gather
+    const size_t dim = embedding->dim;
+    VT_FOREACH(i, 0, len) memcpy(&output[i * dim], rac_embedding_lookup(embedding, indices[i]), dim * sizeof(rac_float));
+}
+
+void rac_embedding_backward(rac_embedding_t *const embedding, const size_t *const indices, const size_t len, const rac_float *const grad_output) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(embedding != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(indices != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(grad_output != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // scatter-add into the touched rows
+    const size_t dim = embedding->dim;
+    VT_FOREACH(i, 0, len) {
+        rac_float *grad = rac_embedding_touch(embedding, indices[i]);
+        VT_FOREACH(j, 0, dim) grad[j] += grad_output[i * dim + j];
+    }
+}
+
+void rac_embedding_zero_grad(rac_embedding_t *const embedding) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(embedding != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // buffers are kept for the next step
+    embedding->rows_len = 0;
+    rac_graph_map_clear(embedding->index);
+}
+
+void rac_embedding_update(rac_embedding_t *const embedding, const rac_float lr) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(embedding != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // touched rows only
+    const size_t dim = embedding->dim;
+    VT_FOREACH(k, 0, embedding->rows_len) {
+        rac_float *row = &embedding->table[embedding->rows[k] * dim];
+        const rac_float *grad = &embedding->grads[k * dim];
+        VT_FOREACH(j, 0, dim) row[j] -= lr * grad[j];
+    }
+}
+
+void rac_embedding_update_adagrad(rac_embedding_t *const embedding, const rac_float lr, const rac_float eps) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(embedding != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // optimizer state is created on first use (zeroed)
+    const size_t dim = embedding->dim;
+    if (embedding->accumulators == NULL) {
+        const size_t bytes = embedding->vocab_size * dim * sizeof(rac_float);
+        embedding->accumulators = (embedding->alloctr == NULL)
+            ? VT_CALLOC(bytes)
+            : VT_ALLOCATOR_ALLOC(embedding->alloctr, bytes);
+        VT_ENFORCE(embedding->accumulators != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_ALLOCATION));
+        if (embedding->alloctr) memset(embedding->accumulators, 0, bytes);
+    }
+
+    // touched rows only
+    VT_FOREACH(k, 0, embedding->rows_len) {
+        rac_float *row = &embedding->table[embedding->rows[k] * dim];
+        rac_float *acc = &embedding->accumulators[embedding->rows[k] * dim];
+        const rac_float *grad = &embedding->grads[k * dim];
+        VT_FOREACH(j, 0, dim) {
+            acc[j] += grad[j] * grad[j];
+            row[j] -= lr * grad[j] / (RAC_SQRT(acc[j]) + eps);
+        }
+    }
+}
+
+void rac_embedding_init(rac_embedding_t *const embedding, const enum RaccoonRandomInit init, rac_random_t *const rng) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(embedding != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(rng != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // one fill over the whole table
+    const size_t len = embedding->vocab_size * embedding->dim;
+    if (init == RAC_RANDOM_INIT_HE) {
+        rac_random_he(rng, embedding->table, len, 1);
+    } else {
+        rac_random_xavier(rng, embedding->table, len, 1, embedding->dim);
+    }
+}
+
+// -------------------------- PRIVATE -------------------------- //
+
+/**
+ * @brief Returns the gradient of a row, adding the row to the touched rows with a zero gradient if needed
+ * @param embedding instance
+ * @param index row index
+ * @returns `dim` values
+ */
+static rac_float *rac_embedding_touch(rac_embedding_t *const embedding, const size_t index) {
+    VT_ENFORCE(index < embedding->vocab_size, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_OUT_OF_BOUNDS_ACCESS));
+
+    // already touched
+    const size_t dim = embedding->dim;
+    const rac_float *key = &embedding->table[index * dim];
+    size_t k = 0;
+    if (rac_graph_map_get(embedding->index, key, &k)) return &embedding->grads[k * dim];
+
+    // grow
+    if (embedding->rows_len == embedding->rows_capacity) {
+        const size_t capacity = 2 * embedding->rows_capacity;
+        embedding->rows = (embedding->alloctr == NULL)
+            ? VT_REALLOC(embedding->rows, capacity * sizeof(size_t))
+            : VT_ALLOCATOR_REALLOC(embedding->alloctr, embedding->rows, capacity * sizeof(size_t));
+        embedding->grads = (embedding->alloctr == NULL)
+            ? VT_REALLOC(embedding->grads, capacity * dim * sizeof(rac_float))
+            : VT_ALLOCATOR_REALLOC(embedding->alloctr, embedding->grads, capacity * dim * sizeof(rac_float));
+        VT_ENFORCE(embedding->rows != NULL && embedding->grads != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_ALLOCATION));
+        embedding->rows_capacity = capacity;
+    }
+
+    // append
+    k = embedding->rows_len++;
+    embedding->rows[k] = index;
+    rac_graph_map_set(embedding->index, key, k);
+    rac_float *grad = &embedding->grads[k * dim];
+    memset(grad, 0, dim * sizeof(rac_float));
+
+    return grad;
+}
+
@@ -1,4 +1,5 @@
 #include "raccoon/nn/layer.h"
+#include "raccoon/auxiliary/instrument.h"
 
 /* 
     Layer creation/destruction
@@ -9,6 +10,7 @@ rac_layer_t *rac_layer_make(struct VitaBaseAllocatorType *const alloctr, const s
     rac_layer_t *layer = (alloctr == NULL)
         ? VT_CALLOC(sizeof(rac_layer_t))
         : VT_ALLOCATOR_ALLOC(alloctr, sizeof(rac_layer_t));
+    RAC_INSTRUMENT_ALLOC(sizeof(rac_layer_t));
 
     // init layer
     *layer = (rac_layer_t) {
@@ -40,6 +42,7 @@ void rac_layer_free(rac_layer_t *layer) {
 
     // free layer
     (layer->alloctr) ? VT_ALLOCATOR_FREE(layer->alloctr, layer) : VT_FREE(layer);
+    RAC_INSTRUMENT_FREE();
 }
 
 /* 
@@ -55,6 +58,7 @@ vt_plist_t *rac_layer_forward(rac_layer_t *const layer, const vt_plist_t *const
     const size_t input_size = vt_plist_len(input);
     const size_t layer_input_size = vt_plist_len(((rac_neuron_t*)vt_plist_get(layer->neurons, 0))->params);
     VT_ENFORCE(input_size+1 == layer_input_size, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    RAC_INSTRUMENT_SPAN_BEGIN(forward);
 
     // clear cache
     vt_plist_clear(layer->last_prediction);
@@ -65,6 +69,55 @@ vt_plist_t *rac_layer_forward(rac_layer_t *const layer, const vt_plist_t *const
         rac_neuron_t *n = vt_plist_get(layer->neurons, i);
         vt_plist_push_back(layer->last_prediction, rac_neuron_forward(n, input));
     }
+    RAC_INSTRUMENT_SPAN_END(forward, RAC_INSTRUMENT_SPAN_LAYER_FORWARD);
+
+    return layer->last_prediction;
+}
+
+vt_plist_t *rac_layer_forward_sparse(rac_layer_t *const layer, const rac_sparse_t *const input) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(layer != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(input != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // check shape
+    const size_t layer_input_size = vt_plist_len(((rac_neuron_t*)vt_plist_get(layer->neurons, 0))->params);
+    VT_ENFORCE(input->len+1 == layer_input_size, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    RAC_INSTRUMENT_SPAN_BEGIN(forward);
+
+    // clear cache
+    vt_plist_clear(layer->last_prediction);
+
+    // forward
+    const size_t neurons_len = vt_plist_len(layer->neurons);
+    VT_FOREACH(i, 0, neurons_len) {
+        rac_neuron_t *n = vt_plist_get(layer->neurons, i);
+        vt_plist_push_back(layer->last_prediction, rac_neuron_forward_sparse(n, input));
+    }
+    RAC_INSTRUMENT_SPAN_END(forward, RAC_INSTRUMENT_SPAN_LAYER_FORWARD);
+
+    return layer->last_prediction;
+}
+
+vt_plist_t *rac_layer_forward_array(rac_layer_t *const layer, const rac_float *const input, const size_t len, const size_t stride) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(layer != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(input != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // check shape
+    const size_t layer_input_size = vt_plist_len(((rac_neuron_t*)vt_plist_get(layer->neurons, 0))->params);
+    VT_ENFORCE(len+1 == layer_input_size, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    RAC_INSTRUMENT_SPAN_BEGIN(forward);
+
+    // clear cache
+    vt_plist_clear(layer->last_prediction);
+
+    // forward
+    const size_t neurons_len = vt_plist_len(layer->neurons);
+    VT_FOREACH(i, 0, neurons_len) {
+        rac_neuron_t *n = vt_plist_get(layer->neurons, i);
+        vt_plist_push_back(layer->last_prediction, rac_neuron_forward_array(n, input, len, stride));
+    }
+    RAC_INSTRUMENT_SPAN_END(forward, RAC_INSTRUMENT_SPAN_LAYER_FORWARD);
 
     return layer->last_prediction;
 }
@@ -78,12 +131,73 @@ void rac_layer_zero_grad(rac_layer_t *const layer) {
     VT_FOREACH(i, 0, neurons_len) rac_neuron_zero_grad(vt_plist_get(layer->neurons, i));
 }
 
+void rac_layer_zero_grad_sparse(rac_layer_t *const layer, const rac_sparse_t *const input) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(layer != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(input != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // zero out active gradients
+    const size_t neurons_len = vt_plist_len(layer->neurons);
+    VT_FOREACH(i, 0, neurons_len) rac_neuron_zero_grad_sparse(vt_plist_get(layer->neurons, i), input);
+}
+
+void rac_layer_clear_cache(rac_layer_t *const layer) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(layer != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // free neuron caches, the last prediction pointed into them
+    const size_t neurons_len = vt_plist_len(layer->neurons);
+    VT_FOREACH(i, 0, neurons_len) rac_neuron_clear_cache(vt_plist_get(layer->neurons, i));
+    vt_plist_clear(layer->last_prediction);
+}
+
+void rac_layer_init(rac_layer_t *const layer, const enum RaccoonRandomInit init, rac_random_t *const rng) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(layer != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(rng != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // weights of the whole layer in one fill
+    const size_t neurons_len = vt_plist_len(layer->neurons);
+    const size_t fan_in = vt_plist_len(((rac_neuron_t*)vt_plist_get(layer->neurons, 0))->params) - 1;
+    rac_float *weights = (layer->alloctr == NULL)
+        ? VT_CALLOC(neurons_len * fan_in * sizeof(rac_float))
+        : VT_ALLOCATOR_ALLOC(layer->alloctr, neurons_len * fan_in * sizeof(rac_float));
+    if (init == RAC_RANDOM_INIT_HE) {
+        rac_random_he(rng, weights, neurons_len * fan_in, fan_in);
+    } else {
+        rac_random_xavier(rng, weights, neurons_len * fan_in, fan_in, neurons_len);
+    }
+
+    // copy into the parameter nodes
+    VT_FOREACH(j, 0, neurons_len) {
+        const rac_neuron_t *neuron = vt_plist_get(layer->neurons, j);
+        VT_FOREACH(i, 0, fan_in) ((rac_var_t*)vt_plist_get(neuron->params, i))->data = weights[j * fan_in + i];
+        ((rac_var_t*)vt_plist_get(neuron->params, fan_in))->data = 0;
+    }
+
+    // free
+    (layer->alloctr) ? VT_ALLOCATOR_FREE(layer->alloctr, weights) : VT_FREE(weights);
+}
+
 void rac_layer_update(rac_layer_t *const layer, const rac_float lr) {
     // check for invalid input
     VT_DEBUG_ASSERT(layer != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    RAC_INSTRUMENT_SPAN_BEGIN(update);
 
     // zero out all gradients
     const size_t neurons_len = vt_plist_len(layer->neurons);
     VT_FOREACH(i, 0, neurons_len) rac_neuron_update(vt_plist_get(layer->neurons, i), lr);
+    RAC_INSTRUMENT_SPAN_END(update, RAC_INSTRUMENT_SPAN_LAYER_UPDATE);
 }
 
+void rac_layer_update_sparse(rac_layer_t *const layer, const rac_sparse_t *const input, const rac_float lr) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(layer != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(input != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    RAC_INSTRUMENT_SPAN_BEGIN(update);
+
+    // update active parameters
+    const size_t neurons_len = vt_plist_len(layer->neurons);
+    VT_FOREACH(i, 0, neurons_len) rac_neuron_update_sparse(vt_plist_get(layer->neurons, i), input, lr);
+    RAC_INSTRUMENT_SPAN_END(update, RAC_INSTRUMENT_SPAN_LAYER_UPDATE);
+}
@@ -1,4 +1,5 @@
 #include "raccoon/nn/mlp.h"
+#include "raccoon/auxiliary/instrument.h"
 
 /* 
     MLP creation/destruction
@@ -19,6 +20,7 @@ rac_mlp_t *rac_mlp_make(
     rac_mlp_t *mlp = (alloctr == NULL)
         ? VT_CALLOC(sizeof(rac_mlp_t))
         : VT_ALLOCATOR_ALLOC(alloctr, sizeof(rac_mlp_t));
+    RAC_INSTRUMENT_ALLOC(sizeof(rac_mlp_t));
 
     // init mlp
     *mlp = (rac_mlp_t) {
@@ -45,6 +47,7 @@ rac_mlp_t *rac_mlp_make_ex(struct VitaBaseAllocatorType *const alloctr, vt_plist
     rac_mlp_t *mlp = (alloctr == NULL)
         ? VT_CALLOC(sizeof(rac_mlp_t))
         : VT_ALLOCATOR_ALLOC(alloctr, sizeof(rac_mlp_t));
+    RAC_INSTRUMENT_ALLOC(sizeof(rac_mlp_t));
 
     // init mlp
     *mlp = (rac_mlp_t) {
@@ -66,6 +69,7 @@ void rac_mlp_free(rac_mlp_t *mlp) {
 
     // free mlp
     (mlp->alloctr) ? VT_ALLOCATOR_FREE(mlp->alloctr, mlp) : VT_FREE(mlp);
+    RAC_INSTRUMENT_FREE();
 }
 
 /* 
@@ -83,6 +87,7 @@ vt_plist_t *rac_mlp_forward(rac_mlp_t *const mlp, const vt_plist_t *const input)
     rac_neuron_t *neuron = vt_plist_get(layer->neurons, 0);
     const size_t layer_input_size = vt_plist_len(neuron->params);
     VT_ENFORCE(input_size+1 == layer_input_size, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    RAC_INSTRUMENT_SPAN_BEGIN(forward);
 
     // forward
     vt_plist_t *output = (vt_plist_t*)input;
@@ -91,6 +96,43 @@ vt_plist_t *rac_mlp_forward(rac_mlp_t *const mlp, const vt_plist_t *const input)
         rac_layer_t *l = vt_plist_get(mlp->layers, i);
         output = rac_layer_forward(l, output);
     }
+    RAC_INSTRUMENT_SPAN_END(forward, RAC_INSTRUMENT_SPAN_MLP_FORWARD);
+
+    return output;
+}
+
+vt_plist_t *rac_mlp_forward_sparse(rac_mlp_t *const mlp, const rac_sparse_t *const input) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(mlp != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(input != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    RAC_INSTRUMENT_SPAN_BEGIN(forward);
+
+    // forward: sparse first layer (checks the shape), then dense layers
+    vt_plist_t *output = rac_layer_forward_sparse(vt_plist_get(mlp->layers, 0), input);
+    const size_t layers_len = vt_plist_len(mlp->layers);
+    VT_FOREACH(i, 1, layers_len) {
+        rac_layer_t *l = vt_plist_get(mlp->layers, i);
+        output = rac_layer_forward(l, output);
+    }
+    RAC_INSTRUMENT_SPAN_END(forward, RAC_INSTRUMENT_SPAN_MLP_FORWARD);
+
+    return output;
+}
+
+vt_plist_t *rac_mlp_forward_array(rac_mlp_t *const mlp, const rac_float *const input, const size_t len, const size_t stride) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(mlp != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(input != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    RAC_INSTRUMENT_SPAN_BEGIN(forward);
+
+    // forward: first layer reads caller memory (checks the shape), then dense layers
+    vt_plist_t *output = rac_layer_forward_array(vt_plist_get(mlp->layers, 0), input, len, stride);
+    const size_t layers_len = vt_plist_len(mlp->layers);
+    VT_FOREACH(i, 1, layers_len) {
+        rac_layer_t *l = vt_plist_get(mlp->layers, i);
+        output = rac_layer_forward(l, output);
+    }
+    RAC_INSTRUMENT_SPAN_END(forward, RAC_INSTRUMENT_SPAN_MLP_FORWARD);
 
     return output;
 }
@@ -104,12 +146,55 @@ void rac_mlp_zero_grad(rac_mlp_t *const mlp) {
     VT_FOREACH(i, 0, layers_len) rac_layer_zero_grad(vt_plist_get(mlp->layers, i));
 }
 
+void rac_mlp_zero_grad_sparse(rac_mlp_t *const mlp, const rac_sparse_t *const input) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(mlp != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(input != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // sparse first layer, then dense layers
+    rac_layer_zero_grad_sparse(vt_plist_get(mlp->layers, 0), input);
+    const size_t layers_len = vt_plist_len(mlp->layers);
+    VT_FOREACH(i, 1, layers_len) rac_layer_zero_grad(vt_plist_get(mlp->layers, i));
+}
+
+void rac_mlp_clear_cache(rac_mlp_t *const mlp) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(mlp != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // free all layer caches
+    const size_t layers_len = vt_plist_len(mlp->layers);
+    VT_FOREACH(i, 0, layers_len) rac_layer_clear_cache(vt_plist_get(mlp->layers, i));
+}
+
+void rac_mlp_init(rac_mlp_t *const mlp, const enum RaccoonRandomInit init, rac_random_t *const rng) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(mlp != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // layer by layer from the same stream
+    const size_t layers_len = vt_plist_len(mlp->layers);
+    VT_FOREACH(i, 0, layers_len) rac_layer_init(vt_plist_get(mlp->layers, i), init, rng);
+}
+
 void rac_mlp_update(rac_mlp_t *const mlp, const rac_float lr) {
     // check for invalid input
     VT_DEBUG_ASSERT(mlp != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    RAC_INSTRUMENT_SPAN_BEGIN(update);
 
     // zero out all gradients
     const size_t layers_len = vt_plist_len(mlp->layers);
     VT_FOREACH(i, 0, layers_len) rac_layer_update(vt_plist_get(mlp->layers, i), lr);
+    RAC_INSTRUMENT_SPAN_END(update, RAC_INSTRUMENT_SPAN_MLP_UPDATE);
 }
 
+void rac_mlp_update_sparse(rac_mlp_t *const mlp, const rac_sparse_t *const input, const rac_float lr) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(mlp != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(input != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    RAC_INSTRUMENT_SPAN_BEGIN(update);
+
+    // sparse first layer, then dense layers
+    rac_layer_update_sparse(vt_plist_get(mlp->layers, 0), input, lr);
+    const size_t layers_len = vt_plist_len(mlp->layers);
+    VT_FOREACH(i, 1, layers_len) rac_layer_update(vt_plist_get(mlp->layers, i), lr);
+    RAC_INSTRUMENT_SPAN_END(update, RAC_INSTRUMENT_SPAN_MLP_UPDATE);
+}
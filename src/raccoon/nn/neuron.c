@@ -1,4 +1,7 @@
 #include "raccoon/nn/neuron.h"
+#include "raccoon/auxiliary/instrument.h"
+
+static rac_var_t *rac_neuron_finish(rac_neuron_t *const neuron, rac_var_t *sum, rac_acc_float acc);
 
 /* 
     Neuron creation/destruction
@@ -9,6 +12,7 @@ rac_neuron_t *rac_neuron_make(struct VitaBaseAllocatorType *const alloctr, const
     rac_neuron_t *neuron = (alloctr == NULL)
         ? VT_CALLOC(sizeof(rac_neuron_t))
         : VT_ALLOCATOR_ALLOC(alloctr, sizeof(rac_neuron_t));
+    RAC_INSTRUMENT_ALLOC(sizeof(rac_neuron_t));
 
     // init neuron
     *neuron = (rac_neuron_t) {
@@ -35,6 +39,7 @@ rac_neuron_t *rac_neuron_make_ex(struct VitaBaseAllocatorType *const alloctr, vt
     rac_neuron_t *neuron = (alloctr == NULL)
         ? VT_CALLOC(sizeof(rac_neuron_t))
         : VT_ALLOCATOR_ALLOC(alloctr, sizeof(rac_neuron_t));
+    RAC_INSTRUMENT_ALLOC(sizeof(rac_neuron_t));
 
     // init neuron
     *neuron = (rac_neuron_t) {
@@ -63,6 +68,7 @@ void rac_neuron_free(rac_neuron_t *neuron) {
 
     // free neuron
     (neuron->alloctr) ? VT_ALLOCATOR_FREE(neuron->alloctr, neuron) : VT_FREE(neuron);
+    RAC_INSTRUMENT_FREE();
 }
 
 /* 
@@ -79,7 +85,8 @@ rac_var_t *rac_neuron_forward(rac_neuron_t *const neuron, const vt_plist_t *cons
     rac_var_t *sum = rac_var_make(neuron->alloctr, 0);
     vt_plist_push_back(neuron->cache, sum);
 
-    // forward
+    // forward: node values are the rounded running sum of the accumulator
+    rac_acc_float acc = 0;
     const size_t input_size = vt_plist_len(input);
     VT_FOREACH(i, 0, input_size) {
         // find sum: last summed variable
@@ -90,22 +97,55 @@ rac_var_t *rac_neuron_forward(rac_neuron_t *const neuron, const vt_plist_t *cons
 
         // calculate sum: sum + prod
         sum = rac_var_add(sum, prod);
+        acc += (rac_acc_float)prod->data;
+        sum->data = (rac_float)acc;
 
         // add data to cache
         vt_plist_push_back(neuron->cache, prod);
         vt_plist_push_back(neuron->cache, sum);
     }
-    sum = rac_var_add(sum, vt_plist_get(neuron->params, input_size)); // add bias
+
+    return rac_neuron_finish(neuron, sum, acc);
+}
+
+rac_var_t *rac_neuron_forward_sparse(rac_neuron_t *const neuron, const rac_sparse_t *const input) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(neuron != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(input != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(input->len == vt_plist_len(neuron->params)-1, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+
+    // create sum
+    rac_var_t *sum = rac_var_make(neuron->alloctr, 0);
     vt_plist_push_back(neuron->cache, sum);
 
-    // activate
-    rac_var_t *result = sum;
-    if (neuron->activate) {
-        result = neuron->activate(sum);
-        vt_plist_push_back(neuron->cache, result);
+    // forward over nonzero entries: sum = fma(w, x, sum)
+    rac_acc_float acc = 0;
+    VT_FOREACH(k, 0, input->nnz) {
+        rac_var_t *w = vt_plist_get(neuron->params, input->indices[k]);
+        rac_var_t *x = rac_var_make_const(neuron->alloctr, input->values[k]);
+        sum = rac_var_fma(w, x, sum);
+        acc += (rac_acc_float)w->data * x->data;
+        sum->data = (rac_float)acc;
+
+        // add data to cache
+        vt_plist_push_back(neuron->cache, x);
+        vt_plist_push_back(neuron->cache, sum);
     }
 
-    return result;
+    return rac_neuron_finish(neuron, sum, acc);
+}
+
+rac_var_t *rac_neuron_forward_array(rac_neuron_t *const neuron, const rac_float *const input, const size_t len, const size_t stride) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(neuron != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(input != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(len == vt_plist_len(neuron->params)-1, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+
+    // weighted sum over caller memory
+    rac_var_t *sum = rac_var_dot(neuron->alloctr, neuron->params, input, len, stride);
+    vt_plist_push_back(neuron->cache, sum);
+
+    return rac_neuron_finish(neuron, sum, sum->data);
 }
 
 // rac_var_t *rac_neuron_forward(rac_neuron_t *const neuron, const vt_plist_t *const input) {
@@ -175,6 +215,27 @@ void rac_neuron_zero_grad(rac_neuron_t *const neuron) {
     VT_FOREACH(i, 0, params_len) rac_var_zero_grad(vt_plist_get(neuron->params, i));
 }
 
+void rac_neuron_zero_grad_sparse(rac_neuron_t *const neuron, const rac_sparse_t *const input) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(neuron != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(input != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(input->len == vt_plist_len(neuron->params)-1, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+
+    // zero out the gradients (active weights + bias)
+    VT_FOREACH(k, 0, input->nnz) rac_var_zero_grad(vt_plist_get(neuron->params, input->indices[k]));
+    rac_var_zero_grad(vt_plist_get(neuron->params, input->len));
+}
+
+void rac_neuron_clear_cache(rac_neuron_t *const neuron) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(neuron != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // free all cached data
+    const size_t cache_len = vt_plist_len(neuron->cache);
+    VT_FOREACH(i, 0, cache_len) rac_var_free(vt_plist_get(neuron->cache, i));
+    vt_plist_clear(neuron->cache);
+}
+
 void rac_neuron_update(rac_neuron_t *const neuron, const rac_float lr) {
     // check for invalid input
     VT_DEBUG_ASSERT(neuron != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
@@ -187,3 +248,43 @@ void rac_neuron_update(rac_neuron_t *const neuron, const rac_float lr) {
     }
 }
 
+void rac_neuron_update_sparse(rac_neuron_t *const neuron, const rac_sparse_t *const input, const rac_float lr) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(neuron != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(input != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(input->len == vt_plist_len(neuron->params)-1, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+
+    // update params (active weights + bias)
+    VT_FOREACH(k, 0, input->nnz + 1) {
+        rac_var_t *p = vt_plist_get(neuron->params, (k < input->nnz) ? input->indices[k] : input->len);
+        p->data -= lr * p->grad;
+    }
+}
+
+// -------------------------- PRIVATE -------------------------- //
+
+/**
+ * @brief Adds the bias to the weighted sum and applies the activation
+ * @param neuron instance
+ * @param sum last weighted sum node
+ * @param acc accumulated weighted sum
+ * @returns neuron output
+ */
+static rac_var_t *rac_neuron_finish(rac_neuron_t *const neuron, rac_var_t *sum, rac_acc_float acc) {
+    // add bias
+    const size_t input_size = vt_plist_len(neuron->params) - 1;
+    sum = rac_var_add(sum, vt_plist_get(neuron->params, input_size));
+    acc += (rac_acc_float)((rac_var_t*)vt_plist_get(neuron->params, input_size))->data;
+    sum->data = (rac_float)acc;
+    vt_plist_push_back(neuron->cache, sum);
+
+    // activate
+    rac_var_t *result = sum;
+    if (neuron->activate) {
+        result = neuron->activate(sum);
+        vt_plist_push_back(neuron->cache, result);
+    }
+
+    return result;
+}
+
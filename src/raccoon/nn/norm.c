@@ -0,0 +1,245 @@
+#include "raccoon/nn/norm.h"
+
+/*
+    Normalization creation/destruction
+*/
+
+rac_norm_t *rac_norm_make(struct VitaBaseAllocatorType *const alloctr, const enum RaccoonNormType type, const size_t features, const size_t max_batch) {
+    // check for invalid input
+    VT_ENFORCE(features > 0 && max_batch > 0, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // sizes: parameters with gradients, running statistics, normalized values, inverse deviations and mean
+    const bool batch_norm = type == RAC_NORM_BATCH;
+    const size_t inv_std_len = batch_norm ? features : max_batch;
+    const size_t buffers_len = 4 * features
+        + (batch_norm ? 2 * features : 0)
+        + max_batch * features
+        + inv_std_len
+        + (batch_norm ? features : 0);
+
+    // allocate norm instance and buffers
+    rac_norm_t *norm = (alloctr == NULL)
+        ? VT_CALLOC(sizeof(rac_norm_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, sizeof(rac_norm_t));
+    rac_float *buffers = (alloctr == NULL)
+        ? VT_CALLOC(buffers_len * sizeof(rac_float))
+        : VT_ALLOCATOR_ALLOC(alloctr, buffers_len * sizeof(rac_float));
+    memset(buffers, 0, buffers_len * sizeof(rac_float));
+
+    // init
+    *norm = (rac_norm_t) {
+        .type = type,
+        .features = features,
+        .max_batch = max_batch,
+        .gamma = buffers,
+        .beta = buffers + features,
+        .grad_gamma = buffers + 2 * features,
+        .grad_beta = buffers + 3 * features,
+        .eps = RAC_NORM_EPSILON,
+        .momentum = RAC_NORM_MOMENTUM,
+        .training = true,
+        .alloctr = alloctr,
+    };
+    rac_float *b = buffers + 4 * features;
+    if (batch_norm) {
+        norm->running_mean = b; b += features;
+        norm->running_var = b; b += features;
+    }
+    norm->normalized = b; b += max_batch * features;
+    norm->inv_std = b; b += inv_std_len;
+    if (batch_norm) {
+        norm->mean = b;
+        norm->scratch = (alloctr == NULL)
+            ? VT_CALLOC(2 * features * sizeof(rac_acc_float))
+            : VT_ALLOCATOR_ALLOC(alloctr, 2 * features * sizeof(rac_acc_float));
+    }
+
+    // identity transform, unit running variance
+    VT_FOREACH(j, 0, features) {
+        norm->gamma[j] = 1;
+        if (batch_norm) norm->running_var[j] = 1;
+    }
+
+    return norm;
+}
+
+void rac_norm_free(rac_norm_t *norm) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(norm != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // free buffers and norm instance
+    if (norm->alloctr) {
+        if (norm->scratch) VT_ALLOCATOR_FREE(norm->alloctr, norm->scratch);
+        VT_ALLOCATOR_FREE(norm->alloctr, norm->gamma);
+        VT_ALLOCATOR_FREE(norm->alloctr, norm);
+    } else {
+        if (norm->scratch) VT_FREE(norm->scratch);
+        VT_FREE(norm->gamma);
+        VT_FREE(norm);
+    }
+}
+
+/*
+    Normalization operations
+*/
+
+void rac_norm_forward(rac_norm_t *const norm, const rac_float *const input, const size_t batch, rac_float *const output) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(norm != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(input != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(output != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(batch > 0 && batch <= norm->max_batch, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_OUT_OF_BOUNDS_ACCESS));
+
+    const size_t features = norm->features;
+    norm->batch = batch;
+    if (norm->type == RAC_NORM_LAYER) {
+        VT_FOREACH(b, 0, batch) {
+            const rac_float *x = &input[b * features];
+            rac_float *y = &output[b * features], *xh = &norm->normalized[b * features];
+
+            // Welford
+            rac_acc_float mean = 0, m2 = 0;
+            VT_FOREACH(j, 0, features) {
+                const rac_acc_float delta = x[j] - mean;
+                mean += delta / (rac_acc_float)(j + 1);
+                m2 += delta * (x[j] - mean);
+            }
+            const rac_float inv_std = 1 / RAC_SQRT((rac_float)(m2 / (rac_acc_float)features) + norm->eps);
+            norm->inv_std[b] = inv_std;
+
+            // normalize, scale and shift
+            VT_FOREACH(j, 0, features) {
+                xh[j] = (x[j] - (rac_float)mean) * inv_std;
+                y[j] = norm->gamma[j] * xh[j] + norm->beta[j];
+            }
+        }
+        return;
+    }
+
+    // batch statistics (Welford over the samples, all features at once) or running statistics
+    if (norm->training) {
+        VT_ENFORCE(batch > 1, "%s\n", "Batch normalization needs at least 2 samples in training mode!");
+        rac_acc_float *mean = norm->scratch, *m2 = norm->scratch + features;
+        memset(norm->scratch, 0, 2 * features * sizeof(rac_acc_float));
+        VT_FOREACH(b, 0, batch) {
+            const rac_float *x = &input[b * features];
+            const rac_acc_float count = (rac_acc_float)(b + 1);
+            VT_FOREACH(j, 0, features) {
+                const rac_acc_float delta = x[j] - mean[j];
+                mean[j] += delta / count;
+                m2[j] += delta * (x[j] - mean[j]);
+            }
+        }
+        VT_FOREACH(j, 0, features) {
+            norm->mean[j] = (rac_float)mean[j];
+            norm->running_mean[j] += norm->momentum * (norm->mean[j] - norm->running_mean[j]);
+            norm->running_var[j] += norm->momentum * ((rac_float)(m2[j] / (rac_acc_float)(batch - 1)) - norm->running_var[j]);
+            norm->inv_std[j] = 1 / RAC_SQRT((rac_float)(m2[j] / (rac_acc_float)batch) + norm->eps);
+        }
+    } else {
+        VT_FOREACH(j, 0, features) {
+            norm->mean[j] = norm->running_mean[j];
+            norm->inv_std[j] = 1 / RAC_SQRT(norm->running_var[j] + norm->eps);
+        }
+    }
+
+    // normalize, scale and shift
+    VT_FOREACH(b, 0, batch) {
+        const rac_float *x = &input[b * features];
+        rac_float *y = &output[b * features], *xh = &norm->normalized[b * features];
+        VT_FOREACH(j, 0, features) {
+            xh[j] = (x[j] - norm->mean[j]) * norm->inv_std[j];
+            y[j] = norm->gamma[j] * xh[j] + norm->beta[j];
+        }
+    }
+}
+
+void rac_norm_backward(rac_norm_t *const norm, const rac_float *const grad_output, rac_float *const grad_input) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(norm != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(grad_output != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(norm->batch > 0, "%s\n", "Normalization has no forward to go back through! Call `rac_norm_forward` first!");
+
+    const size_t features = norm->features, batch = norm->batch;
+    if (norm->type == RAC_NORM_LAYER) {
+        // per sample: dx = inv_std * (dxh - mean(dxh) - xh * mean(dxh * xh)), with dxh = gamma * dy
+        VT_FOREACH(b, 0, batch) {
+            const rac_float *dy = &grad_output[b * features], *xh = &norm->normalized[b * features];
+            rac_acc_float sum = 0, sum_xh = 0;
+            VT_FOREACH(j, 0, features) {
+                const rac_float dxh = norm->gamma[j] * dy[j];
+                sum += dxh;
+                sum_xh += dxh * xh[j];
+                norm->grad_gamma[j] += dy[j] * xh[j];
+                norm->grad_beta[j] += dy[j];
+            }
+            if (grad_input == NULL) continue;
+            const rac_float mean = (rac_float)(sum / (rac_acc_float)features), mean_xh = (rac_float)(sum_xh / (rac_acc_float)features);
+            rac_float *dx = &grad_input[b * features];
+            VT_FOREACH(j, 0, features) dx[j] = norm->inv_std[b] * (norm->gamma[j] * dy[j] - mean - xh[j] * mean_xh);
+        }
+        return;
+    }
+
+    // per feature sums over the batch: sum(dy), sum(dy * xh)
+    rac_acc_float *sum = norm->scratch, *sum_xh = norm->scratch + features;
+    memset(norm->scratch, 0, 2 * features * sizeof(rac_acc_float));
+    VT_FOREACH(b, 0, batch) {
+        const rac_float *dy = &grad_output[b * features], *xh = &norm->normalized[b * features];
+        VT_FOREACH(j, 0, features) {
+            sum[j] += dy[j];
+            sum_xh[j] += (rac_acc_float)dy[j] * xh[j];
+        }
+    }
+    VT_FOREACH(j, 0, features) {
+        norm->grad_beta[j] += (rac_float)sum[j];
+        norm->grad_gamma[j] += (rac_float)sum_xh[j];
+    }
+    if (grad_input == NULL) return;
+
+    // training: dx = gamma * inv_std * (dy - mean(dy) - xh * mean(dy * xh)); inference statistics are constants
+    VT_FOREACH(b, 0, batch) {
+        const rac_float *dy = &grad_output[b * features], *xh = &norm->normalized[b * features];
+        rac_float *dx = &grad_input[b * features];
+        VT_FOREACH(j, 0, features) {
+            const rac_float scale = norm->gamma[j] * norm->inv_std[j];
+            dx[j] = norm->training
+                ? scale * (dy[j] - (rac_float)((sum[j] + xh[j] * sum_xh[j]) / (rac_acc_float)batch))
+                : scale * dy[j];
+        }
+    }
+}
+
+void rac_norm_zero_grad(rac_norm_t *const norm) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(norm != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    memset(norm->grad_gamma, 0, 2 * norm->features * sizeof(rac_float));
+}
+
+void rac_norm_update(rac_norm_t *const norm, const rac_float lr) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(norm != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // gamma and beta are contiguous, so are their gradients
+    VT_FOREACH(i, 0, 2 * norm->features) norm->gamma[i] -= lr * norm->grad_gamma[i];
+}
+
+void rac_norm_fold(const rac_norm_t *const norm, rac_layer_t *const layer) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(norm != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(layer != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(norm->type == RAC_NORM_BATCH, "%s\n", "Only batch normalization has fixed statistics to fold!");
+    VT_ENFORCE(vt_plist_len(layer->neurons) == norm->features, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+
+    // scale weights, shift bias
+    VT_FOREACH(j, 0, norm->features) {
+        const rac_neuron_t *neuron = vt_plist_get(layer->neurons, j);
+        VT_ENFORCE(neuron->activate == NULL, "%s\n", "Cannot fold normalization behind an activation!");
+        const rac_float scale = norm->gamma[j] / RAC_SQRT(norm->running_var[j] + norm->eps);
+        const size_t params_len = vt_plist_len(neuron->params);
+        VT_FOREACH(i, 0, params_len - 1) ((rac_var_t*)vt_plist_get(neuron->params, i))->data *= scale;
+        rac_var_t *bias = vt_plist_get(neuron->params, params_len - 1);
+        bias->data = (bias->data - norm->running_mean[j]) * scale + norm->beta[j];
+    }
+}
+
@@ -0,0 +1,236 @@
+#include "raccoon/nn/packed_mlp.h"
+#include "raccoon/core/graph.h"
+
+static rac_float rac_packed_mlp_activate_graph(const rac_packed_mlp_t *const packed, rac_var_t *(*activate)(rac_var_t *const), const rac_float x);
+static void rac_packed_mlp_copy(const rac_packed_mlp_t *const packed, rac_half_t *const storage, const rac_mlp_t *const mlp, const bool grad, const bool to_mlp);
+
+/*
+    Packed MLP creation/destruction
+*/
+
+rac_packed_mlp_t *rac_packed_mlp_make(
+    struct VitaBaseAllocatorType *const alloctr,
+    const rac_mlp_t *const mlp,
+    const enum RaccoonHalfType type,
+    const bool with_grads,
+    rac_float (*activate_hidden)(const rac_float),
+    rac_float (*activate_output)(const rac_float)
+) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(mlp != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(vt_plist_len(mlp->layers) > 0, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // find shape
+    const size_t layers_len = vt_plist_len(mlp->layers);
+    size_t *shape = (alloctr == NULL)
+        ? VT_CALLOC((layers_len + 1) * sizeof(size_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, (layers_len + 1) * sizeof(size_t));
+    size_t params_len = 0, width = 0;
+    VT_FOREACH(i, 0, layers_len) {
+        const rac_layer_t *layer = vt_plist_get(mlp->layers, i);
+        const rac_neuron_t *neuron = vt_plist_get(layer->neurons, 0);
+        shape[i] = vt_plist_len(neuron->params) - 1;
+        shape[i+1] = vt_plist_len(layer->neurons);
+        params_len += shape[i+1] * (shape[i] + 1);
+        if (shape[i+1] > width) width = shape[i+1];
+    }
+
+    // allocate packed instance
+    rac_packed_mlp_t *packed = (alloctr == NULL)
+        ? VT_CALLOC(sizeof(rac_packed_mlp_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, sizeof(rac_packed_mlp_t));
+    rac_var_t *(**activate_layers)(rac_var_t *const) = (alloctr == NULL)
+        ? VT_CALLOC(layers_len * sizeof(*activate_layers))
+        : VT_ALLOCATOR_ALLOC(alloctr, layers_len * sizeof(*activate_layers));
+    VT_FOREACH(i, 0, layers_len) activate_layers[i] = ((const rac_layer_t*)vt_plist_get(mlp->layers, i))->activate;
+    rac_half_t *storage = (alloctr == NULL)
+        ? VT_CALLOC((params_len * (with_grads ? 2 : 1) + 2 * width) * sizeof(rac_half_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, (params_len * (with_grads ? 2 : 1) + 2 * width) * sizeof(rac_half_t));
+
+    // init
+    *packed = (rac_packed_mlp_t) {
+        .type = type,
+        .num_layers = layers_len + 1,
+        .shape = shape,
+        .params = storage,
+        .params_len = params_len,
+        .grads = with_grads ? storage + params_len : NULL,
+        .activations = storage + params_len * (with_grads ? 2 : 1),
+        .width = width,
+        .activate_hidden = activate_hidden,
+        .activate_output = activate_output,
+        .activate_layers = activate_layers,
+        .alloctr = alloctr,
+    };
+
+    // convert parameters
+    rac_packed_mlp_pack(packed, mlp);
+
+    return packed;
+}
+
+void rac_packed_mlp_free(rac_packed_mlp_t *packed) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(packed != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // free storage and packed instance
+    if (packed->alloctr) {
+        VT_ALLOCATOR_FREE(packed->alloctr, packed->params);
+        VT_ALLOCATOR_FREE(packed->alloctr, packed->shape);
+        VT_ALLOCATOR_FREE(packed->alloctr, packed->activate_layers);
+        VT_ALLOCATOR_FREE(packed->alloctr, packed);
+    } else {
+        VT_FREE(packed->params);
+        VT_FREE(packed->shape);
+        VT_FREE(packed->activate_layers);
+        VT_FREE(packed);
+    }
+}
+
+/*
+    Packed MLP operations
+*/
+
+void rac_packed_mlp_pack(rac_packed_mlp_t *const packed, const rac_mlp_t *const mlp) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(packed != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(mlp != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    rac_packed_mlp_copy(packed, packed->params, mlp, false, false);
+}
+
+void rac_packed_mlp_unpack(const rac_packed_mlp_t *const packed, rac_mlp_t *const mlp) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(packed != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(mlp != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    rac_packed_mlp_copy(packed, packed->params, mlp, false, true);
+}
+
+void rac_packed_mlp_pack_grad(rac_packed_mlp_t *const packed, const rac_mlp_t *const mlp) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(packed != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(mlp != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(packed->grads != NULL, "%s\n", "Packed MLP has no gradient storage! Create it with `with_grads`!");
+    rac_packed_mlp_copy(packed, packed->grads, mlp, true, false);
+}
+
+void rac_packed_mlp_unpack_grad(const rac_packed_mlp_t *const packed, rac_mlp_t *const mlp) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(packed != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(mlp != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(packed->grads != NULL, "%s\n", "Packed MLP has no gradient storage! Create it with `with_grads`!");
+    rac_packed_mlp_copy(packed, packed->grads, mlp, true, true);
+}
+
+void rac_packed_mlp_forward(rac_packed_mlp_t *const packed, const rac_float *const input, rac_float *const output) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(packed != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(input != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(output != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // layer by layer: 16-bit activations ping-pong between two buffers
+    const enum RaccoonHalfType type = packed->type;
+    const rac_half_t *w = packed->params;
+    rac_half_t *x_half = packed->activations, *y_half = packed->activations + packed->width;
+    VT_FOREACH(l, 1, packed->num_layers) {
+        const size_t in = packed->shape[l-1], out = packed->shape[l];
+        const rac_half_t *b = w + out * in;
+        const bool last = l + 1 == packed->num_layers;
+        rac_float (*activate)(const rac_float) = last ? packed->activate_output : packed->activate_hidden;
+
+        VT_FOREACH(j, 0, out) {
+            // dot product: weights first, then bias, in the same order as `rac_neuron_forward`
+            rac_acc_float sum = 0;
+            const rac_half_t *row = w + j * in;
+            if (l == 1) {
+                VT_FOREACH(i, 0, in) sum += (rac_acc_float)rac_half_to_float(type, row[i]) * input[i];
+            } else {
+                VT_FOREACH(i, 0, in) sum += (rac_acc_float)rac_half_to_float(type, row[i]) * rac_half_to_float(type, x_half[i]);
+            }
+            rac_float y = (rac_float)(sum + rac_half_to_float(type, b[j]));
+            if (activate) {
+                y = activate(y);
+            } else if (packed->activate_layers[l-1]) {
+                y = rac_packed_mlp_activate_graph(packed, packed->activate_layers[l-1], y);
+            }
+
+            // store
+            if (last) {
+                output[j] = y;
+            } else {
+                y_half[j] = rac_half_from_float(type, y);
+            }
+        }
+
+        // next layer
+        w = b + out;
+        rac_half_t *tmp = x_half; x_half = y_half; y_half = tmp;
+    }
+}
+
+// -------------------------- PRIVATE -------------------------- //
+
+/**
+ * @brief Applies a graph activation to a plain value
+ * @param packed instance
+ * @param activate graph activation of the source model
+ * @param x input value
+ * @returns activated value
+ * @note The input leaf and every node the activation creates are freed before returning.
+ */
+static rac_float rac_packed_mlp_activate_graph(const rac_packed_mlp_t *const packed, rac_var_t *(*activate)(rac_var_t *const), const rac_float x) {
+    rac_var_t *leaf = rac_var_make(packed->alloctr, x);
+    rac_var_t *result = activate(leaf);
+    const rac_float y = result->data;
+
+    // free the temporary graph (contains the leaf unless the activation returned it as is)
+    if (result != leaf) {
+        vt_plist_t *nodes = rac_graph_topo_sort(result);
+        VT_FOREACH(i, 0, vt_plist_len(nodes)) rac_var_free(vt_plist_get(nodes, i));
+        vt_plist_destroy(nodes);
+    } else {
+        rac_var_free(leaf);
+    }
+
+    return y;
+}
+
+/**
+ * @brief Copies parameters or gradients between the packed storage and a model
+ * @param packed instance
+ * @param storage `packed->params` or `packed->grads`
+ * @param mlp model with the same shape
+ * @param grad copy gradients instead of values
+ * @param to_mlp `true`: storage -> model, `false`: model -> storage
+ * @returns None
+ */
+static void rac_packed_mlp_copy(const rac_packed_mlp_t *const packed, rac_half_t *const storage, const rac_mlp_t *const mlp, const bool grad, const bool to_mlp) {
+    // check shape
+    const size_t layers_len = vt_plist_len(mlp->layers);
+    VT_ENFORCE(layers_len + 1 == packed->num_layers, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+
+    // copy layer by layer
+    rac_half_t *w = storage;
+    VT_FOREACH(l, 0, layers_len) {
+        const rac_layer_t *layer = vt_plist_get(mlp->layers, l);
+        const size_t in = packed->shape[l], out = packed->shape[l+1];
+        VT_ENFORCE(vt_plist_len(layer->neurons) == out, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+
+        rac_half_t *b = w + out * in;
+        VT_FOREACH(j, 0, out) {
+            const rac_neuron_t *neuron = vt_plist_get(layer->neurons, j);
+            VT_ENFORCE(vt_plist_len(neuron->params) == in + 1, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+            VT_FOREACH(i, 0, in + 1) {
+                rac_var_t *p = vt_plist_get(neuron->params, i);
+                rac_half_t *value = (i < in) ? &w[j * in + i] : &b[j];
+                rac_float *field = grad ? &p->grad : &p->data;
+                if (to_mlp) {
+                    *field = rac_half_to_float(packed->type, *value);
+                } else {
+                    *value = rac_half_from_float(packed->type, *field);
+                }
+            }
+        }
+        w = b + out;
+    }
+}
+
@@ -0,0 +1,150 @@
+#include "raccoon/nn/pooling.h"
+
+/*
+    Pooling creation/destruction
+*/
+
+rac_pooling_t *rac_pooling1d_make(
+    struct VitaBaseAllocatorType *const alloctr,
+    const enum RaccoonPoolingType type,
+    const size_t channels,
+    const size_t length,
+    const size_t kernel,
+    const size_t stride
+) {
+    return rac_pooling2d_make(alloctr, type, channels, (size_t[]){1, length}, (size_t[]){1, kernel}, (size_t[]){1, stride});
+}
+
+rac_pooling_t *rac_pooling2d_make(
+    struct VitaBaseAllocatorType *const alloctr,
+    const enum RaccoonPoolingType type,
+    const size_t channels,
+    const size_t in_size[2],
+    const size_t kernel[2],
+    const size_t stride[2]
+) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(in_size != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(kernel != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(channels > 0, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // geometry
+    rac_pooling_t pooling = {
+        .type = type,
+        .channels = channels,
+        .in_size = { in_size[0], in_size[1] },
+        .kernel = { kernel[0], kernel[1] },
+        .stride = { stride ? stride[0] : kernel[0], stride ? stride[1] : kernel[1] },
+        .alloctr = alloctr,
+    };
+    VT_FOREACH(d, 0, 2) {
+        VT_ENFORCE(pooling.kernel[d] > 0 && pooling.stride[d] > 0, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+        VT_ENFORCE(pooling.in_size[d] >= pooling.kernel[d], "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+        pooling.out_size[d] = (pooling.in_size[d] - pooling.kernel[d]) / pooling.stride[d] + 1;
+    }
+
+    // allocate pooling instance and argmax buffer
+    rac_pooling_t *instance = (alloctr == NULL)
+        ? VT_CALLOC(sizeof(rac_pooling_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, sizeof(rac_pooling_t));
+    if (type == RAC_POOLING_MAX) {
+        const size_t outputs = channels * pooling.out_size[0] * pooling.out_size[1];
+        pooling.argmax = (alloctr == NULL)
+            ? VT_CALLOC(outputs * sizeof(size_t))
+            : VT_ALLOCATOR_ALLOC(alloctr, outputs * sizeof(size_t));
+    }
+    *instance = pooling;
+
+    return instance;
+}
+
+void rac_pooling_free(rac_pooling_t *pooling) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(pooling != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // free argmax and pooling instance
+    if (pooling->alloctr) {
+        if (pooling->argmax) VT_ALLOCATOR_FREE(pooling->alloctr, pooling->argmax);
+        VT_ALLOCATOR_FREE(pooling->alloctr, pooling);
+    } else {
+        if (pooling->argmax) VT_FREE(pooling->argmax);
+        VT_FREE(pooling);
+    }
+}
+
+/*
+    Pooling operations
+*/
+
+void rac_pooling_forward(rac_pooling_t *const pooling, const rac_float *const input, rac_float *const output) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(pooling != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(input != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(output != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // one output per window
+    const size_t height = pooling->in_size[0], width = pooling->in_size[1];
+    const size_t out_h = pooling->out_size[0], out_w = pooling->out_size[1];
+    const rac_float scale = (rac_float)1 / (rac_float)(pooling->kernel[0] * pooling->kernel[1]);
+    size_t o = 0;
+    VT_FOREACH(c, 0, pooling->channels) {
+        const size_t plane = c * height * width;
+        VT_FOREACH(oy, 0, out_h) {
+            VT_FOREACH(ox, 0, out_w) {
+                const size_t corner = plane + oy * pooling->stride[0] * width + ox * pooling->stride[1];
+                if (pooling->type == RAC_POOLING_MAX) {
+                    size_t best = corner;
+                    VT_FOREACH(ky, 0, pooling->kernel[0]) {
+                        VT_FOREACH(kx, 0, pooling->kernel[1]) {
+                            const size_t i = corner + ky * width + kx;
+                            if (input[i] > input[best]) best = i;
+                        }
+                    }
+                    pooling->argmax[o] = best;
+                    output[o] = input[best];
+                } else {
+                    rac_acc_float sum = 0;
+                    VT_FOREACH(ky, 0, pooling->kernel[0]) {
+                        VT_FOREACH(kx, 0, pooling->kernel[1]) sum += input[corner + ky * width + kx];
+                    }
+                    output[o] = (rac_float)sum * scale;
+                }
+                o++;
+            }
+        }
+    }
+}
+
+void rac_pooling_backward(const rac_pooling_t *const pooling, const rac_float *const grad_output, rac_float *const grad_input) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(pooling != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(grad_output != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(grad_input != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // overlapping windows add up
+    const size_t height = pooling->in_size[0], width = pooling->in_size[1];
+    const size_t out_h = pooling->out_size[0], out_w = pooling->out_size[1];
+    const size_t outputs = pooling->channels * out_h * out_w;
+    memset(grad_input, 0, pooling->channels * height * width * sizeof(rac_float));
+    if (pooling->type == RAC_POOLING_MAX) {
+        VT_FOREACH(o, 0, outputs) grad_input[pooling->argmax[o]] += grad_output[o];
+        return;
+    }
+
+    // average: every window element gets an equal share
+    const rac_float scale = (rac_float)1 / (rac_float)(pooling->kernel[0] * pooling->kernel[1]);
+    size_t o = 0;
+    VT_FOREACH(c, 0, pooling->channels) {
+        const size_t plane = c * height * width;
+        VT_FOREACH(oy, 0, out_h) {
+            VT_FOREACH(ox, 0, out_w) {
+                const size_t corner = plane + oy * pooling->stride[0] * width + ox * pooling->stride[1];
+                const rac_float share = grad_output[o++] * scale;
+                VT_FOREACH(ky, 0, pooling->kernel[0]) {
+                    VT_FOREACH(kx, 0, pooling->kernel[1]) grad_input[corner + ky * width + kx] += share;
+                }
+            }
+        }
+    }
+}
+
@@ -0,0 +1,327 @@
+#include "raccoon/nn/quant_mlp.h"
+#include "raccoon/core/graph.h"
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#endif
+
+#define RAC_QUANT_PAD(n) (((n) + RAC_QUANT_ROW_ALIGN - 1) / RAC_QUANT_ROW_ALIGN * RAC_QUANT_ROW_ALIGN)
+
+static void *rac_quant_mlp_alloc(struct VitaBaseAllocatorType *const alloctr, const size_t bytes);
+static void rac_quant_mlp_dealloc(struct VitaBaseAllocatorType *const alloctr, void *ptr);
+static rac_float rac_quant_mlp_activate(const rac_quant_mlp_t *const quant, const size_t layer, const rac_float x);
+static rac_float rac_quant_mlp_activate_graph(const rac_quant_mlp_t *const quant, rac_var_t *(*activate)(rac_var_t *const), const rac_float x);
+static uint8_t rac_quant_mlp_quantize(const rac_float value, const rac_float scale, const int32_t zero_point);
+static int32_t rac_quant_mlp_dot(const uint8_t *const x, const int8_t *const w, const size_t len);
+
+/*
+    Quantized MLP creation/destruction
+*/
+
+rac_quant_mlp_t *rac_quant_mlp_make(
+    struct VitaBaseAllocatorType *const alloctr,
+    const rac_mlp_t *const mlp,
+    const rac_float *const samples,
+    const size_t samples_len,
+    rac_float (*activate_hidden)(const rac_float),
+    rac_float (*activate_output)(const rac_float)
+) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(mlp != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(vt_plist_len(mlp->layers) > 0, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // find shape
+    const size_t layers_len = vt_plist_len(mlp->layers);
+    size_t *shape = rac_quant_mlp_alloc(alloctr, (layers_len + 1) * sizeof(size_t));
+    size_t weights_len = 0, channels_len = 0, width = 0;
+    VT_FOREACH(l, 0, layers_len) {
+        const rac_layer_t *layer = vt_plist_get(mlp->layers, l);
+        const rac_neuron_t *neuron = vt_plist_get(layer->neurons, 0);
+        shape[l] = vt_plist_len(neuron->params) - 1;
+        shape[l+1] = vt_plist_len(layer->neurons);
+        weights_len += shape[l+1] * RAC_QUANT_PAD(shape[l]);
+        channels_len += shape[l+1];
+        if (RAC_QUANT_PAD(shape[l]) > width) width = RAC_QUANT_PAD(shape[l]);
+    }
+
+    // allocate quantized instance
+    rac_quant_mlp_t *quant = rac_quant_mlp_alloc(alloctr, sizeof(rac_quant_mlp_t));
+    *quant = (rac_quant_mlp_t) {
+        .num_layers = layers_len + 1,
+        .shape = shape,
+        .weights = rac_quant_mlp_alloc(alloctr, weights_len * sizeof(int8_t)),
+        .weight_scales = rac_quant_mlp_alloc(alloctr, channels_len * sizeof(rac_float)),
+        .biases = rac_quant_mlp_alloc(alloctr, channels_len * sizeof(rac_float)),
+        .row_sums = rac_quant_mlp_alloc(alloctr, channels_len * sizeof(int32_t)),
+        .input_scales = rac_quant_mlp_alloc(alloctr, layers_len * sizeof(rac_float)),
+        .input_zero_points = rac_quant_mlp_alloc(alloctr, layers_len * sizeof(int32_t)),
+        .activations = rac_quant_mlp_alloc(alloctr, 2 * width * sizeof(uint8_t)),
+        .width = width,
+        .activate_hidden = activate_hidden,
+        .activate_output = activate_output,
+        .activate_layers = rac_quant_mlp_alloc(alloctr, layers_len * sizeof(rac_var_t *(*)(rac_var_t *const))),
+        .alloctr = alloctr,
+    };
+    VT_FOREACH(l, 0, layers_len) quant->activate_layers[l] = ((const rac_layer_t*)vt_plist_get(mlp->layers, l))->activate;
+
+    // quantize weights: symmetric per output channel, padding stays zero
+    int8_t *w = quant->weights;
+    size_t channel = 0;
+    VT_FOREACH(l, 0, layers_len) {
+        const rac_layer_t *layer = vt_plist_get(mlp->layers, l);
+        const size_t in = shape[l], stride = RAC_QUANT_PAD(in);
+        VT_FOREACH(j, 0, shape[l+1]) {
+            const rac_neuron_t *neuron = vt_plist_get(layer->neurons, j);
+            VT_ENFORCE(vt_plist_len(neuron->params) == in + 1, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+
+            // scale from the largest magnitude
+            rac_float amax = 0;
+            VT_FOREACH(i, 0, in) amax = RAC_MAX(amax, RAC_ABS(((rac_var_t*)vt_plist_get(neuron->params, i))->data));
+            const rac_float scale = (amax > 0) ? amax / 127 : 1;
+
+            // quantize
+            int32_t row_sum = 0;
+            VT_FOREACH(i, 0, in) {
+                const rac_float q = RAC_ROUND(((rac_var_t*)vt_plist_get(neuron->params, i))->data / scale);
+                w[j * stride + i] = (int8_t)((q > 127) ? 127 : (q < -127) ? -127 : q);
+                row_sum += w[j * stride + i];
+            }
+            quant->weight_scales[channel] = scale;
+            quant->biases[channel] = ((rac_var_t*)vt_plist_get(neuron->params, in))->data;
+            quant->row_sums[channel] = row_sum;
+            channel++;
+        }
+        w += shape[l+1] * stride;
+    }
+
+    // calibrate activation ranges
+    rac_quant_mlp_calibrate(quant, mlp, samples, samples_len);
+
+    return quant;
+}
+
+void rac_quant_mlp_free(rac_quant_mlp_t *quant) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(quant != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // free arrays and quantized instance
+    struct VitaBaseAllocatorType *alloctr = quant->alloctr;
+    rac_quant_mlp_dealloc(alloctr, quant->activate_layers);
+    rac_quant_mlp_dealloc(alloctr, quant->activations);
+    rac_quant_mlp_dealloc(alloctr, quant->input_zero_points);
+    rac_quant_mlp_dealloc(alloctr, quant->input_scales);
+    rac_quant_mlp_dealloc(alloctr, quant->row_sums);
+    rac_quant_mlp_dealloc(alloctr, quant->biases);
+    rac_quant_mlp_dealloc(alloctr, quant->weight_scales);
+    rac_quant_mlp_dealloc(alloctr, quant->weights);
+    rac_quant_mlp_dealloc(alloctr, quant->shape);
+    rac_quant_mlp_dealloc(alloctr, quant);
+}
+
+/*
+    Quantized MLP operations
+*/
+
+void rac_quant_mlp_calibrate(rac_quant_mlp_t *const quant, const rac_mlp_t *const mlp, const rac_float *const samples, const size_t samples_len) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(quant != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(mlp != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(samples != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(samples_len > 0, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(vt_plist_len(mlp->layers) + 1 == quant->num_layers, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+
+    // ranges of every layer input, zero included so that it is represented exactly
+    const size_t layers_len = quant->num_layers - 1;
+    rac_float *lo = quant->input_scales;
+    rac_float *hi = rac_quant_mlp_alloc(quant->alloctr, layers_len * sizeof(rac_float));
+    VT_FOREACH(l, 0, layers_len) lo[l] = hi[l] = 0;
+
+    // run the float model on every sample
+    rac_float *buffer = rac_quant_mlp_alloc(quant->alloctr, 2 * quant->width * sizeof(rac_float));
+    VT_FOREACH(s, 0, samples_len) {
+        rac_float *x = buffer, *y = buffer + quant->width;
+        memcpy(x, samples + s * quant->shape[0], quant->shape[0] * sizeof(rac_float));
+        VT_FOREACH(l, 0, layers_len) {
+            const rac_layer_t *layer = vt_plist_get(mlp->layers, l);
+            const size_t in = quant->shape[l], out = quant->shape[l+1];
+            VT_FOREACH(i, 0, in) {
+                lo[l] = RAC_MIN(lo[l], x[i]);
+                hi[l] = RAC_MAX(hi[l], x[i]);
+            }
+            if (l + 1 == layers_len) break;
+
+            // forward in the same order as `rac_neuron_forward`
+            VT_FOREACH(j, 0, out) {
+                const rac_neuron_t *neuron = vt_plist_get(layer->neurons, j);
+                rac_acc_float sum = 0;
+                VT_FOREACH(i, 0, in) sum += (rac_acc_float)((rac_var_t*)vt_plist_get(neuron->params, i))->data * x[i];
+                y[j] = rac_quant_mlp_activate(quant, l, (rac_float)(sum + ((rac_var_t*)vt_plist_get(neuron->params, in))->data));
+            }
+            rac_float *tmp = x; x = y; y = tmp;
+        }
+    }
+    rac_quant_mlp_dealloc(quant->alloctr, buffer);
+
+    // asymmetric scale and zero point (`lo` and `input_scales` share storage)
+    VT_FOREACH(l, 0, layers_len) {
+        const rac_float range = hi[l] - lo[l];
+        const rac_float scale = (range > 0) ? range / RAC_QUANT_ACTIVATION_MAX : 1;
+        const rac_float zero_point = RAC_ROUND(-lo[l] / scale);
+        quant->input_zero_points[l] = (int32_t)((zero_point > RAC_QUANT_ACTIVATION_MAX) ? RAC_QUANT_ACTIVATION_MAX : zero_point);
+        quant->input_scales[l] = scale;
+    }
+    rac_quant_mlp_dealloc(quant->alloctr, hi);
+}
+
+void rac_quant_mlp_forward(rac_quant_mlp_t *const quant, const rac_float *const input, rac_float *const output) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(quant != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(input != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(output != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // quantize input; stale values in the padding meet zero weights
+    uint8_t *x = quant->activations, *y = quant->activations + quant->width;
+    VT_FOREACH(i, 0, quant->shape[0]) x[i] = rac_quant_mlp_quantize(input[i], quant->input_scales[0], quant->input_zero_points[0]);
+
+    // layer by layer: int32 accumulation, requantization into the next layer's input
+    const int8_t *w = quant->weights;
+    size_t channel = 0;
+    VT_FOREACH(l, 1, quant->num_layers) {
+        const size_t out = quant->shape[l], stride = RAC_QUANT_PAD(quant->shape[l-1]);
+        const rac_float input_scale = quant->input_scales[l-1];
+        const int32_t zero_point = quant->input_zero_points[l-1];
+        const bool last = l + 1 == quant->num_layers;
+
+        VT_FOREACH(j, 0, out) {
+            // sum(w * (x - zp)) = sum(w * x) - zp * sum(w)
+            const int32_t acc = rac_quant_mlp_dot(x, w + j * stride, stride) - zero_point * quant->row_sums[channel + j];
+            const rac_float value = rac_quant_mlp_activate(quant, l-1, (rac_float)acc * (quant->weight_scales[channel + j] * input_scale) + quant->biases[channel + j]);
+
+            // store
+            if (last) {
+                output[j] = value;
+            } else {
+                y[j] = rac_quant_mlp_quantize(value, quant->input_scales[l], quant->input_zero_points[l]);
+            }
+        }
+
+        // next layer
+        w += out * stride;
+        channel += out;
+        uint8_t *tmp = x; x = y; y = tmp;
+    }
+}
+
+// -------------------------- PRIVATE -------------------------- //
+
+/**
+ * @brief Allocates zeroed memory
+ * @param alloctr allocator instance
+ * @param bytes size in bytes
+ * @returns valid pointer or asserts on failure
+ */
+static void *rac_quant_mlp_alloc(struct VitaBaseAllocatorType *const alloctr, const size_t bytes) {
+    return (alloctr == NULL) ? VT_CALLOC(bytes) : VT_ALLOCATOR_ALLOC(alloctr, bytes);
+}
+
+/**
+ * @brief Frees memory allocated by `rac_quant_mlp_alloc`
+ * @param alloctr allocator instance
+ * @param ptr pointer
+ * @returns None
+ */
+static void rac_quant_mlp_dealloc(struct VitaBaseAllocatorType *const alloctr, void *ptr) {
+    if (alloctr) {
+        VT_ALLOCATOR_FREE(alloctr, ptr);
+    } else {
+        VT_FREE(ptr);
+    }
+}
+
+/**
+ * @brief Applies the activation of a layer: the scalar one if given, otherwise the model's graph activation
+ * @param quant instance
+ * @param layer layer index (0 is the first hidden layer)
+ * @param x input value
+ * @returns activated value
+ */
+static rac_float rac_quant_mlp_activate(const rac_quant_mlp_t *const quant, const size_t layer, const rac_float x) {
+    rac_float (*activate)(const rac_float) = (layer + 2 == quant->num_layers) ? quant->activate_output : quant->activate_hidden;
+    if (activate) return activate(x);
+    return quant->activate_layers[layer] ? rac_quant_mlp_activate_graph(quant, quant->activate_layers[layer], x) : x;
+}
+
+/**
+ * @brief Applies a graph activation to a plain value
+ * @param quant instance
+ * @param activate graph activation of the source model
+ * @param x input value
+ * @returns activated value
+ * @note The input leaf and every node the activation creates are freed before returning.
+ */
+static rac_float rac_quant_mlp_activate_graph(const rac_quant_mlp_t *const quant, rac_var_t *(*activate)(rac_var_t *const), const rac_float x) {
+    rac_var_t *leaf = rac_var_make(quant->alloctr, x);
+    rac_var_t *result = activate(leaf);
+    const rac_float y = result->data;
+
+    // free the temporary graph (contains the leaf unless the activation returned it as is)
+    if (result != leaf) {
+        vt_plist_t *nodes = rac_graph_topo_sort(result);
+        VT_FOREACH(i, 0, vt_plist_len(nodes)) rac_var_free(vt_plist_get(nodes, i));
+        vt_plist_destroy(nodes);
+    } else {
+        rac_var_free(leaf);
+    }
+
+    return y;
+}
+
+/**
+ * @brief Quantizes an activation
+ * @param value value
+ * @param scale activation scale
+ * @param zero_point activation zero point
+ * @returns value in [0, RAC_QUANT_ACTIVATION_MAX]
+ */
+static uint8_t rac_quant_mlp_quantize(const rac_float value, const rac_float scale, const int32_t zero_point) {
+    const rac_float q = RAC_ROUND(value / scale) + zero_point;
+    return (uint8_t)((q > RAC_QUANT_ACTIVATION_MAX) ? RAC_QUANT_ACTIVATION_MAX : (q < 0) ? 0 : q);
+}
+
+/**
+ * @brief Dot product of unsigned 8-bit activations and signed 8-bit weights
+ * @param x activations
+ * @param w weights
+ * @param len number of values, a multiple of RAC_QUANT_ROW_ALIGN
+ * @returns int32 sum
+ */
+static int32_t rac_quant_mlp_dot(const uint8_t *const x, const int8_t *const w, const size_t len) {
+#if defined(__AVX2__)
+    // 32 products per step, accumulated into 8 int32 lanes
+    __m256i acc = _mm256_setzero_si256();
+    #if !(defined(__AVX512VNNI__) && defined(__AVX512VL__))
+        const __m256i ones = _mm256_set1_epi16(1);
+    #endif
+    for (size_t i = 0; i < len; i += RAC_QUANT_ROW_ALIGN) {
+        const __m256i xv = _mm256_loadu_si256((const __m256i*)(x + i));
+        const __m256i wv = _mm256_loadu_si256((const __m256i*)(w + i));
+    #if defined(__AVX512VNNI__) && defined(__AVX512VL__)
+        acc = _mm256_dpbusd_epi32(acc, xv, wv);
+    #else
+        // pairs are summed into int16 (cannot saturate: 2 * 127 * 127 < INT16_MAX), then widened to int32
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(_mm256_maddubs_epi16(xv, wv), ones));
+    #endif
+    }
+
+    // horizontal sum
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(sum);
+#else
+    int32_t acc = 0;
+    VT_FOREACH(i, 0, len) acc += (int32_t)x[i] * w[i];
+    return acc;
+#endif
+}
+
@@ -0,0 +1,287 @@
+#include "raccoon/nn/recurrent.h"
+#include "vita/math/math.h"
+
+static rac_float rac_recurrent_sigmoid(const rac_float x);
+
+/*
+    Recurrent layer creation/destruction
+*/
+
+rac_recurrent_t *rac_recurrent_make(
+    struct VitaBaseAllocatorType *const alloctr,
+    const enum RaccoonRecurrentType type,
+    const size_t input_size,
+    const size_t hidden_size,
+    const size_t window,
+    rac_random_t *const rng
+) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(rng != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(input_size > 0 && hidden_size > 0 && window > 0, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // sizes
+    const bool gru = type == RAC_RECURRENT_GRU, lstm = type == RAC_RECURRENT_LSTM;
+    const size_t gates = hidden_size * (lstm ? 4 : gru ? 3 : 1);
+    const size_t params_len = gates * (input_size + hidden_size + 1);
+    const size_t buffers_len = hidden_size                          // hidden
+        + (lstm ? hidden_size : 0)                                  // cell
+        + (window + 1) * hidden_size                                // hiddens
+        + (lstm ? (window + 1) * hidden_size : 0)                   // cells
+        + window * gates                                            // activations
+        + (gru ? window * hidden_size : 0)                          // candidates
+        + window * gates                                            // grad_gates
+        + (gru ? window * gates : 0)                                // grad_recurrent
+        + gates + 3 * hidden_size;                                  // scratch
+
+    // allocate recurrent instance, parameters with gradients, and buffers
+    rac_recurrent_t *rnn = (alloctr == NULL)
+        ? VT_CALLOC(sizeof(rac_recurrent_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, sizeof(rac_recurrent_t));
+    rac_float *params = (alloctr == NULL)
+        ? VT_CALLOC(2 * params_len * sizeof(rac_float))
+        : VT_ALLOCATOR_ALLOC(alloctr, 2 * params_len * sizeof(rac_float));
+    rac_float *buffers = (alloctr == NULL)
+        ? VT_CALLOC(buffers_len * sizeof(rac_float))
+        : VT_ALLOCATOR_ALLOC(alloctr, buffers_len * sizeof(rac_float));
+    memset(buffers, 0, buffers_len * sizeof(rac_float));
+
+    // init
+    *rnn = (rac_recurrent_t) {
+        .type = type,
+        .input_size = input_size,
+        .hidden_size = hidden_size,
+        .gates = gates,
+        .window = window,
+        .weights_input = params,
+        .weights_hidden = params + gates * input_size,
+        .bias = params + gates * (input_size + hidden_size),
+        .params_len = params_len,
+        .grad_weights_input = params + params_len,
+        .grad_weights_hidden = params + params_len + gates * input_size,
+        .grad_bias = params + params_len + gates * (input_size + hidden_size),
+        .alloctr = alloctr,
+    };
+    rac_float *b = buffers;
+    rnn->hidden = b; b += hidden_size;
+    if (lstm) { rnn->cell = b; b += hidden_size; }
+    rnn->hiddens = b; b += (window + 1) * hidden_size;
+    if (lstm) { rnn->cells = b; b += (window + 1) * hidden_size; }
+    rnn->activations = b; b += window * gates;
+    if (gru) { rnn->candidates = b; b += window * hidden_size; }
+    rnn->grad_gates = b; b += window * gates;
+    if (gru) { rnn->grad_recurrent = b; b += window * gates; }
+    rnn->scratch = b;
+
+    // init parameters
+    rac_recurrent_init(rnn, RAC_RANDOM_INIT_XAVIER, rng);
+    memset(rnn->grad_weights_input, 0, params_len * sizeof(rac_float));
+
+    return rnn;
+}
+
+void rac_recurrent_free(rac_recurrent_t *rnn) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(rnn != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // free buffers and recurrent instance
+    if (rnn->alloctr) {
+        VT_ALLOCATOR_FREE(rnn->alloctr, rnn->hidden);
+        VT_ALLOCATOR_FREE(rnn->alloctr, rnn->weights_input);
+        VT_ALLOCATOR_FREE(rnn->alloctr, rnn);
+    } else {
+        VT_FREE(rnn->hidden);
+        VT_FREE(rnn->weights_input);
+        VT_FREE(rnn);
+    }
+}
+
+/*
+    Recurrent layer operations
+*/
+
+void rac_recurrent_reset(rac_recurrent_t *const rnn) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(rnn != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // zero state
+    memset(rnn->hidden, 0, rnn->hidden_size * sizeof(rac_float));
+    if (rnn->cell) memset(rnn->cell, 0, rnn->hidden_size * sizeof(rac_float));
+}
+
+void rac_recurrent_forward(rac_recurrent_t *const rnn, const rac_float *const input, const size_t steps, rac_float *const output) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(rnn != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(input != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(output != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(steps > 0 && steps <= rnn->window, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_OUT_OF_BOUNDS_ACCESS));
+
+    // start from the carried state
+    const size_t hid = rnn->hidden_size, gates = rnn->gates;
+    rnn->input = input;
+    rnn->steps = steps;
+    memcpy(rnn->hiddens, rnn->hidden, hid * sizeof(rac_float));
+    if (rnn->cells) memcpy(rnn->cells, rnn->cell, hid * sizeof(rac_float));
+
+    // input products of all steps at once: activations[t] = weights_input * x[t]
+    rac_gemm(false, true, steps, gates, rnn->input_size, input, rnn->weights_input, false, rnn->activations);
+
+    // time loop: one product for all gates, then the cell
+    rac_float *rec = rnn->scratch;
+    const rac_float *b = rnn->bias;
+    VT_FOREACH(t, 0, steps) {
+        rac_float *act = &rnn->activations[t * gates];
+        const rac_float *hp = &rnn->hiddens[t * hid];
+        rac_float *h = &rnn->hiddens[(t + 1) * hid];
+        rac_gemm(false, false, gates, 1, hid, rnn->weights_hidden, hp, false, rec);
+        switch (rnn->type) {
+            case RAC_RECURRENT_RNN:
+                VT_FOREACH(j, 0, hid) act[j] = h[j] = RAC_TANH(act[j] + rec[j] + b[j]);
+                break;
+            case RAC_RECURRENT_GRU:
+                VT_FOREACH(j, 0, hid) {
+                    const rac_float r = rac_recurrent_sigmoid(act[j] + rec[j] + b[j]);
+                    const rac_float u = rac_recurrent_sigmoid(act[hid + j] + rec[hid + j] + b[hid + j]);
+                    const rac_float n = RAC_TANH(act[2 * hid + j] + b[2 * hid + j] + r * rec[2 * hid + j]);
+                    rnn->candidates[t * hid + j] = rec[2 * hid + j];
+                    act[j] = r;
+                    act[hid + j] = u;
+                    act[2 * hid + j] = n;
+                    h[j] = (1 - u) * n + u * hp[j];
+                }
+                break;
+            case RAC_RECURRENT_LSTM: {
+                const rac_float *cp = &rnn->cells[t * hid];
+                rac_float *c = &rnn->cells[(t + 1) * hid];
+                VT_FOREACH(j, 0, hid) {
+                    const rac_float i = rac_recurrent_sigmoid(act[j] + rec[j] + b[j]);
+                    const rac_float f = rac_recurrent_sigmoid(act[hid + j] + rec[hid + j] + b[hid + j]);
+                    const rac_float g = RAC_TANH(act[2 * hid + j] + rec[2 * hid + j] + b[2 * hid + j]);
+                    const rac_float o = rac_recurrent_sigmoid(act[3 * hid + j] + rec[3 * hid + j] + b[3 * hid + j]);
+                    act[j] = i;
+                    act[hid + j] = f;
+                    act[2 * hid + j] = g;
+                    act[3 * hid + j] = o;
+                    c[j] = f * cp[j] + i * g;
+                    h[j] = o * RAC_TANH(c[j]);
+                }
+            } break;
+        }
+        memcpy(&output[t * hid], h, hid * sizeof(rac_float));
+    }
+
+    // carry the state over to the next window
+    memcpy(rnn->hidden, &rnn->hiddens[steps * hid], hid * sizeof(rac_float));
+    if (rnn->cells) memcpy(rnn->cell, &rnn->cells[steps * hid], hid * sizeof(rac_float));
+}
+
+void rac_recurrent_backward(rac_recurrent_t *const rnn, const rac_float *const grad_output, rac_float *const grad_input) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(rnn != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(grad_output != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(rnn->input != NULL, "%s\n", "Recurrent layer has no forward to go back through! Call `rac_recurrent_forward` first!");
+
+    // gradients flowing back to the previous step
+    const size_t hid = rnn->hidden_size, gates = rnn->gates, steps = rnn->steps;
+    rac_float *dh = rnn->scratch + gates, *dc = dh + hid, *dprev = dc + hid;
+    memset(dh, 0, 2 * hid * sizeof(rac_float));
+
+    // time loop in reverse: gate gradients of each step
+    rac_float *grad_recurrent = rnn->grad_recurrent ? rnn->grad_recurrent : rnn->grad_gates;
+    for (size_t t = steps; t-- > 0;) {
+        const rac_float *act = &rnn->activations[t * gates];
+        const rac_float *hp = &rnn->hiddens[t * hid];
+        rac_float *dg = &rnn->grad_gates[t * gates];
+        rac_float *dr = &grad_recurrent[t * gates];
+        VT_FOREACH(j, 0, hid) dh[j] += grad_output[t * hid + j];
+        switch (rnn->type) {
+            case RAC_RECURRENT_RNN:
+                VT_FOREACH(j, 0, hid) dg[j] = dh[j] * (1 - act[j] * act[j]);
+                break;
+            case RAC_RECURRENT_GRU:
+                VT_FOREACH(j, 0, hid) {
+                    const rac_float r = act[j], u = act[hid + j], n = act[2 * hid + j];
+                    const rac_float dn = dh[j] * (1 - u) * (1 - n * n);
+                    dg[j] = dr[j] = dn * rnn->candidates[t * hid + j] * r * (1 - r);
+                    dg[hid + j] = dr[hid + j] = dh[j] * (hp[j] - n) * u * (1 - u);
+                    dg[2 * hid + j] = dn;
+                    dr[2 * hid + j] = dn * r;
+                }
+                break;
+            case RAC_RECURRENT_LSTM: {
+                const rac_float *cp = &rnn->cells[t * hid];
+                const rac_float *c = &rnn->cells[(t + 1) * hid];
+                VT_FOREACH(j, 0, hid) {
+                    const rac_float i = act[j], f = act[hid + j], g = act[2 * hid + j], o = act[3 * hid + j];
+                    const rac_float tc = RAC_TANH(c[j]);
+                    const rac_float dcj = dc[j] + dh[j] * o * (1 - tc * tc);
+                    dg[j] = dcj * g * i * (1 - i);
+                    dg[hid + j] = dcj * cp[j] * f * (1 - f);
+                    dg[2 * hid + j] = dcj * i * (1 - g * g);
+                    dg[3 * hid + j] = dh[j] * tc * o * (1 - o);
+                    dc[j] = dcj * f;
+                }
+            } break;
+        }
+
+        // back through the hidden product (GRU also keeps the direct path through `u`)
+        rac_gemm(true, false, hid, 1, gates, rnn->weights_hidden, dr, false, dprev);
+        if (rnn->type == RAC_RECURRENT_GRU) {
+            VT_FOREACH(j, 0, hid) dh[j] = dprev[j] + dh[j] * act[hid + j];
+        } else {
+            memcpy(dh, dprev, hid * sizeof(rac_float));
+        }
+    }
+
+    // parameter gradients of the whole window at once
+    VT_FOREACH(t, 0, steps) {
+        VT_FOREACH(g, 0, gates) rnn->grad_bias[g] += rnn->grad_gates[t * gates + g];
+    }
+    rac_gemm(true, false, gates, rnn->input_size, steps, rnn->grad_gates, rnn->input, true, rnn->grad_weights_input);
+    rac_gemm(true, false, gates, hid, steps, grad_recurrent, rnn->hiddens, true, rnn->grad_weights_hidden);
+
+    // input gradient
+    if (grad_input) rac_gemm(false, false, steps, rnn->input_size, gates, rnn->grad_gates, rnn->weights_input, false, grad_input);
+}
+
+void rac_recurrent_zero_grad(rac_recurrent_t *const rnn) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(rnn != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    memset(rnn->grad_weights_input, 0, rnn->params_len * sizeof(rac_float));
+}
+
+void rac_recurrent_update(rac_recurrent_t *const rnn, const rac_float lr) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(rnn != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // all parameters are contiguous, so are their gradients
+    VT_FOREACH(i, 0, rnn->params_len) rnn->weights_input[i] -= lr * rnn->grad_weights_input[i];
+}
+
+void rac_recurrent_init(rac_recurrent_t *const rnn, const enum RaccoonRandomInit init, rac_random_t *const rng) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(rnn != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(rng != NULL, "%s\n", rac_status_to_str(RAC_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // input and hidden weights have their own fan-in
+    const size_t in = rnn->input_size, hid = rnn->hidden_size;
+    if (init == RAC_RANDOM_INIT_HE) {
+        rac_random_he(rng, rnn->weights_input, rnn->gates * in, in);
+        rac_random_he(rng, rnn->weights_hidden, rnn->gates * hid, hid);
+    } else {
+        rac_random_xavier(rng, rnn->weights_input, rnn->gates * in, in, hid);
+        rac_random_xavier(rng, rnn->weights_hidden, rnn->gates * hid, hid, hid);
+    }
+    memset(rnn->bias, 0, rnn->gates * sizeof(rac_float));
+}
+
+// -------------------------- PRIVATE -------------------------- //
+
+/**
+ * @brief Logistic function
+ * @param x value
+ * @returns `1 / (1 + exp(-x))`
+ */
+static rac_float rac_recurrent_sigmoid(const rac_float x) {
+    return 1 / (1 + RAC_EXP(-x));
+}
+
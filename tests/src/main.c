@@ -1,5 +1,13 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+    #define _POSIX_C_SOURCE 200809L // mkdtemp
+#endif
+
 #include "raccoon/raccoon.h"
 #include "vita/vita.h"
+#include <inttypes.h>
+#if !defined(_WIN32)
+    #include <unistd.h>
+#endif
 
 // test suite
 static int test_num = 0;
@@ -19,14 +27,40 @@ void test_tape(void);
 void test_neuron(void);
 void test_layer(void);
 void test_mlp(void);
+void test_instrument(void);
+void test_memory(void);
+void test_jit(void);
+void test_static_mlp(void);
+void test_packed_mlp(void);
+void test_quant_mlp(void);
+void test_jvp(void);
+void test_grad(void);
+void test_checkpoint(void);
+void test_sparse(void);
+void test_schedule(void);
+void test_pool(void);
+void test_static_graph(void);
+void test_array(void);
+void test_conv(void);
+void test_recurrent(void);
+void test_embedding(void);
+void test_norm(void);
+void test_random(void);
 
 /**
  * HELPER FUNCTIONS
  */
 
 void plist_var_free(vt_plist_t *list);
+rac_var_t *act_square(rac_var_t *const x);
+rac_float act_square_scalar(const rac_float x);
+rac_var_t *act_square_op(rac_var_t *const x);
+rac_float op_square_forward(const rac_float values[RAC_VAR_PARENTS_LEN]);
+void op_square_derivative(const rac_float values[RAC_VAR_PARENTS_LEN], const rac_float value, rac_float partials[RAC_VAR_PARENTS_LEN]);
+void op_square_backward(rac_var_t *const op_result);
 
 static vt_mallocator_t *alloctr = NULL;
+RAC_DEFINE_MLP(tiny, 3, 5, 1, linear)
 int main(void) {
     vt_version_t 
         vt_v = vt_version_get(),
@@ -42,6 +76,25 @@ int main(void) {
         TEST(test_neuron);
         TEST(test_layer);
         TEST(test_mlp);
+        TEST(test_instrument);
+        TEST(test_memory);
+        TEST(test_jit);
+        TEST(test_static_mlp);
+        TEST(test_packed_mlp);
+        TEST(test_quant_mlp);
+        TEST(test_jvp);
+        TEST(test_grad);
+        TEST(test_checkpoint);
+        TEST(test_sparse);
+        TEST(test_schedule);
+        TEST(test_pool);
+        TEST(test_static_graph);
+        TEST(test_array);
+        TEST(test_conv);
+        TEST(test_recurrent);
+        TEST(test_embedding);
+        TEST(test_norm);
+        TEST(test_random);
     }
     vt_mallocator_print_stats(alloctr->stats);
     vt_mallocator_destroy(alloctr);
@@ -109,7 +162,7 @@ void test_var(void) {
     rac_var_backward(c);
     assert(c->grad == 1);
     assert(a->grad == 1);
-    assert(b->grad == 1);
+    assert(b->grad == -1);
 
     // zero grad
     rac_var_zero_grad(c);
@@ -167,11 +220,11 @@ void test_var(void) {
     assert(c->parents[0] == a && c->parents[1] == b);
     assert(c->backward != NULL);
 
-    // backward
+    // backward: d/da = 1/b, d/db = -a/b^2
     rac_var_backward(c);
     assert(c->grad == 1);
-    assert(a->grad == 3);
-    assert(b->grad == 6);
+    assert(RAC_ABS(a->grad - (rac_float)1 / 3) < 1e-6);
+    assert(RAC_ABS(b->grad + (rac_float)2 / 3) < 1e-6);
 
     // zero grad
     rac_var_zero_grad(c);
@@ -186,6 +239,27 @@ void test_var(void) {
     rac_var_free(b);
     rac_var_free(c);
     
+    /**
+     * SHARED CONSUMERS: a node used by several operations gets all contributions before its own backward runs
+     */
+
+    // b * (b + a) with b = a * a: a^4 + a^3, derivative = 4a^3 + 3a^2 = 135 at a = 3
+    a = rac_var_make(alloctr, 3);
+    b = rac_var_mul(a, a);
+    c = rac_var_add(b, a);
+    rac_var_t *shared = rac_var_mul(b, c);
+    rac_var_backward(shared);
+    assert(shared->data == 108);
+    assert(c->grad == 9);
+    assert(b->grad == 21);
+    assert(a->grad == 135);
+
+    // free
+    rac_var_free(shared);
+    rac_var_free(c);
+    rac_var_free(b);
+    rac_var_free(a);
+
     /**
      * REMAKE: reinit existing variable
      * INPLACE: inplace operations
@@ -201,11 +275,11 @@ void test_var(void) {
     
     // check values
     assert(a->data == 6);
-    assert(a->grad == 2);
+    assert(a->grad == 0.5);
     assert(a->parents[0] == NULL && a->parents[1] == NULL);
     assert(a->backward == NULL);
     assert(b->data == 2);
-    assert(b->grad == 6);
+    assert(b->grad == -1.5);
     assert(b->parents[0] == NULL && b->parents[1] == NULL);
     assert(b->backward == NULL);
     assert(c->data == 3);
@@ -426,6 +500,185 @@ void test_tape(void) {
 
     // free tape
     rac_tape_free(tape);
+
+    /**
+     * OPTIMIZE: constant folding, CSE and dead node elimination
+     */
+
+    // record the same graph twice: out = (a*b + b*a) * (k1 * k2), with an unused (a - b)
+    rac_tape_t *tapes[2] = { rac_tape_make(alloctr), rac_tape_make(alloctr) };
+    rac_var_t *inputs[2][2] = {{NULL}};
+    VT_FOREACH(t, 0, 2) {
+        rac_var_t *x0 = rac_var_make(alloctr, 3);
+        rac_var_t *x1 = rac_var_make(alloctr, 4);
+        rac_var_t *k1 = rac_var_make_const(alloctr, 2);
+        rac_var_t *k2 = rac_var_make_const(alloctr, 5);
+        rac_var_t *k = rac_var_mul(k1, k2);
+        rac_var_t *p0 = rac_var_mul(x0, x1);
+        rac_var_t *p1 = rac_var_mul(x1, x0);
+        rac_var_t *s = rac_var_add(p0, p1);
+        rac_var_t *unused = rac_var_sub(x0, x1);
+        rac_var_t *out = rac_var_mul(s, k);
+        rac_tape_push_ex(tapes[t], 10, (rac_var_t*[]){x0, x1, k1, k2, k, p0, p1, s, unused, out});
+        inputs[t][0] = x0;
+        inputs[t][1] = x1;
+    }
+    rac_tape_compile_ex(tapes[0], RAC_TAPE_OPTIMIZE_NONE);
+    rac_tape_compile(tapes[1]);
+    assert(vt_plist_len(tapes[0]->list) == 10);
+    assert(vt_plist_len(tapes[1]->list) == 6); // x0, x1, k, p0, s, out
+    assert(vt_plist_len(tapes[1]->pruned) == 4);
+    assert(rac_tape_get(tapes[1], 2)->flags & RAC_VAR_FLAG_CONST);
+
+    // replay with new inputs: results and gradients are identical
+    VT_FOREACH(t, 0, 2) {
+        inputs[t][0]->data = -1;
+        inputs[t][1]->data = 7;
+        rac_tape_update(tapes[t]);
+        rac_var_backward(rac_tape_last(tapes[t]));
+    }
+    assert(rac_tape_last(tapes[0])->data == rac_tape_last(tapes[1])->data);
+    assert(rac_tape_last(tapes[1])->data == -140);
+    assert(inputs[0][0]->grad == inputs[1][0]->grad);
+    assert(inputs[0][1]->grad == inputs[1][1]->grad);
+    assert(inputs[1][0]->grad == 140);
+
+    // free tapes
+    rac_tape_free(tapes[0]);
+    rac_tape_free(tapes[1]);
+
+    /**
+     * FUSE: multiply-add, squared difference and its accumulation
+     */
+
+    // record loss = (w0*x0 + w1*x1 + bias - y)^2 + prev three times: unfused, fused and pruned, fused only
+    rac_tape_t *fuse_tapes[3] = { rac_tape_make(alloctr), rac_tape_make(alloctr), rac_tape_make(alloctr) };
+    rac_var_t *weights[3] = {NULL}, *losses[3] = {NULL};
+    VT_FOREACH(t, 0, 3) {
+        rac_var_t *w0 = rac_var_make(alloctr, 2);
+        rac_var_t *w1 = rac_var_make(alloctr, -1);
+        rac_var_t *x0 = rac_var_make(alloctr, 3);
+        rac_var_t *x1 = rac_var_make(alloctr, 4);
+        rac_var_t *bias = rac_var_make(alloctr, 1);
+        rac_var_t *y = rac_var_make(alloctr, 5);
+        rac_var_t *prev = rac_var_make(alloctr, 10);
+        rac_var_t *m0 = rac_var_mul(w0, x0);
+        rac_var_t *s0 = rac_var_add(bias, m0);
+        rac_var_t *m1 = rac_var_mul(w1, x1);
+        rac_var_t *s1 = rac_var_add(s0, m1);
+        rac_var_t *diff = rac_var_sub(s1, y);
+        rac_var_t *sq = rac_var_mul(diff, diff);
+        rac_var_t *loss = rac_var_add(sq, prev);
+        rac_tape_push_ex(fuse_tapes[t], 14, (rac_var_t*[]){w0, w1, x0, x1, bias, y, prev, m0, s0, m1, s1, diff, sq, loss});
+        weights[t] = w0;
+        losses[t] = loss;
+        assert(loss->data == 14);
+    }
+    rac_tape_compile_ex(fuse_tapes[0], RAC_TAPE_OPTIMIZE_NONE);
+    rac_tape_compile_ex(fuse_tapes[1], RAC_TAPE_OPTIMIZE_ALL);
+    rac_tape_compile_ex(fuse_tapes[2], RAC_TAPE_OPTIMIZE_FUSE);
+    assert(vt_plist_len(fuse_tapes[1]->list) == 11); // 7 leaves, 2 fma, sqdiff, output add
+    assert(vt_plist_len(fuse_tapes[1]->pruned) == 2 + 3); // replaced adds, absorbed nodes
+    assert(rac_tape_get(fuse_tapes[1], 7)->op == 'f');
+    assert(rac_tape_get(fuse_tapes[1], 8)->op == 'f');
+    assert(rac_tape_get(fuse_tapes[1], 9)->op == 'q');
+    assert(rac_tape_get(fuse_tapes[1], 8)->flags & RAC_VAR_FLAG_FUSED);
+    assert(vt_plist_len(fuse_tapes[2]->list) == 14 && vt_plist_len(fuse_tapes[2]->pruned) == 2);
+
+    // the output keeps its identity
+    VT_FOREACH(t, 0, 3) assert(rac_tape_last(fuse_tapes[t]) == losses[t] && losses[t]->op == '+');
+    assert(sizeof(rac_var_t) < sizeof(rac_var_fused_t)); // only fused nodes carry the accumulator
+
+    // replay with new weights: results and gradients are identical
+    VT_FOREACH(t, 0, 3) {
+        weights[t]->data = 3;
+        rac_tape_update(fuse_tapes[t]);
+        rac_var_backward(rac_tape_last(fuse_tapes[t]));
+        assert(rac_tape_last(fuse_tapes[t])->data == 11);
+        assert(weights[t]->grad == 6);
+        assert(rac_tape_get(fuse_tapes[t], 5)->grad == -2);
+        assert(rac_tape_get(fuse_tapes[t], 6)->grad == 1);
+    }
+
+    // fusion preserves the gradient of every leaf (the first 7 nodes of each tape)
+    VT_FOREACH(t, 1, 3) {
+        VT_FOREACH(i, 0, 7) assert(rac_tape_get(fuse_tapes[t], i)->grad == rac_tape_get(fuse_tapes[0], i)->grad);
+    }
+
+    // free tapes
+    VT_FOREACH(t, 0, 3) rac_tape_free(fuse_tapes[t]);
+
+    /**
+     * LEVELS: independent per-feature transforms replay level by level
+     */
+
+    // record out = sum_i (x_i * s_i + c_i) twice: sequential (not compiled) and level replay (compiled)
+    enum { FEATURES = 96 };
+    rac_tape_t *level_tapes[2] = { rac_tape_make(alloctr), rac_tape_make(alloctr) };
+    rac_var_t *features[2][FEATURES] = {{NULL}};
+    VT_FOREACH(t, 0, 2) {
+        rac_var_t *sum = rac_var_make(alloctr, 0);
+        rac_tape_push(level_tapes[t], sum);
+        VT_FOREACH(i, 0, FEATURES) {
+            rac_var_t *x = rac_var_make(alloctr, (rac_float)i);
+            rac_var_t *scale = rac_var_make_const(alloctr, 0.5);
+            rac_var_t *shift = rac_var_make_const(alloctr, -1);
+            rac_var_t *y = rac_var_add(rac_var_mul(x, scale), shift);
+            rac_tape_push_ex(level_tapes[t], 5, (rac_var_t*[]){x, scale, shift, y->parents[0], y});
+            features[t][i] = x;
+        }
+        VT_FOREACH(i, 0, FEATURES) {
+            sum = rac_var_add(sum, rac_tape_get(level_tapes[t], 5 * i + 5));
+            rac_tape_push(level_tapes[t], sum);
+        }
+    }
+    rac_tape_compile_ex(level_tapes[1], RAC_TAPE_OPTIMIZE_NONE);
+    assert(level_tapes[0]->levels == NULL);
+    assert(level_tapes[1]->width >= RAC_TAPE_PARALLEL_MIN); // all products, then all shifted values
+    assert(level_tapes[1]->levels_len == 2 + FEATURES + 1);
+
+    // replay with new inputs: every node matches the sequential replay
+    VT_FOREACH(t, 0, 2) {
+        VT_FOREACH(i, 0, FEATURES) features[t][i]->data = (rac_float)(FEATURES - i) / 3;
+        rac_tape_update(level_tapes[t]);
+    }
+    VT_FOREACH(i, 0, vt_plist_len(level_tapes[0]->list)) {
+        assert(rac_tape_get(level_tapes[0], i)->data == rac_tape_get(level_tapes[1], i)->data);
+    }
+
+    /**
+     * CHANGED: only nodes downstream of a marked input are recomputed
+     */
+
+    // one feature changes: its product, shifted value and the sums from it onwards
+    features[0][90]->data = 7;
+    features[1][90]->data = 7;
+    rac_tape_update(level_tapes[0]);
+    rac_tape_mark_changed(level_tapes[1], features[1][90]);
+    assert(rac_tape_update_changed(level_tapes[1]) == 3 + (FEATURES - 90));
+    VT_FOREACH(i, 0, vt_plist_len(level_tapes[0]->list)) {
+        assert(rac_tape_get(level_tapes[0], i)->data == rac_tape_get(level_tapes[1], i)->data);
+    }
+    assert(rac_tape_update_changed(level_tapes[1]) == 0);
+
+    // dot products depend on their weights: a changed weight recomputes the product and its consumers
+    const rac_float dot_input[2] = {2, 3};
+    vt_plist_t *dot_weights = vt_plist_create(2, alloctr);
+    VT_FOREACH(i, 0, 2) vt_plist_push_back(dot_weights, rac_var_make(alloctr, 1));
+    rac_tape_t *dot_tape = rac_tape_make(alloctr);
+    rac_var_t *dot = rac_var_dot(alloctr, dot_weights, dot_input, 2, 1);
+    rac_var_t *dot_bias = rac_var_make(alloctr, 1);
+    rac_tape_push_ex(dot_tape, 3, (rac_var_t*[]){dot, dot_bias, rac_var_add(dot, dot_bias)});
+    rac_tape_compile(dot_tape);
+    ((rac_var_t*)vt_plist_get(dot_weights, 1))->data = 2;
+    rac_tape_mark_changed(dot_tape, vt_plist_get(dot_weights, 1));
+    assert(rac_tape_update_changed(dot_tape) == 2);
+    assert(rac_tape_get(dot_tape, 2)->data == 9);
+
+    // free tapes
+    VT_FOREACH(t, 0, 2) rac_tape_free(level_tapes[t]);
+    rac_tape_free(dot_tape);
+    plist_var_free(dot_weights);
 }
 
 void test_neuron(void) {
@@ -483,10 +736,10 @@ void test_neuron(void) {
     // free
     rac_var_free(loss);
     
-    // check gradient values
-    assert(((rac_var_t*)vt_plist_get(params, 0))->grad == ((rac_var_t*)vt_plist_get(input, 0))->data);
-    assert(((rac_var_t*)vt_plist_get(params, 1))->grad == ((rac_var_t*)vt_plist_get(input, 1))->data);
-    assert(((rac_var_t*)vt_plist_get(params, 2))->grad == 1);
+    // check gradient values: the prediction is subtracted
+    assert(((rac_var_t*)vt_plist_get(params, 0))->grad == -((rac_var_t*)vt_plist_get(input, 0))->data);
+    assert(((rac_var_t*)vt_plist_get(params, 1))->grad == -((rac_var_t*)vt_plist_get(input, 1))->data);
+    assert(((rac_var_t*)vt_plist_get(params, 2))->grad == -1);
 
     /**
      * TRAINING:
@@ -774,11 +1027,1528 @@ void test_mlp(void) {
     rac_var_free(batch_size);
 }
 
+void test_instrument(void) {
+    // reset counters
+    rac_instrument_reset();
+    const struct RaccoonInstrumentStats *stats = rac_instrument_get_stats();
+    assert(stats->nodes_total == 0);
+    assert(stats->backward_calls == 0);
+
+    // model
+    rac_mlp_t *model = rac_mlp_make(alloctr, 3, (size_t[]){2, 3, 1}, NULL, NULL);
+    vt_plist_t *input = vt_plist_create(2, alloctr);
+    vt_plist_push_back(input, rac_var_make(alloctr, 1));
+    vt_plist_push_back(input, rac_var_make(alloctr, 2));
+
+    // one training step
+    vt_plist_t *out = rac_mlp_forward(model, input);
+    rac_mlp_zero_grad(model);
+    rac_var_backward(vt_plist_get(out, 0));
+    rac_mlp_update(model, 0.01);
+
+#if defined(RACCOON_USE_INSTRUMENTATION)
+    // leaves: 13 random params, 2 inputs and (sum = 0) for each of 4 neurons
+    assert(stats->nodes[0] == 13 + 2 + 4);
+
+    // forward: each neuron creates input_size * (mul + add) + bias add
+    assert(stats->nodes['*'] == 3 * 2 + 1 * 3);
+    assert(stats->nodes['+'] == 3 * (2+1) + 1 * (3+1));
+    assert(stats->nodes[0] + stats->nodes['*'] + stats->nodes['+'] == stats->nodes_total);
+
+    // backward, spans
+    assert(stats->backward_calls == 1);
+    assert(stats->span_calls[RAC_INSTRUMENT_SPAN_MLP_FORWARD] == 1);
+    assert(stats->span_calls[RAC_INSTRUMENT_SPAN_LAYER_FORWARD] == 2);
+    assert(stats->span_calls[RAC_INSTRUMENT_SPAN_BACKWARD] == 1);
+    assert(stats->span_calls[RAC_INSTRUMENT_SPAN_MLP_UPDATE] == 1);
+    assert(stats->alloc_calls > stats->nodes_total);
+
+    // trace
+    assert(rac_instrument_dump_trace("trace.json"));
+    remove("trace.json");
+
+    // free trace buffer: counters are reset, recording keeps working
+    rac_instrument_free();
+    assert(stats->nodes_total == 0 && stats->span_calls[RAC_INSTRUMENT_SPAN_MLP_FORWARD] == 0);
+    RAC_INSTRUMENT_SPAN_BEGIN(test);
+    RAC_INSTRUMENT_SPAN_END(test, RAC_INSTRUMENT_SPAN_MLP_FORWARD);
+    assert(stats->span_calls[RAC_INSTRUMENT_SPAN_MLP_FORWARD] == 1);
+    rac_instrument_free();
+#else
+    assert(stats->nodes_total == 0);
+#endif
+
+    // free
+    plist_var_free(input);
+    rac_mlp_free(model);
+}
+
+void test_memory(void) {
+    // live nodes
+    struct RaccoonMemoryReport base = rac_memory_report(NULL);
+    rac_var_t *a = rac_var_make(alloctr, 2);
+    rac_var_t *b = rac_var_make(alloctr, 3);
+    rac_var_t *c = rac_var_mul(a, b);
+    struct RaccoonMemoryReport report = rac_memory_report(NULL);
+    assert(report.leaves == base.leaves + 2);
+    assert(report.intermediates == base.intermediates + 1);
+    assert(report.bytes_nodes == base.bytes_nodes + 3 * sizeof(rac_var_t));
+
+    // fused nodes are counted with their own size
+    rac_var_t *f = rac_var_fma(a, b, c);
+    report = rac_memory_report(NULL);
+    assert(rac_var_bytes(f) == sizeof(rac_var_fused_t));
+    assert(report.bytes_nodes == base.bytes_nodes + 3 * sizeof(rac_var_t) + sizeof(rac_var_fused_t));
+    assert(report.peak_bytes >= report.bytes_nodes);
+    rac_var_free(f);
+
+    // dot products are intermediates of their own size
+    vt_plist_t *weights = vt_plist_create(2, alloctr);
+    vt_plist_push_back(weights, a);
+    vt_plist_push_back(weights, b);
+    const rac_float x[2] = {1, 2};
+    rac_var_t *d = rac_var_dot(alloctr, weights, x, 2, 1);
+    report = rac_memory_report(NULL);
+    assert(report.leaves == base.leaves + 2);
+    assert(report.intermediates == base.intermediates + 2);
+    assert(report.bytes_nodes == base.bytes_nodes + 3 * sizeof(rac_var_t) + sizeof(rac_var_dot_t));
+    rac_var_free(d);
+    vt_plist_destroy(weights);
+    report = rac_memory_report(NULL);
+    assert(report.intermediates == base.intermediates + 1);
+
+    // remake turns an intermediate into a leaf
+    rac_var_remake(c, 1, 0, NULL, NULL);
+    report = rac_memory_report(NULL);
+    assert(report.leaves == base.leaves + 3);
+    assert(report.intermediates == base.intermediates);
+    rac_var_free(a);
+    rac_var_free(b);
+    rac_var_free(c);
+    report = rac_memory_report(NULL);
+    assert(report.leaves == base.leaves);
+    assert(report.bytes_nodes == base.bytes_nodes);
+
+    // model
+    rac_mlp_t *model = rac_mlp_make(alloctr, 3, (size_t[]){2, 3, 1}, NULL, NULL);
+    vt_plist_t *input = vt_plist_create(2, alloctr);
+    vt_plist_push_back(input, rac_var_make(alloctr, 1));
+    vt_plist_push_back(input, rac_var_make(alloctr, 2));
+    report = rac_memory_report(model);
+    assert(report.cached == 0);
+    assert(report.bytes_params >= 13 * sizeof(rac_var_t));
+    assert(report.bytes_total > report.bytes_params + report.bytes_cache);
+
+    // every forward grows the neuron caches
+    rac_memory_step_begin();
+    const size_t live = report.leaves + report.intermediates;
+    VT_FOREACH(step, 0, 2) {
+        rac_mlp_forward(model, input);
+        report = rac_memory_report(model);
+        assert(report.cached == (step+1) * (3 * (2*2 + 2) + 1 * (2*3 + 2))); // neuron: 2 * input_size + 2 nodes
+        assert(report.peak_nodes == live + report.cached);
+        assert(report.bytes_cache >= report.cached * sizeof(rac_var_t));
+    }
+
+    // free
+    plist_var_free(input);
+    rac_mlp_free(model);
+    report = rac_memory_report(NULL);
+    assert(report.leaves + report.intermediates == base.leaves + base.intermediates);
+    assert(report.bytes_nodes == base.bytes_nodes);
+}
+
+void test_jit(void) {
+    // record loss = (w0*x0 + w1*x1 + bias - y)^2 + prev twice: interpreted and compiled to native code
+    rac_tape_t *tapes[2] = { rac_tape_make(alloctr), rac_tape_make(alloctr) };
+    rac_var_t *weights[2] = {NULL};
+    VT_FOREACH(t, 0, 2) {
+        rac_var_t *w0 = rac_var_make(alloctr, 2);
+        rac_var_t *w1 = rac_var_make(alloctr, -1);
+        rac_var_t *x0 = rac_var_make(alloctr, 3);
+        rac_var_t *x1 = rac_var_make(alloctr, 4);
+        rac_var_t *bias = rac_var_make(alloctr, 1);
+        rac_var_t *y = rac_var_make(alloctr, 5);
+        rac_var_t *prev = rac_var_make(alloctr, 10);
+        rac_var_t *m0 = rac_var_mul(w0, x0);
+        rac_var_t *s0 = rac_var_add(bias, m0);
+        rac_var_t *m1 = rac_var_mul(w1, x1);
+        rac_var_t *s1 = rac_var_add(s0, m1);
+        rac_var_t *diff = rac_var_sub(s1, y);
+        rac_var_t *sq = rac_var_mul(diff, diff);
+        rac_var_t *loss = rac_var_add(sq, prev);
+        rac_tape_push_ex(tapes[t], 14, (rac_var_t*[]){w0, w1, x0, x1, bias, y, prev, m0, s0, m1, s1, diff, sq, loss});
+        weights[t] = w0;
+        rac_tape_compile_ex(tapes[t], RAC_TAPE_OPTIMIZE_ALL);
+    }
+
+    // shared objects go to a temporary directory (the jit is not supported on Windows, nothing is written there)
+#if defined(_WIN32)
+    char cache_dir[] = ".";
+#else
+    char cache_dir[RAC_JIT_PATH_MAX] = {0};
+    snprintf(cache_dir, sizeof(cache_dir), "%s/rac_jit_test_XXXXXX", getenv("TMPDIR") ? getenv("TMPDIR") : "/tmp");
+    assert(mkdtemp(cache_dir) != NULL);
+#endif
+
+    // compile (skipped if no C compiler is available)
+    rac_jit_t *jit = rac_jit_make(tapes[1], cache_dir);
+    if (jit == NULL) {
+        printf("    jit: no native backend, skipped\n");
+    } else {
+        assert(jit->len == vt_plist_len(tapes[1]->list));
+        assert(jit->hash == rac_jit_hash(tapes[0]));
+
+        // replay with new weights: results and gradients are identical
+        VT_FOREACH(step, 0, 3) {
+            weights[0]->data = weights[1]->data = 3 + step;
+            rac_tape_update(tapes[0]);
+            rac_var_backward(rac_tape_last(tapes[0]));
+            rac_jit_update(jit);
+            rac_jit_backward(jit);
+            VT_FOREACH(i, 0, vt_plist_len(tapes[0]->list)) {
+                assert(rac_tape_get(tapes[0], i)->data == rac_tape_get(tapes[1], i)->data);
+                assert(rac_tape_get(tapes[0], i)->grad == rac_tape_get(tapes[1], i)->grad);
+            }
+        }
+        assert(rac_tape_last(tapes[1])->data == 59);
+        assert(weights[1]->grad == 42);
+
+        // same graph structure: loaded from the on-disk cache
+        rac_jit_t *cached = rac_jit_make(tapes[0], cache_dir);
+        assert(cached != NULL && cached->cached);
+        assert(cached->hash == jit->hash);
+
+        // subtraction and division: the same gradients as the interpreter
+        rac_tape_t *sd_tape = rac_tape_make(alloctr);
+        rac_var_t *sa = rac_var_make(alloctr, 6);
+        rac_var_t *sb = rac_var_make(alloctr, 2);
+        rac_var_t *sdiff = rac_var_sub(sa, sb);
+        rac_var_t *squot = rac_var_div(sdiff, sb);
+        rac_tape_push_ex(sd_tape, 4, (rac_var_t*[]){sa, sb, sdiff, squot});
+        rac_tape_compile(sd_tape);
+        rac_jit_t *sd_jit = rac_jit_make(sd_tape, cache_dir);
+        assert(sd_jit != NULL);
+        rac_jit_update(sd_jit);
+        rac_jit_backward(sd_jit);
+        assert(squot->data == 2);
+        const rac_float jit_grads[2] = { sa->grad, sb->grad };
+        VT_FOREACH(i, 0, 4) rac_var_zero_grad(rac_tape_get(sd_tape, i));
+        rac_var_backward(squot);
+        assert(sa->grad == jit_grads[0] && sb->grad == jit_grads[1]);
+        assert(sa->grad == 0.5f);   // 1/b
+        assert(sb->grad == -1.5f);  // -1/b - (a-b)/b^2
+
+        // remove cached files (generated sources are removed by `rac_jit_make`)
+        char path[RAC_JIT_PATH_MAX] = {0};
+        snprintf(path, sizeof(path), "%s/rac_jit_%016" PRIx64 ".so", cache_dir, jit->hash);
+        remove(path);
+        snprintf(path, sizeof(path), "%s/rac_jit_%016" PRIx64 ".so", cache_dir, sd_jit->hash);
+        remove(path);
+
+        // free
+        rac_jit_free(sd_jit);
+        rac_tape_free(sd_tape);
+        rac_jit_free(cached);
+        rac_jit_free(jit);
+    }
+
+    // free tapes and the cache directory
+    rac_tape_free(tapes[0]);
+    rac_tape_free(tapes[1]);
+#if !defined(_WIN32)
+    assert(rmdir(cache_dir) == 0);
+#endif
+}
+
+void test_static_mlp(void) {
+    // the same {3, 5, 1} model as in test_mlp, and its fixed-shape copy
+    rac_mlp_t *model = rac_mlp_make(alloctr, 3, (size_t[]){3, 5, 1}, NULL, NULL);
+    tiny_params_t params = {0};
+    tiny_load(&params, model);
+
+    // forward
+    const rac_float x[3] = {1, 0, 1};
+    vt_plist_t *input = vt_plist_create(3, alloctr);
+    VT_FOREACH(i, 0, 3) vt_plist_push_back(input, rac_var_make(alloctr, x[i]));
+    rac_var_t *yhat = vt_plist_get(rac_mlp_forward(model, input), 0);
+    rac_float y[1] = {0};
+    tiny_cache_t cache = {0};
+    tiny_forward(&params, x, y, &cache);
+    assert(RAC_ABS(y[0] - yhat->data) < 1e-5);
+
+    // backward: parameter and input gradients match the graph
+    tiny_params_t grad = {0};
+    rac_float dx[3] = {0};
+    rac_var_backward(yhat);
+    tiny_backward(&params, &cache, (rac_float[]){1}, &grad, dx);
+    const rac_layer_t *hidden = vt_plist_get(model->layers, 0);
+    VT_FOREACH(j, 0, 5) {
+        const rac_neuron_t *neuron = vt_plist_get(hidden->neurons, j);
+        VT_FOREACH(i, 0, 3) assert(RAC_ABS(grad.w1[j][i] - ((rac_var_t*)vt_plist_get(neuron->params, i))->grad) < 1e-5);
+        assert(RAC_ABS(grad.b1[j] - ((rac_var_t*)vt_plist_get(neuron->params, 3))->grad) < 1e-5);
+    }
+    VT_FOREACH(i, 0, 3) assert(RAC_ABS(dx[i] - ((rac_var_t*)vt_plist_get(input, i))->grad) < 1e-5);
+
+    // update and store back
+    tiny_update(&params, &grad, 0.5);
+    tiny_store(&params, model);
+    tiny_params_t stored = {0};
+    tiny_load(&stored, model);
+    assert(memcmp(&stored, &params, sizeof(params)) == 0);
+
+    // free
+    plist_var_free(input);
+    rac_mlp_free(model);
+}
+
+void test_packed_mlp(void) {
+    // scalar conversions
+    assert(rac_fp16_from_float(1.0f) == 0x3c00 && rac_fp16_to_float(0x3c00) == 1.0f);
+    assert(rac_fp16_to_float(rac_fp16_from_float(-2.5f)) == -2.5f);
+    assert(rac_fp16_to_float(rac_fp16_from_float(65504.0f)) == 65504.0f);
+    assert(rac_fp16_from_float(65520.0f) == 0x7c00 && rac_fp16_from_float(-1e6f) == 0xfc00);
+    assert(rac_fp16_from_float(0x1p-24f) == 0x0001 && rac_fp16_to_float(0x0001) == 0x1p-24f);
+    assert(rac_fp16_from_float(0x1p-26f) == 0x0000);
+    assert(rac_fp16_from_float(1.0f + 0x1p-11f) == 0x3c00); // tie rounds to even
+    assert(rac_bf16_from_float(1.0f) == 0x3f80 && rac_bf16_to_float(0x3f80) == 1.0f);
+    assert(rac_bf16_to_float(rac_bf16_from_float(-3.0e38f)) < -2.9e38f);
+    assert(rac_bf16_from_float(1.0f + 0x1p-8f) == 0x3f80); // tie rounds to even
+
+    // array conversions
+    const rac_float values[4] = {0.5, -0.25, 1024, -0.0078125};
+    rac_half_t halfs[4] = {0};
+    rac_float restored[4] = {0};
+    rac_half_pack(RAC_HALF_FP16, 4, values, halfs);
+    rac_half_unpack(RAC_HALF_FP16, 4, halfs, restored);
+    assert(memcmp(values, restored, sizeof(values)) == 0);
+
+    // the same {3, 5, 1} model as in test_mlp
+    rac_mlp_t *model = rac_mlp_make(alloctr, 3, (size_t[]){3, 5, 1}, NULL, NULL);
+    const rac_float x[3] = {1, 0, 1};
+    vt_plist_t *input = vt_plist_create(3, alloctr);
+    VT_FOREACH(i, 0, 3) vt_plist_push_back(input, rac_var_make(alloctr, x[i]));
+    rac_var_t *yhat = vt_plist_get(rac_mlp_forward(model, input), 0);
+    rac_var_backward(yhat);
+
+    const enum RaccoonHalfType types[2] = {RAC_HALF_BF16, RAC_HALF_FP16};
+    VT_FOREACH(t, 0, 2) {
+        rac_packed_mlp_t *packed = rac_packed_mlp_make(alloctr, model, types[t], true, NULL, NULL);
+        assert(packed->num_layers == 3 && packed->params_len == 5 * 4 + 1 * 6 && packed->width == 5);
+
+        // forward: within the precision of the storage format
+        rac_float y[1] = {0};
+        rac_packed_mlp_forward(packed, x, y);
+        assert(RAC_ABS(y[0] - yhat->data) < 5e-2);
+
+        // unpacking rounds the model; packing it again is bit-stable
+        rac_mlp_t *copy = rac_mlp_make(alloctr, 3, (size_t[]){3, 5, 1}, NULL, NULL);
+        rac_packed_mlp_unpack(packed, copy);
+        rac_packed_mlp_t *repacked = rac_packed_mlp_make(alloctr, copy, types[t], false, NULL, NULL);
+        assert(repacked->grads == NULL);
+        assert(memcmp(packed->params, repacked->params, packed->params_len * sizeof(rac_half_t)) == 0);
+
+        // gradients
+        rac_packed_mlp_pack_grad(packed, model);
+        rac_packed_mlp_unpack_grad(packed, copy);
+        const rac_layer_t *layer = vt_plist_get(model->layers, 1), *layer_copy = vt_plist_get(copy->layers, 1);
+        const rac_neuron_t *neuron = vt_plist_get(layer->neurons, 0), *neuron_copy = vt_plist_get(layer_copy->neurons, 0);
+        VT_FOREACH(i, 0, 6) {
+            const rac_float grad = ((rac_var_t*)vt_plist_get(neuron->params, i))->grad;
+            assert(RAC_ABS(((rac_var_t*)vt_plist_get(neuron_copy->params, i))->grad - grad) <= 1e-2 * RAC_ABS(grad));
+        }
+
+        // free
+        rac_packed_mlp_free(repacked);
+        rac_packed_mlp_free(packed);
+        rac_mlp_free(copy);
+    }
+
+    // a trained model with a graph activation converts as is: the packed forward applies the model's activation
+    rac_mlp_t *activated = rac_mlp_make(alloctr, 3, (size_t[]){3, 5, 1}, act_square, NULL);
+    const rac_float yhat_activated = ((rac_var_t*)vt_plist_get(rac_mlp_forward(activated, input), 0))->data;
+    rac_packed_mlp_t *packed_activated = rac_packed_mlp_make(alloctr, activated, RAC_HALF_FP16, false, NULL, NULL);
+    rac_float y_activated[1] = {0};
+    rac_packed_mlp_forward(packed_activated, x, y_activated);
+    assert(RAC_ABS(y_activated[0] - yhat_activated) < 5e-2 * (1 + RAC_ABS(yhat_activated)));
+    rac_packed_mlp_free(packed_activated);
+    rac_mlp_free(activated);
+
+    // free
+    plist_var_free(input);
+    rac_mlp_free(model);
+}
+
+void test_quant_mlp(void) {
+    // {40, 8, 2} model: the first layer spans two padded rows
+    rac_mlp_t *model = rac_mlp_make(alloctr, 3, (size_t[]){40, 8, 2}, NULL, NULL);
+
+    // calibration samples
+    rac_float samples[4][40] = {{0}};
+    VT_FOREACH(s, 0, 4) VT_FOREACH(i, 0, 40) samples[s][i] = (rac_float)((int)((s * 40 + i) * 7 % 23) - 8) / 8;
+    rac_quant_mlp_t *quant = rac_quant_mlp_make(alloctr, model, &samples[0][0], 4, NULL, NULL);
+    assert(quant->num_layers == 3 && quant->width == 64);
+    VT_FOREACH(l, 0, 2) assert(quant->input_zero_points[l] >= 0 && quant->input_zero_points[l] <= RAC_QUANT_ACTIVATION_MAX);
+
+    // forward: close to the float model on every calibration sample
+    VT_FOREACH(s, 0, 4) {
+        vt_plist_t *input = vt_plist_create(40, alloctr);
+        VT_FOREACH(i, 0, 40) vt_plist_push_back(input, rac_var_make(alloctr, samples[s][i]));
+        vt_plist_t *yhat = rac_mlp_forward(model, input);
+
+        rac_float y[2] = {0};
+        rac_quant_mlp_forward(quant, samples[s], y);
+        VT_FOREACH(k, 0, 2) {
+            const rac_float expected = ((rac_var_t*)vt_plist_get(yhat, k))->data;
+            assert(RAC_ABS(y[k] - expected) < 0.05 * (1 + RAC_ABS(expected)));
+        }
+        plist_var_free(input);
+    }
+
+    // recalibration on a single sample is deterministic
+    rac_float y0[2] = {0}, y1[2] = {0};
+    rac_quant_mlp_calibrate(quant, model, samples[1], 1);
+    rac_quant_mlp_forward(quant, samples[1], y0);
+    rac_quant_mlp_forward(quant, samples[1], y1);
+    assert(memcmp(y0, y1, sizeof(y0)) == 0);
+
+    // without scalar activations, calibration and inference apply the model's graph activations
+    rac_mlp_t *activated = rac_mlp_make(alloctr, 3, (size_t[]){40, 8, 2}, act_square, act_square);
+    rac_quant_mlp_t *quant_graph = rac_quant_mlp_make(alloctr, activated, &samples[0][0], 4, NULL, NULL);
+    rac_quant_mlp_t *quant_scalar = rac_quant_mlp_make(alloctr, activated, &samples[0][0], 4, act_square_scalar, act_square_scalar);
+    assert(memcmp(quant_graph->input_scales, quant_scalar->input_scales, 2 * sizeof(rac_float)) == 0);
+    VT_FOREACH(s, 0, 4) {
+        rac_quant_mlp_forward(quant_graph, samples[s], y0);
+        rac_quant_mlp_forward(quant_scalar, samples[s], y1);
+        assert(memcmp(y0, y1, sizeof(y0)) == 0);
+        assert(y0[0] >= 0 && y0[1] >= 0);
+    }
+    rac_quant_mlp_free(quant_scalar);
+    rac_quant_mlp_free(quant_graph);
+    rac_mlp_free(activated);
+
+    // free
+    rac_quant_mlp_free(quant);
+    rac_mlp_free(model);
+}
+
+void test_jvp(void) {
+    // graph: {3, 5, 2} model, derivatives of both outputs with respect to x0 in one sweep
+    rac_mlp_t *model = rac_mlp_make(alloctr, 3, (size_t[]){3, 5, 2}, NULL, NULL);
+    vt_plist_t *input = vt_plist_create(3, alloctr);
+    VT_FOREACH(i, 0, 3) vt_plist_push_back(input, rac_var_make(alloctr, (rac_float)i - 1));
+    vt_plist_t *output = rac_mlp_forward(model, input);
+    rac_var_t *x0 = vt_plist_get(input, 0);
+
+    rac_jvp_t *jvp = rac_jvp_make(alloctr, output);
+    rac_jvp_seed(jvp, x0, 1);
+    rac_jvp_forward(jvp);
+    assert(rac_jvp_tangent(jvp, x0) == 1 && rac_jvp_tangent(jvp, vt_plist_get(input, 1)) == 0);
+
+    // matches reverse mode run once per output
+    VT_FOREACH(k, 0, 2) {
+        rac_jvp_forward(jvp); // also resets operation gradients
+        VT_FOREACH(i, 0, 3) rac_var_zero_grad(vt_plist_get(input, i));
+        rac_mlp_zero_grad(model);
+        rac_var_backward(vt_plist_get(output, k));
+        assert(RAC_ABS(rac_jvp_tangent(jvp, vt_plist_get(output, k)) - x0->grad) < 1e-5);
+    }
+
+    // a new direction
+    rac_jvp_zero(jvp);
+    rac_jvp_seed(jvp, vt_plist_get(input, 2), 2);
+    rac_jvp_forward(jvp);
+    assert(rac_jvp_tangent(jvp, x0) == 0);
+    rac_jvp_free(jvp);
+
+    // tape with fused operations, subtraction and division: t4 = ((a*b + c - a)^2 + (a*b + c) - c) / a
+    rac_tape_t *tape = rac_tape_make(alloctr);
+    rac_var_t *a = rac_var_make(alloctr, 2), *b = rac_var_make(alloctr, 3), *c = rac_var_make(alloctr, 1);
+    rac_tape_push_ex(tape, 3, (rac_var_t*[]){a, b, c});
+    rac_var_t *t1 = rac_var_fma(a, b, c);
+    rac_tape_push(tape, t1);
+    rac_var_t *t2 = rac_var_sqdiff_acc(t1, a, t1);
+    rac_tape_push(tape, t2);
+    rac_var_t *t3 = rac_var_sub(t2, c);
+    rac_tape_push(tape, t3);
+    rac_var_t *t4 = rac_var_div(t3, a);
+    rac_tape_push(tape, t4);
+
+    // true derivative at a = 2: dt3/da = 2 * (t1 - a) * (b - 1) + b = 23, dt4/da = dt3/da / a - t3 / a^2 = 3.75
+    jvp = rac_jvp_make_tape(tape);
+    rac_jvp_seed(jvp, a, 1);
+    rac_jvp_forward(jvp);
+    assert(RAC_ABS(rac_jvp_tangent(jvp, t4) - 3.75f) < 1e-4);
+    assert(rac_jvp_tangent(jvp, t3) == 23);
+
+    // reverse mode agrees
+    rac_var_backward(t4);
+    assert(RAC_ABS(a->grad - 3.75f) < 1e-4);
+
+    // values are recomputed during the sweep
+    a->data = 1;
+    rac_jvp_forward(jvp);
+    assert(t1->data == 4 && t2->data == 13 && t3->data == 12 && t4->data == 12);
+
+    // single-parent custom operation: t5 = t4^2
+    rac_var_register_op('s', (rac_var_op_t){ op_square_forward, op_square_derivative });
+    rac_var_t *t5 = act_square_op(t4);
+    rac_tape_push(tape, t5);
+    rac_jvp_free(jvp);
+    jvp = rac_jvp_make_tape(tape);
+    rac_jvp_seed(jvp, a, 1);
+    a->data = 2;
+    rac_jvp_forward(jvp);
+    assert(t5->data == 15.5f * 15.5f);
+    assert(RAC_ABS(rac_jvp_tangent(jvp, t5) - 2 * 15.5f * 3.75f) < 1e-3);
+
+    // free
+    rac_jvp_free(jvp);
+    rac_tape_free(tape);
+    plist_var_free(input);
+    rac_mlp_free(model);
+}
+
+void test_grad(void) {
+    // f = x*x*y + y*z at (2, 3, 5): gradient (12, 9, 3), Hessian [[6, 4, 0], [4, 0, 1], [0, 1, 0]]
+    rac_var_t *x = rac_var_make(alloctr, 2), *y = rac_var_make(alloctr, 3), *z = rac_var_make(alloctr, 5);
+    rac_var_t *xx = rac_var_mul(x, x), *xxy = rac_var_mul(xx, y), *yz = rac_var_mul(y, z), *f = rac_var_add(xxy, yz);
+
+    // gradient nodes hold the same values as a backward pass
+    rac_grad_t *grad = rac_grad_make(alloctr, f);
+    assert(rac_grad_get(grad, x)->data == 12 && rac_grad_get(grad, y)->data == 9 && rac_grad_get(grad, z)->data == 3);
+    rac_var_backward(f);
+    assert(x->grad == 12 && y->grad == 9 && z->grad == 3);
+
+    // Hessian-vector product
+    rac_var_t *wrt[3] = {x, y, z};
+    rac_float hv[3] = {0};
+    rac_grad_hvp(grad, 3, wrt, (rac_float[]){1, 2, 3}, hv);
+    assert(hv[0] == 14 && hv[1] == 7 && hv[2] == 2);
+
+    // after inputs change
+    x->data = 1;
+    rac_grad_update(grad);
+    assert(f->data == 18 && rac_grad_get(grad, x)->data == 6 && rac_grad_get(grad, y)->data == 6);
+    rac_grad_hvp(grad, 3, wrt, (rac_float[]){1, 0, 0}, hv);
+    assert(hv[0] == 6 && hv[1] == 2 && hv[2] == 0);
+
+    // gradients are differentiable again: d(df/dx)/dy = 2x
+    rac_grad_t *second = rac_grad_make(alloctr, rac_grad_get(grad, x));
+    assert(rac_grad_get(second, y)->data == 2 && rac_grad_get(second, x)->data == 6 && rac_grad_get(second, z) == NULL);
+    rac_grad_free(second);
+
+    // subtraction and division: g = (x - y) / z at (1, 3, 5), gradient (0.2, -0.2, 0.08),
+    // Hessian [[0, 0, -0.04], [0, 0, 0.04], [-0.04, 0.04, -0.032]]
+    rac_var_t *xy = rac_var_sub(x, y), *g = rac_var_div(xy, z);
+    rac_grad_t *quotient = rac_grad_make(alloctr, g);
+    assert(RAC_ABS(rac_grad_get(quotient, x)->data - 0.2f) < 1e-6 && RAC_ABS(rac_grad_get(quotient, y)->data + 0.2f) < 1e-6);
+    assert(RAC_ABS(rac_grad_get(quotient, z)->data - 0.08f) < 1e-6);
+    VT_FOREACH(i, 0, 3) rac_var_zero_grad(wrt[i]);
+    rac_var_backward(g);
+    VT_FOREACH(i, 0, 3) assert(RAC_ABS(rac_grad_get(quotient, wrt[i])->data - wrt[i]->grad) < 1e-6);
+    rac_grad_hvp(quotient, 3, wrt, (rac_float[]){1, 2, 3}, hv);
+    assert(RAC_ABS(hv[0] + 0.12f) < 1e-6 && RAC_ABS(hv[1] - 0.12f) < 1e-6 && RAC_ABS(hv[2] + 0.056f) < 1e-6);
+    rac_grad_free(quotient);
+    rac_var_free(g);
+    rac_var_free(xy);
+
+    // mean squared error of a {3, 5, 1} model (`loss / n`): compare H v with central differences of the training gradient
+    rac_grad_free(grad);
+    rac_mlp_t *model = rac_mlp_make(alloctr, 3, (size_t[]){3, 5, 1}, NULL, NULL);
+    vt_plist_t *input = vt_plist_create(3, alloctr);
+    VT_FOREACH(i, 0, 3) vt_plist_push_back(input, rac_var_make(alloctr, (rac_float)i + 1));
+    rac_var_t *target = rac_var_make_const(alloctr, 1), *batch_size = rac_var_make_const(alloctr, 4);
+    rac_var_t *error = rac_var_sqdiff(vt_plist_get(rac_mlp_forward(model, input), 0), target);
+    rac_var_t *loss = rac_var_div(error, batch_size);
+    grad = rac_grad_make(alloctr, loss);
+
+    // direction over the first hidden neuron's parameters
+    const rac_layer_t *hidden = vt_plist_get(model->layers, 0);
+    const rac_neuron_t *neuron = vt_plist_get(hidden->neurons, 0);
+    rac_var_t *params[4] = {0};
+    VT_FOREACH(i, 0, 4) params[i] = vt_plist_get(neuron->params, i);
+    const rac_float v[4] = {1, -1, 0.5, 2}, eps = 1e-2;
+    rac_grad_hvp(grad, 4, params, v, hv);
+
+    rac_float g_plus[4] = {0}, g_minus[4] = {0};
+    VT_FOREACH(i, 0, 4) params[i]->data += eps * v[i];
+    rac_grad_update(grad);
+    rac_mlp_zero_grad(model);
+    rac_var_backward(loss);
+    VT_FOREACH(i, 0, 4) {
+        g_plus[i] = params[i]->grad;
+        assert(RAC_ABS(rac_grad_get(grad, params[i])->data - g_plus[i]) < 1e-5 * (1 + RAC_ABS(g_plus[i])));
+    }
+    VT_FOREACH(i, 0, 4) params[i]->data -= 2 * eps * v[i];
+    rac_grad_update(grad);
+    rac_mlp_zero_grad(model);
+    rac_var_backward(loss);
+    VT_FOREACH(i, 0, 4) g_minus[i] = params[i]->grad;
+    VT_FOREACH(i, 0, 4) assert(RAC_ABS((g_plus[i] - g_minus[i]) / (2 * eps) - hv[i]) < 1e-2 * (1 + RAC_ABS(hv[i])));
+
+    // free
+    rac_grad_free(grad);
+    rac_var_free(loss);
+    rac_var_free(error);
+    rac_var_free(batch_size);
+    rac_var_free(target);
+    plist_var_free(input);
+    rac_mlp_free(model);
+    rac_var_free(f);
+    rac_var_free(yz);
+    rac_var_free(xxy);
+    rac_var_free(xx);
+    rac_var_free(z);
+    rac_var_free(y);
+    rac_var_free(x);
+}
+
+void test_checkpoint(void) {
+    // 5-layer model and squared error
+    rac_mlp_t *model = rac_mlp_make(alloctr, 6, (size_t[]){3, 4, 4, 4, 4, 1}, NULL, NULL);
+    vt_plist_t *input = vt_plist_create(3, alloctr);
+    VT_FOREACH(i, 0, 3) vt_plist_push_back(input, rac_var_make(alloctr, (rac_float)i - 0.5));
+    rac_var_t *target = rac_var_make_const(alloctr, 1);
+
+    // reference gradients of all parameters from a full graph
+    rac_var_t *loss = rac_var_sqdiff(vt_plist_get(rac_mlp_forward(model, input), 0), target);
+    const rac_float loss_value = loss->data;
+    rac_var_backward(loss);
+    rac_float reference[5][4][5] = {{{0}}};
+    VT_FOREACH(l, 0, 5) {
+        const rac_layer_t *layer = vt_plist_get(model->layers, l);
+        VT_FOREACH(j, 0, vt_plist_len(layer->neurons)) {
+            const rac_neuron_t *neuron = vt_plist_get(layer->neurons, j);
+            VT_FOREACH(i, 0, vt_plist_len(neuron->params)) reference[l][j][i] = ((rac_var_t*)vt_plist_get(neuron->params, i))->grad;
+        }
+    }
+    rac_var_free(loss);
+
+    // checkpointed: default sqrt segments (3 + 2 layers) and one layer per segment
+    const size_t segment_lens[2] = {0, 1}, expected_segments[2] = {2, 5};
+    VT_FOREACH(t, 0, 2) {
+        rac_mlp_zero_grad(model);
+        rac_checkpoint_t *checkpoint = rac_checkpoint_make(alloctr, model, segment_lens[t]);
+        assert(checkpoint->segments_len == expected_segments[t]);
+
+        loss = rac_var_sqdiff(vt_plist_get(rac_checkpoint_forward(checkpoint, input), 0), target);
+        assert(RAC_ABS(loss->data - loss_value) < 1e-6);
+        assert(vt_plist_len(checkpoint->boundaries) == expected_segments[t] - 1);
+
+        // only the last segment keeps its graph
+        const rac_layer_t *first = vt_plist_get(model->layers, 0);
+        assert(vt_plist_len(((rac_neuron_t*)vt_plist_get(first->neurons, 0))->cache) == 0);
+
+        rac_checkpoint_backward(checkpoint, loss);
+        VT_FOREACH(l, 0, 5) {
+            const rac_layer_t *layer = vt_plist_get(model->layers, l);
+            VT_FOREACH(j, 0, vt_plist_len(layer->neurons)) {
+                const rac_neuron_t *neuron = vt_plist_get(layer->neurons, j);
+                VT_FOREACH(i, 0, vt_plist_len(neuron->params)) {
+                    assert(RAC_ABS(((rac_var_t*)vt_plist_get(neuron->params, i))->grad - reference[l][j][i]) < 1e-5 * (1 + RAC_ABS(reference[l][j][i])));
+                }
+            }
+        }
+
+        // free
+        rac_var_free(loss);
+        rac_checkpoint_free(checkpoint);
+    }
+
+    // free
+    rac_var_free(target);
+    plist_var_free(input);
+    rac_mlp_free(model);
+}
+
+void test_sparse(void) {
+    // mostly zero input
+    const rac_float dense[10] = {0, 0, 1.5, 0, 0, 0, -2, 0, 0, 0};
+    rac_sparse_t *sparse = rac_sparse_make_dense(alloctr, 10, dense);
+    assert(sparse->len == 10 && sparse->nnz == 2);
+    assert(sparse->indices[0] == 2 && sparse->indices[1] == 6);
+    assert(sparse->values[0] == 1.5 && sparse->values[1] == -2);
+
+    // same entries from index/value pairs
+    rac_sparse_t *pairs = rac_sparse_make(alloctr, 10, 2, (size_t[]){2, 6}, (rac_float[]){1.5, -2});
+    assert(pairs->nnz == 2 && pairs->indices[1] == 6 && pairs->values[1] == -2);
+    rac_sparse_free(pairs);
+
+    // dense reference
+    rac_mlp_t *model = rac_mlp_make(alloctr, 3, (size_t[]){10, 3, 1}, NULL, NULL);
+    vt_plist_t *input = vt_plist_create(10, alloctr);
+    VT_FOREACH(i, 0, 10) vt_plist_push_back(input, rac_var_make(alloctr, dense[i]));
+    rac_var_t *target = rac_var_make_const(alloctr, 1);
+    rac_var_t *loss = rac_var_sqdiff(vt_plist_get(rac_mlp_forward(model, input), 0), target);
+    const rac_float loss_value = loss->data;
+    rac_var_backward(loss);
+    rac_float reference[3][11] = {{0}};
+    const rac_layer_t *first = vt_plist_get(model->layers, 0);
+    VT_FOREACH(j, 0, 3) {
+        const rac_neuron_t *neuron = vt_plist_get(first->neurons, j);
+        VT_FOREACH(i, 0, 11) reference[j][i] = ((rac_var_t*)vt_plist_get(neuron->params, i))->grad;
+    }
+    rac_var_free(loss);
+    rac_mlp_clear_cache(model);
+    rac_mlp_zero_grad(model);
+
+    // sparse forward: same loss and gradients, zero columns are never touched
+    loss = rac_var_sqdiff(vt_plist_get(rac_mlp_forward_sparse(model, sparse), 0), target);
+    assert(RAC_ABS(loss->data - loss_value) < 1e-5);
+    rac_var_backward(loss);
+    VT_FOREACH(j, 0, 3) {
+        const rac_neuron_t *neuron = vt_plist_get(first->neurons, j);
+        VT_FOREACH(i, 0, 11) {
+            const rac_float grad = ((rac_var_t*)vt_plist_get(neuron->params, i))->grad;
+            assert(RAC_ABS(grad - reference[j][i]) < 1e-5 * (1 + RAC_ABS(reference[j][i])));
+            if (i < 10 && dense[i] == 0) assert(grad == 0);
+        }
+
+        // sum leaf, two nodes per nonzero, bias
+        assert(vt_plist_len(neuron->cache) == 1 + 2 * sparse->nnz + 1);
+    }
+
+    // sparse update and zero grad touch only active columns of the first layer (and its biases)
+    const rac_neuron_t *neuron0 = vt_plist_get(first->neurons, 0);
+    rac_var_t *inactive = vt_plist_get(neuron0->params, 0), *active = vt_plist_get(neuron0->params, 2), *bias = vt_plist_get(neuron0->params, 10);
+    const rac_float inactive_data = inactive->data, active_data = active->data, bias_data = bias->data;
+    const rac_float active_grad = active->grad, bias_grad = bias->grad;
+    inactive->grad = 100; // marker: a dense walk would use and clear it
+    rac_mlp_update_sparse(model, sparse, 0.1);
+    assert(inactive->data == inactive_data);
+    assert(active->data == active_data - (rac_float)0.1 * active_grad && bias->data == bias_data - (rac_float)0.1 * bias_grad);
+    rac_mlp_zero_grad_sparse(model, sparse);
+    assert(inactive->grad == 100 && active->grad == 0 && bias->grad == 0);
+    const rac_layer_t *second = vt_plist_get(model->layers, 1);
+    const rac_neuron_t *out = vt_plist_get(second->neurons, 0);
+    VT_FOREACH(i, 0, 4) assert(((rac_var_t*)vt_plist_get(out->params, i))->grad == 0);
+
+    // free
+    rac_var_free(loss);
+    rac_var_free(target);
+    plist_var_free(input);
+    rac_sparse_free(sparse);
+    rac_mlp_free(model);
+}
+
+void test_schedule(void) {
+    // shared subexpression: y = (a*b) * (a*b + c), z = a*b - c
+    rac_var_t *a = rac_var_make(alloctr, 2);
+    rac_var_t *b = rac_var_make(alloctr, 3);
+    rac_var_t *c = rac_var_make(alloctr, -1);
+    rac_var_t *ab = rac_var_mul(a, b);
+    rac_var_t *s = rac_var_add(ab, c);
+    rac_var_t *y = rac_var_mul(ab, s);
+    rac_var_t *z = rac_var_sub(ab, c);
+    vt_plist_t *outputs = vt_plist_create(2, alloctr);
+    vt_plist_push_back(outputs, y);
+    vt_plist_push_back(outputs, z);
+
+    // levels: {y, z}, {s}, {ab, c}, {a, b}
+    rac_schedule_t *schedule = rac_schedule_make(alloctr, outputs);
+    assert(vt_plist_len(schedule->nodes) == 7);
+    assert(schedule->levels_len == 4);
+    assert(schedule->level_offsets[1] == 2 && schedule->level_offsets[2] == 3 && schedule->level_offsets[3] == 5);
+
+    // d/d(ab) = 1 * (s + ab) + 2 = 13, d/dc = 1 * ab - 2 = 4
+    y->grad = 1; z->grad = 2;
+    rac_schedule_backward(schedule);
+    assert(a->grad == 39 && b->grad == 26 && c->grad == 4);
+    rac_schedule_free(schedule);
+    vt_plist_destroy(outputs);
+
+    // subtraction and division: the same gradients as the sequential backward, r = (ab - c) / (s + a)
+    rac_var_t *den = rac_var_add(s, a);
+    rac_var_t *r = rac_var_div(z, den);
+    outputs = vt_plist_create(2, alloctr);
+    vt_plist_push_back(outputs, y);
+    vt_plist_push_back(outputs, r);
+    schedule = rac_schedule_make(alloctr, outputs);
+    rac_float scheduled[3] = {0};
+    VT_FOREACH(t, 0, 2) {
+        VT_FOREACH(i, 0, vt_plist_len(schedule->nodes)) rac_var_zero_grad(vt_plist_get(schedule->nodes, i));
+        y->grad = 1; r->grad = 2;
+        if (t == 0) {
+            rac_schedule_backward(schedule);
+            scheduled[0] = a->grad; scheduled[1] = b->grad; scheduled[2] = c->grad;
+        } else {
+            rac_graph_backward(outputs);
+        }
+    }
+    assert(RAC_ABS(a->grad - scheduled[0]) < 1e-5 && RAC_ABS(b->grad - scheduled[1]) < 1e-5 && RAC_ABS(c->grad - scheduled[2]) < 1e-5);
+    assert(RAC_ABS(c->grad - (6 + 2 * (-1 / den->data - z->data / (den->data * den->data)))) < 1e-5); // ab + 2 * dr/dc
+    rac_schedule_free(schedule);
+    vt_plist_destroy(outputs);
+    rac_var_free(r); rac_var_free(den);
+
+    // single-parent activation: sq(w * x) at w = 3, x = 1, d/dw = 2 * w * x * x = 6
+    rac_var_register_op('s', (rac_var_op_t){ op_square_forward, op_square_derivative });
+    rac_var_t *w = rac_var_make(alloctr, 3), *x = rac_var_make(alloctr, 1);
+    rac_var_t *wx = rac_var_mul(w, x), *act = act_square_op(wx);
+    outputs = vt_plist_create(1, alloctr);
+    vt_plist_push_back(outputs, act);
+    schedule = rac_schedule_make(alloctr, outputs);
+    act->grad = 1;
+    rac_schedule_backward(schedule);
+    assert(act->data == 9 && w->grad == 6 && x->grad == 18);
+    rac_var_free(act); rac_var_free(wx); rac_var_free(x); rac_var_free(w);
+
+    // free
+    rac_schedule_free(schedule);
+    vt_plist_destroy(outputs);
+    rac_var_free(z); rac_var_free(y); rac_var_free(s); rac_var_free(ab);
+    rac_var_free(c); rac_var_free(b); rac_var_free(a);
+
+    // two hidden layers: their neuron chains overlap, so levels get wide
+    rac_mlp_t *model = rac_mlp_make(alloctr, 4, (size_t[]){4, 64, 64, 1}, NULL, NULL);
+    vt_plist_t *input = vt_plist_create(4, alloctr);
+    VT_FOREACH(i, 0, 4) vt_plist_push_back(input, rac_var_make(alloctr, (rac_float)i / 4 - 0.3));
+    rac_var_t *target = rac_var_make_const(alloctr, 1);
+    rac_var_t *loss = rac_var_sqdiff(vt_plist_get(rac_mlp_forward(model, input), 0), target);
+    outputs = vt_plist_create(1, alloctr);
+    vt_plist_push_back(outputs, loss);
+    schedule = rac_schedule_make(alloctr, outputs);
+    assert(schedule->width >= RAC_SCHEDULE_PARALLEL_MIN);
+
+    // reference gradients
+    rac_var_backward(loss);
+    vt_plist_t *params = vt_plist_create(VT_ARRAY_DEFAULT_INIT_ELEMENTS, alloctr);
+    VT_FOREACH(l, 0, vt_plist_len(model->layers)) {
+        const rac_layer_t *layer = vt_plist_get(model->layers, l);
+        VT_FOREACH(j, 0, vt_plist_len(layer->neurons)) {
+            const rac_neuron_t *neuron = vt_plist_get(layer->neurons, j);
+            VT_FOREACH(i, 0, vt_plist_len(neuron->params)) vt_plist_push_back(params, vt_plist_get(neuron->params, i));
+        }
+    }
+    const size_t params_len = vt_plist_len(params);
+    rac_float *reference = VT_CALLOC(params_len * sizeof(rac_float));
+    VT_FOREACH(i, 0, params_len) reference[i] = ((rac_var_t*)vt_plist_get(params, i))->grad;
+
+    // scheduled backward, twice: the schedule is reusable
+    VT_FOREACH(t, 0, 2) {
+        VT_FOREACH(i, 0, vt_plist_len(schedule->nodes)) rac_var_zero_grad(vt_plist_get(schedule->nodes, i));
+        loss->grad = 1;
+        rac_schedule_backward(schedule);
+        VT_FOREACH(i, 0, params_len) {
+            const rac_float grad = ((rac_var_t*)vt_plist_get(params, i))->grad;
+            assert(RAC_ABS(grad - reference[i]) < 1e-5 * (1 + RAC_ABS(reference[i])));
+        }
+    }
+
+    // free
+    VT_FREE(reference);
+    vt_plist_destroy(params);
+    rac_schedule_free(schedule);
+    vt_plist_destroy(outputs);
+    rac_var_free(loss);
+    rac_var_free(target);
+    plist_var_free(input);
+    rac_mlp_free(model);
+}
+
+void test_pool(void) {
+    // nodes come from the bound pool
+    rac_pool_t *pool = rac_pool_make(alloctr);
+    assert(rac_pool_bind(pool) == NULL);
+    assert(rac_pool_bound() == pool);
+    rac_var_t *a = rac_var_make(alloctr, 2);
+    rac_var_t *b = rac_var_make_const(alloctr, 3);
+    rac_var_t *c = rac_var_mul(a, b);
+    assert(pool->slabs_len == 1);
+    assert((a->flags & RAC_VAR_FLAG_POOLED) && (c->flags & RAC_VAR_FLAG_POOLED));
+    assert((b->flags & RAC_VAR_FLAG_CONST) && c->data == 6);
+    rac_var_backward(c);
+    assert(a->grad == 3);
+
+    // freed slots are reused first
+    rac_var_t *freed = c;
+    rac_var_free(c);
+    c = rac_var_add(a, b);
+    assert(c == freed && c->op == '+' && c->data == 5);
+
+    // fused nodes come from slabs of their own size class
+    rac_var_t *f = rac_var_fma(a, b, c);
+    assert((f->flags & RAC_VAR_FLAG_POOLED) && (f->flags & RAC_VAR_FLAG_FUSED) && f->data == 11);
+    assert(pool->slabs_len <= RAC_POOL_CLASSES_LEN); // fused nodes fit plain slots if both round up to the same size
+    rac_var_free(f);
+    assert(rac_var_fma(a, b, a) == f);
+    rac_var_free(f);
+
+    // slabs are carved several at a time from one allocation
+    rac_pool_t *carved = rac_pool_make(alloctr);
+    rac_pool_bind(carved);
+    vt_plist_t *nodes = vt_plist_create(VT_ARRAY_DEFAULT_INIT_ELEMENTS, alloctr);
+    vt_plist_push_back(nodes, rac_var_make(alloctr, 0));
+    const void *first_alloc = carved->allocs;
+    assert(carved->slabs_len == 1 && carved->spare != NULL);
+    while (carved->slabs_len < RAC_POOL_SLABS_PER_ALLOC || vt_plist_len(nodes) < carved->capacity) vt_plist_push_back(nodes, rac_var_make(alloctr, 0));
+    assert(carved->allocs == first_alloc && carved->spare == NULL);
+    vt_plist_push_back(nodes, rac_var_make(alloctr, 0));
+    assert(carved->slabs_len == RAC_POOL_SLABS_PER_ALLOC + 1 && carved->allocs != first_alloc);
+    plist_var_free(nodes);
+    rac_pool_bind(pool);
+    rac_pool_free(carved);
+
+    // a slot freed by another thread goes to the owner's remote list
+    rac_pool_t *other = rac_pool_make(alloctr);
+    rac_pool_bind(other);
+    rac_var_free(c);
+    assert(atomic_load(&pool->remote_list[0]) == (void*)freed);
+    assert(other->slabs_len == 0);
+
+    // model training from a pool
+    rac_pool_bind(pool);
+    rac_mlp_t *model = rac_mlp_make(alloctr, 3, (size_t[]){2, 3, 1}, NULL, NULL);
+    vt_plist_t *input = vt_plist_create(2, alloctr);
+    vt_plist_push_back(input, a);
+    vt_plist_push_back(input, b);
+    rac_var_t *target = rac_var_make_const(alloctr, 1);
+    rac_float losses[2] = {0};
+    VT_FOREACH(epoch, 0, 20) {
+        rac_var_t *loss = rac_var_sqdiff(vt_plist_get(rac_mlp_forward(model, input), 0), target);
+        losses[epoch > 0] = loss->data;
+        rac_var_backward(loss);
+        rac_mlp_update(model, 0.001);
+        rac_var_free(loss);
+        rac_mlp_clear_cache(model);
+    }
+    assert(losses[1] < losses[0]);
+    assert(pool->slabs_len == 1); // every epoch reuses the slots of the previous one
+
+    // free
+    rac_mlp_free(model);
+    vt_plist_destroy(input);
+    rac_var_free(target);
+    rac_var_free(b);
+    rac_var_free(a);
+    rac_pool_free(other);
+    rac_pool_free(pool);
+    assert(rac_pool_bound() == NULL);
+}
+
+void test_static_graph(void) {
+    // batch of 4 samples
+    const rac_float xs[4][2] = {{0, 0}, {0, 1}, {1, 0}, {1, 1}};
+    const rac_float ys[4] = {0, 1, 1, 2};
+
+    // build once from placeholders: loss = sum (yhat - y)^2 / 4
+    rac_mlp_t *model = rac_mlp_make(alloctr, 3, (size_t[]){2, 4, 1}, NULL, NULL);
+    vt_plist_t *inputs[4] = {NULL};
+    rac_var_t *targets[4] = {NULL};
+    vt_plist_t *nodes = vt_plist_create(VT_ARRAY_DEFAULT_INIT_ELEMENTS, alloctr);
+    rac_var_t *loss = rac_var_make(alloctr, 0);
+    vt_plist_push_back(nodes, loss);
+    VT_FOREACH(i, 0, 4) {
+        inputs[i] = vt_plist_create(2, alloctr);
+        VT_FOREACH(j, 0, 2) vt_plist_push_back(inputs[i], rac_var_make_placeholder(alloctr));
+        targets[i] = rac_var_make_placeholder(alloctr);
+        loss = rac_var_sqdiff_acc(vt_plist_get(rac_mlp_forward(model, inputs[i]), 0), targets[i], loss);
+        vt_plist_push_back(nodes, loss);
+    }
+    rac_var_t *batch_size = rac_var_make_const(alloctr, 4);
+    loss = rac_var_div(loss, batch_size);
+    vt_plist_push_back(nodes, loss);
+    rac_static_graph_t *graph = rac_static_graph_make(alloctr, loss);
+    assert(vt_plist_len(graph->placeholders) == 4 * 3);
+    assert(vt_plist_get(graph->nodes, vt_plist_len(graph->nodes) - 1) == loss);
+
+    // step with the samples fed into the placeholders
+    VT_FOREACH(i, 0, 4) {
+        VT_FOREACH(j, 0, 2) ((rac_var_t*)vt_plist_get(inputs[i], j))->data = xs[i][j];
+        targets[i]->data = ys[i];
+    }
+    const rac_float static_loss = rac_static_graph_step(graph);
+    const rac_layer_t *hidden = vt_plist_get(model->layers, 0);
+    rac_float static_grads[4][3] = {{0}};
+    VT_FOREACH(n, 0, 4) {
+        const rac_neuron_t *neuron = vt_plist_get(hidden->neurons, n);
+        VT_FOREACH(p, 0, 3) static_grads[n][p] = ((rac_var_t*)vt_plist_get(neuron->params, p))->grad;
+    }
+
+    // same loss and gradients as a graph built from scratch
+    rac_mlp_zero_grad(model);
+    vt_plist_t *dynamic_nodes = vt_plist_create(VT_ARRAY_DEFAULT_INIT_ELEMENTS, alloctr);
+    rac_var_t *dynamic_loss = rac_var_make(alloctr, 0);
+    vt_plist_push_back(dynamic_nodes, dynamic_loss);
+    VT_FOREACH(i, 0, 4) {
+        vt_plist_t *x = vt_plist_create(2, alloctr);
+        VT_FOREACH(j, 0, 2) vt_plist_push_back(x, rac_var_make(alloctr, xs[i][j]));
+        rac_var_t *y = rac_var_make(alloctr, ys[i]);
+        dynamic_loss = rac_var_sqdiff_acc(vt_plist_get(rac_mlp_forward(model, x), 0), y, dynamic_loss);
+        vt_plist_push_back(dynamic_nodes, dynamic_loss);
+        vt_plist_push_back(dynamic_nodes, y);
+        VT_FOREACH(j, 0, 2) vt_plist_push_back(dynamic_nodes, vt_plist_get(x, j));
+        vt_plist_destroy(x);
+    }
+    dynamic_loss = rac_var_div(dynamic_loss, batch_size);
+    vt_plist_push_back(dynamic_nodes, dynamic_loss);
+    rac_var_backward(dynamic_loss);
+    assert(RAC_ABS(dynamic_loss->data - static_loss) < 1e-5);
+    VT_FOREACH(n, 0, 4) {
+        const rac_neuron_t *neuron = vt_plist_get(hidden->neurons, n);
+        VT_FOREACH(p, 0, 3) {
+            const rac_float grad = ((rac_var_t*)vt_plist_get(neuron->params, p))->grad;
+            assert(RAC_ABS(grad - static_grads[n][p]) < 1e-5 * (1 + RAC_ABS(grad)));
+        }
+    }
+    plist_var_free(dynamic_nodes);
+
+    // training steps allocate nothing
+    const size_t allocs = alloctr->stats.count_allocs;
+    rac_float losses[2] = {0};
+    VT_FOREACH(epoch, 0, 50) {
+        losses[epoch > 0] = rac_static_graph_step(graph);
+        rac_mlp_update(model, 0.01);
+    }
+    assert(alloctr->stats.count_allocs == allocs);
+    assert(losses[1] < losses[0]);
+
+    // free
+    rac_static_graph_free(graph);
+    plist_var_free(nodes);
+    rac_var_free(batch_size);
+    VT_FOREACH(i, 0, 4) {
+        plist_var_free(inputs[i]);
+        rac_var_free(targets[i]);
+    }
+    rac_mlp_free(model);
+
+    // registered activations are recomputed: sq(w * x) follows the placeholder
+    rac_var_register_op('s', (rac_var_op_t){ op_square_forward, op_square_derivative });
+    rac_mlp_t *activated = rac_mlp_make(alloctr, 3, (size_t[]){1, 2, 1}, act_square_op, NULL);
+    vt_plist_t *activated_input = vt_plist_create(1, alloctr);
+    rac_var_t *x = rac_var_make_placeholder(alloctr);
+    vt_plist_push_back(activated_input, x);
+    rac_var_t *activated_output = vt_plist_get(rac_mlp_forward(activated, activated_input), 0);
+    rac_static_graph_t *activated_graph = rac_static_graph_make(alloctr, activated_output);
+    const rac_float samples[2] = {1, -2};
+    VT_FOREACH(i, 0, 2) {
+        x->data = samples[i];
+        const rac_float static_value = rac_static_graph_forward(activated_graph);
+        vt_plist_t *fresh_input = vt_plist_create(1, alloctr);
+        rac_var_t *fresh_x = rac_var_make(alloctr, samples[i]);
+        vt_plist_push_back(fresh_input, fresh_x);
+        const rac_float fresh_value = ((rac_var_t*)vt_plist_get(rac_mlp_forward(activated, fresh_input), 0))->data;
+        assert(RAC_ABS(static_value - fresh_value) < 1e-5 * (1 + RAC_ABS(fresh_value)));
+        rac_var_free(fresh_x);
+        vt_plist_destroy(fresh_input);
+    }
+    rac_static_graph_free(activated_graph);
+    rac_var_free(x);
+    vt_plist_destroy(activated_input);
+    rac_mlp_free(activated);
+}
+
+void test_array(void) {
+    // row-major 3x3 matrix, one sample per row
+    rac_float xs[3][3] = {{0.5, -1, 2}, {1, 0.25, -0.5}, {-2, 1.5, 0}};
+
+    // dense reference for the second row
+    rac_mlp_t *model = rac_mlp_make(alloctr, 3, (size_t[]){3, 4, 1}, NULL, NULL);
+    vt_plist_t *input = vt_plist_create(3, alloctr);
+    VT_FOREACH(i, 0, 3) vt_plist_push_back(input, rac_var_make(alloctr, xs[1][i]));
+    rac_var_t *target = rac_var_make_const(alloctr, 1);
+    rac_var_t *loss = rac_var_sqdiff(vt_plist_get(rac_mlp_forward(model, input), 0), target);
+    const rac_float loss_value = loss->data;
+    rac_var_backward(loss);
+    rac_float reference[4][4] = {{0}};
+    const rac_layer_t *first = vt_plist_get(model->layers, 0);
+    VT_FOREACH(j, 0, 4) {
+        const rac_neuron_t *neuron = vt_plist_get(first->neurons, j);
+        VT_FOREACH(i, 0, 4) reference[j][i] = ((rac_var_t*)vt_plist_get(neuron->params, i))->grad;
+    }
+    rac_var_free(loss);
+    rac_mlp_clear_cache(model);
+    rac_mlp_zero_grad(model);
+
+    // array forward over the row: same loss and gradients, no input nodes
+    loss = rac_var_sqdiff(vt_plist_get(rac_mlp_forward_array(model, xs[1], 3, 1), 0), target);
+    assert(RAC_ABS(loss->data - loss_value) < 1e-5);
+    rac_var_backward(loss);
+    VT_FOREACH(j, 0, 4) {
+        const rac_neuron_t *neuron = vt_plist_get(first->neurons, j);
+        VT_FOREACH(i, 0, 4) {
+            const rac_float grad = ((rac_var_t*)vt_plist_get(neuron->params, i))->grad;
+            assert(RAC_ABS(grad - reference[j][i]) < 1e-5 * (1 + RAC_ABS(reference[j][i])));
+        }
+
+        // dot product, bias
+        assert(vt_plist_len(neuron->cache) == 2);
+    }
+
+    // values are read from caller memory: change them and recompute in place
+    rac_static_graph_t *graph = rac_static_graph_make(alloctr, loss);
+    xs[1][0] = -0.75;
+    const rac_float replayed = rac_static_graph_forward(graph);
+    rac_static_graph_free(graph);
+    rac_var_free(loss);
+    rac_mlp_clear_cache(model);
+    ((rac_var_t*)vt_plist_get(input, 0))->data = xs[1][0];
+    loss = rac_var_sqdiff(vt_plist_get(rac_mlp_forward(model, input), 0), target);
+    assert(RAC_ABS(loss->data - replayed) < 1e-5);
+    rac_var_free(loss);
+    rac_mlp_clear_cache(model);
+
+    // strided input: the first column
+    rac_neuron_t *neuron = vt_plist_get(first->neurons, 0);
+    rac_var_t *column = rac_neuron_forward_array(neuron, &xs[0][0], 3, 3);
+    rac_float expected = ((rac_var_t*)vt_plist_get(neuron->params, 3))->data;
+    VT_FOREACH(i, 0, 3) expected += ((rac_var_t*)vt_plist_get(neuron->params, i))->data * xs[i][0];
+    assert(RAC_ABS(column->data - expected) < 1e-5);
+
+    // free
+    rac_var_free(target);
+    plist_var_free(input);
+    rac_mlp_free(model);
+}
+
+void test_conv(void) {
+    // gemm against the naive product, across block edges and for all transpose combinations
+    enum { M = 5, N = RAC_GEMM_BLOCK_N + 6, K = RAC_GEMM_BLOCK_K + 3 };
+    static rac_float a[M * K], b[K * N], c[M * N];
+    VT_FOREACH(i, 0, M * K) a[i] = (rac_float)((int)(i % 7) - 3) / 4;
+    VT_FOREACH(i, 0, K * N) b[i] = (rac_float)((int)(i % 5) - 2) / 2;
+    VT_FOREACH(t, 0, 4) {
+        const bool ta = t & 1, tb = t & 2;
+        VT_FOREACH(i, 0, M * N) c[i] = 1;
+        rac_gemm(ta, tb, M, N, K, a, b, true, c);
+        VT_FOREACH(i, 0, M) {
+            VT_FOREACH(j, 0, N) {
+                rac_float expected = 1;
+                VT_FOREACH(p, 0, K) expected += (ta ? a[p * M + i] : a[i * K + p]) * (tb ? b[j * K + p] : b[p * N + j]);
+                assert(RAC_ABS(c[i * N + j] - expected) < 1e-4);
+            }
+        }
+    }
+
+    // 2D: stride, padding and dilation against a direct loop
+    rac_random_t rng = rac_random_make(3, 0);
+    rac_conv_t *conv = rac_conv2d_make(alloctr, 2, 3, (size_t[]){7, 6}, (size_t[]){3, 2}, (size_t[]){2, 1}, (size_t[]){1, 1}, (size_t[]){2, 1}, &rng);
+    assert(conv->out_size[0] == 3 && conv->out_size[1] == 7);
+    VT_FOREACH(o, 0, 3) assert(conv->bias[o] == 0);
+    rac_float x[2 * 7 * 6], y[3 * 3 * 7], dy[3 * 3 * 7], dx[2 * 7 * 6];
+    VT_FOREACH(i, 0, 2 * 7 * 6) x[i] = (rac_float)((int)(i % 11) - 5) / 5;
+    VT_FOREACH(i, 0, 3 * 3 * 7) dy[i] = (rac_float)((int)(i % 3) - 1);
+    rac_conv_forward(conv, x, y);
+    VT_FOREACH(o, 0, 3) {
+        VT_FOREACH(oy, 0, 3) {
+            VT_FOREACH(ox, 0, 7) {
+                rac_float expected = conv->bias[o];
+                VT_FOREACH(c, 0, 2) {
+                    VT_FOREACH(ky, 0, 3) {
+                        VT_FOREACH(kx, 0, 2) {
+                            const int iy = (int)(oy * 2 + ky * 2) - 1, ix = (int)(ox + kx) - 1;
+                            if (iy < 0 || iy >= 7 || ix < 0 || ix >= 6) continue;
+                            expected += conv->weights[((o * 2 + c) * 3 + ky) * 2 + kx] * x[(c * 7 + iy) * 6 + ix];
+                        }
+                    }
+                }
+                assert(RAC_ABS(y[(o * 3 + oy) * 7 + ox] - expected) < 1e-4);
+            }
+        }
+    }
+
+    // backward: the output is linear in inputs and weights, so unit perturbations give the exact gradients
+    rac_conv_backward(conv, dy, dx);
+    rac_float loss = 0;
+    VT_FOREACH(i, 0, 3 * 3 * 7) loss += y[i] * dy[i];
+    VT_FOREACH(i, 0, 2 * 7 * 6) {
+        x[i] += 1;
+        rac_conv_forward(conv, x, y);
+        rac_float perturbed = 0;
+        VT_FOREACH(j, 0, 3 * 3 * 7) perturbed += y[j] * dy[j];
+        assert(RAC_ABS(perturbed - loss - dx[i]) < 1e-3);
+        x[i] -= 1;
+    }
+    VT_FOREACH(i, 0, conv->params_len) {
+        conv->weights[i] += 1;
+        rac_conv_forward(conv, x, y);
+        rac_float perturbed = 0;
+        VT_FOREACH(j, 0, 3 * 3 * 7) perturbed += y[j] * dy[j];
+        assert(RAC_ABS(perturbed - loss - conv->grad_weights[i]) < 1e-3);
+        conv->weights[i] -= 1;
+    }
+
+    // training on a fixed target lowers the loss
+    rac_conv_zero_grad(conv);
+    assert(conv->grad_bias[0] == 0);
+    rac_float losses[2] = {0};
+    VT_FOREACH(epoch, 0, 20) {
+        rac_conv_forward(conv, x, y);
+        losses[epoch > 0] = 0;
+        VT_FOREACH(i, 0, 3 * 3 * 7) {
+            dy[i] = 2 * y[i];
+            losses[epoch > 0] += y[i] * y[i];
+        }
+        rac_conv_zero_grad(conv);
+        rac_conv_backward(conv, dy, NULL);
+        rac_conv_update(conv, 0.001);
+    }
+    assert(losses[1] < losses[0]);
+    rac_conv_free(conv);
+
+    // 1x1 kernels multiply the input in place
+    conv = rac_conv1d_make(alloctr, 2, 1, 4, 1, 1, 0, 1, &rng);
+    assert(conv->columns == NULL && conv->out_size[1] == 4);
+    const rac_float signal[2 * 4] = {1, 2, 3, 4, -1, 0, 1, 0};
+    rac_conv_forward(conv, signal, y);
+    VT_FOREACH(i, 0, 4) assert(RAC_ABS(y[i] - (conv->weights[0] * signal[i] + conv->weights[1] * signal[4 + i] + conv->bias[0])) < 1e-5);
+
+    // Xavier: weights within +-sqrt(6 / (fan_in + fan_out)), biases reset to zero
+    conv->bias[0] = 1;
+    rac_conv_init(conv, RAC_RANDOM_INIT_XAVIER, &rng);
+    VT_FOREACH(i, 0, 2) assert(RAC_ABS(conv->weights[i]) <= RAC_SQRT((rac_float)6 / (2 + 1)));
+    assert(conv->bias[0] == 0);
+    rac_conv_free(conv);
+
+    // 1D max pooling with overlapping windows: the gradient goes to each window's maximum
+    rac_pooling_t *pooling = rac_pooling1d_make(alloctr, RAC_POOLING_MAX, 1, 5, 3, 1);
+    assert(pooling->out_size[1] == 3);
+    rac_pooling_forward(pooling, (rac_float[]){1, 5, 2, 0, 3}, y);
+    assert(y[0] == 5 && y[1] == 5 && y[2] == 3);
+    rac_pooling_backward(pooling, (rac_float[]){1, 2, 4}, dx);
+    assert(dx[0] == 0 && dx[1] == 3 && dx[2] == 0 && dx[3] == 0 && dx[4] == 4);
+    rac_pooling_free(pooling);
+
+    // 2D average pooling over 2x2 windows
+    pooling = rac_pooling2d_make(alloctr, RAC_POOLING_AVG, 1, (size_t[]){2, 4}, (size_t[]){2, 2}, NULL);
+    assert(pooling->out_size[0] == 1 && pooling->out_size[1] == 2);
+    rac_pooling_forward(pooling, (rac_float[]){1, 2, 3, 4, 5, 6, 7, 8}, y);
+    assert(y[0] == 3.5 && y[1] == 5.5);
+    rac_pooling_backward(pooling, (rac_float[]){4, 8}, dx);
+    VT_FOREACH(i, 0, 8) assert(dx[i] == ((i % 4) < 2 ? 1 : 2));
+    rac_pooling_free(pooling);
+}
+
+void test_recurrent(void) {
+    // loss = sum of hidden states weighted by `dy`, over one window from a zero state
+    enum { IN = 3, HID = 4, STEPS = 5 };
+    rac_float x[STEPS * IN], y[STEPS * HID], dy[STEPS * HID], dx[STEPS * IN];
+    VT_FOREACH(i, 0, STEPS * IN) x[i] = (rac_float)((int)(i % 7) - 3) / 3;
+    VT_FOREACH(i, 0, STEPS * HID) dy[i] = (rac_float)((int)(i % 5) - 2) / 2;
+    const enum RaccoonRecurrentType types[3] = {RAC_RECURRENT_RNN, RAC_RECURRENT_GRU, RAC_RECURRENT_LSTM};
+    rac_random_t rng = rac_random_make(5, 0);
+    VT_FOREACH(k, 0, 3) {
+        rac_recurrent_t *rnn = rac_recurrent_make(alloctr, types[k], IN, HID, STEPS, &rng);
+        assert(rnn->gates == HID * (k == 2 ? 4 : k == 1 ? 3 : 1));
+        VT_FOREACH(g, 0, rnn->gates) assert(rnn->bias[g] == 0);
+        VT_FOREACH(i, 0, rnn->gates * HID) assert(RAC_ABS(rnn->weights_hidden[i]) <= RAC_SQRT((rac_float)6 / (HID + HID)));
+        rac_recurrent_forward(rnn, x, STEPS, y);
+        rac_recurrent_backward(rnn, dy, dx);
+
+        // central differences for every input and every parameter
+        const rac_float eps = 1e-2;
+        rac_float *values[2] = {x, rnn->weights_input};
+        const rac_float *grads[2] = {dx, rnn->grad_weights_input};
+        const size_t lens[2] = {STEPS * IN, rnn->params_len};
+        VT_FOREACH(v, 0, 2) {
+            VT_FOREACH(i, 0, lens[v]) {
+                rac_float loss[2] = {0};
+                VT_FOREACH(side, 0, 2) {
+                    values[v][i] += side ? eps : -eps;
+                    rac_recurrent_reset(rnn);
+                    rac_recurrent_forward(rnn, x, STEPS, y);
+                    VT_FOREACH(j, 0, STEPS * HID) loss[side] += y[j] * dy[j];
+                    values[v][i] -= side ? eps : -eps;
+                }
+                const rac_float numeric = (loss[1] - loss[0]) / (2 * eps);
+                assert(RAC_ABS(numeric - grads[v][i]) < 1e-2 * (1 + RAC_ABS(numeric)));
+            }
+        }
+
+        // truncated windows: the state carries over, memory does not grow
+        rac_recurrent_reset(rnn);
+        rac_recurrent_zero_grad(rnn);
+        const size_t allocs = alloctr->stats.count_allocs;
+        rac_float first = 0, last = 0;
+        VT_FOREACH(epoch, 0, 30) {
+            rac_recurrent_reset(rnn);
+            rac_float loss = 0;
+            VT_FOREACH(w, 0, 3) {
+                const size_t steps = (w == 2) ? 2 : STEPS;
+                rac_recurrent_forward(rnn, x, steps, y);
+                VT_FOREACH(j, 0, steps * HID) {
+                    loss += (y[j] - 0.5f) * (y[j] - 0.5f);
+                    dy[j] = 2 * (y[j] - 0.5f);
+                }
+                rac_recurrent_zero_grad(rnn);
+                rac_recurrent_backward(rnn, dy, NULL);
+                rac_recurrent_update(rnn, 0.05);
+            }
+            if (epoch == 0) first = loss;
+            last = loss;
+            assert(RAC_ABS(rnn->hidden[0]) > 0);
+        }
+        assert(alloctr->stats.count_allocs == allocs);
+        assert(last < first);
+        VT_FOREACH(i, 0, STEPS * HID) dy[i] = (rac_float)((int)(i % 5) - 2) / 2;
+        rac_recurrent_free(rnn);
+    }
+}
+
+void test_embedding(void) {
+    // lookups copy rows; the table is used in place
+    rac_random_t rng = rac_random_make(9, 0);
+    rac_embedding_t *embedding = rac_embedding_make(alloctr, 1000, 4, &rng);
+    VT_FOREACH(i, 0, 1000 * 4) assert(RAC_ABS(embedding->table[i]) <= RAC_SQRT((rac_float)6 / (1 + 4)));
+    const size_t indices[3] = {7, 42, 7};
+    rac_float rows[3 * 4];
+    rac_embedding_forward(embedding, indices, 3, rows);
+    VT_FOREACH(j, 0, 4) {
+        assert(rows[j] == embedding->table[7 * 4 + j] && rows[8 + j] == rows[j]);
+        assert(rows[4 + j] == rac_embedding_lookup(embedding, 42)[j]);
+    }
+
+    // gradients exist for touched rows only; repeated indices add up
+    const rac_float grad_output[3 * 4] = {1, 1, 1, 1, 2, 2, 2, 2, 0.5, 0.5, 0.5, 0.5};
+    rac_embedding_backward(embedding, indices, 3, grad_output);
+    assert(embedding->rows_len == 2);
+    assert(rac_embedding_grad(embedding, 7)[0] == 1.5 && rac_embedding_grad(embedding, 42)[3] == 2);
+    assert(rac_embedding_grad(embedding, 8) == NULL);
+
+    // SGD moves touched rows only
+    const rac_float untouched = embedding->table[8 * 4], before = embedding->table[42 * 4];
+    rac_embedding_update(embedding, 0.1);
+    assert(RAC_ABS(embedding->table[42 * 4] - (before - 0.2f)) < 1e-6);
+    assert(embedding->table[8 * 4] == untouched);
+
+    // Adagrad: first step moves each coordinate by about lr, state only for touched rows
+    const rac_float start = embedding->table[7 * 4];
+    rac_embedding_update_adagrad(embedding, 0.1, 1e-8);
+    assert(RAC_ABS(embedding->table[7 * 4] - (start - 0.1f)) < 1e-5);
+    assert(embedding->accumulators[7 * 4] == 2.25 && embedding->accumulators[8 * 4] == 0);
+
+    // zeroing forgets rows; buffers grow past their initial size and are reused
+    rac_embedding_zero_grad(embedding);
+    assert(embedding->rows_len == 0 && rac_embedding_grad(embedding, 7) == NULL);
+    size_t many[2 * RAC_EMBEDDING_ROWS_INIT + 1];
+    rac_float ones[(2 * RAC_EMBEDDING_ROWS_INIT + 1) * 4];
+    VT_FOREACH(i, 0, 2 * RAC_EMBEDDING_ROWS_INIT + 1) many[i] = 10 * i;
+    VT_FOREACH(i, 0, (2 * RAC_EMBEDDING_ROWS_INIT + 1) * 4) ones[i] = 1;
+    rac_embedding_backward(embedding, many, 2 * RAC_EMBEDDING_ROWS_INIT + 1, ones);
+    assert(embedding->rows_len == 2 * RAC_EMBEDDING_ROWS_INIT + 1);
+    assert(rac_embedding_grad(embedding, 10 * 2 * RAC_EMBEDDING_ROWS_INIT)[0] == 1);
+    const size_t allocs = alloctr->stats.count_allocs;
+    rac_embedding_zero_grad(embedding);
+    rac_embedding_backward(embedding, many, 2 * RAC_EMBEDDING_ROWS_INIT + 1, ones);
+    rac_embedding_update_adagrad(embedding, 0.1, 1e-8);
+    assert(alloctr->stats.count_allocs == allocs);
+
+    // free
+    rac_embedding_free(embedding);
+}
+
+void test_norm(void) {
+    // batch of 4 samples with 3 features, weighted-sum loss
+    enum { B = 4, F = 3 };
+    rac_float x[B * F], y[B * F], dy[B * F], dx[B * F];
+    VT_FOREACH(i, 0, B * F) {
+        x[i] = (rac_float)((int)(i * 7 % 11) - 5) / 2;
+        dy[i] = (rac_float)((int)(i % 5) - 2) / 2;
+    }
+    const enum RaccoonNormType types[2] = {RAC_NORM_LAYER, RAC_NORM_BATCH};
+    VT_FOREACH(k, 0, 2) {
+        rac_norm_t *norm = rac_norm_make(alloctr, types[k], F, B);
+        VT_FOREACH(j, 0, F) {
+            norm->gamma[j] = 1 + (rac_float)j / 2;
+            norm->beta[j] = (rac_float)j - 1;
+        }
+
+        // normalized values have zero mean and unit variance along the axis
+        rac_norm_forward(norm, x, B, y);
+        const size_t groups = (k == 0) ? B : F, len = (k == 0) ? F : B;
+        VT_FOREACH(g, 0, groups) {
+            rac_float mean = 0, var = 0;
+            VT_FOREACH(i, 0, len) mean += norm->normalized[(k == 0) ? g * F + i : i * F + g] / len;
+            VT_FOREACH(i, 0, len) {
+                const rac_float d = norm->normalized[(k == 0) ? g * F + i : i * F + g] - mean;
+                var += d * d / len;
+            }
+            assert(RAC_ABS(mean) < 1e-4 && RAC_ABS(var - 1) < 1e-3);
+        }
+
+        // backward against central differences
+        rac_norm_backward(norm, dy, dx);
+        const rac_float eps = 1e-2;
+        rac_float *values[2] = {x, norm->gamma};
+        const rac_float *grads[2] = {dx, norm->grad_gamma};
+        const size_t lens[2] = {B * F, 2 * F};
+        VT_FOREACH(v, 0, 2) {
+            VT_FOREACH(i, 0, lens[v]) {
+                rac_float loss[2] = {0};
+                VT_FOREACH(side, 0, 2) {
+                    values[v][i] += side ? eps : -eps;
+                    rac_norm_forward(norm, x, B, y);
+                    VT_FOREACH(j, 0, B * F) loss[side] += y[j] * dy[j];
+                    values[v][i] -= side ? eps : -eps;
+                }
+                const rac_float numeric = (loss[1] - loss[0]) / (2 * eps);
+                assert(RAC_ABS(numeric - grads[v][i]) < 1e-2 * (1 + RAC_ABS(numeric)));
+            }
+        }
+
+        // in-place forward and backward
+        memcpy(y, x, sizeof(x));
+        rac_norm_forward(norm, y, B, y);
+        memcpy(dx, dy, sizeof(dy));
+        rac_norm_backward(norm, dx, dx);
+        rac_norm_free(norm);
+    }
+
+    // running statistics follow the batch statistics; inference uses them
+    rac_norm_t *norm = rac_norm_make(alloctr, RAC_NORM_BATCH, F, B);
+    VT_FOREACH(step, 0, 200) rac_norm_forward(norm, x, B, y);
+    VT_FOREACH(j, 0, F) {
+        rac_float mean = 0, var = 0;
+        VT_FOREACH(b, 0, B) mean += x[b * F + j] / B;
+        VT_FOREACH(b, 0, B) var += (x[b * F + j] - mean) * (x[b * F + j] - mean) / (B - 1);
+        assert(RAC_ABS(norm->running_mean[j] - mean) < 1e-4 && RAC_ABS(norm->running_var[j] - var) < 1e-3);
+    }
+    norm->training = false;
+    VT_FOREACH(j, 0, F) norm->gamma[j] = 2 - (rac_float)j / 2;
+    norm->beta[1] = 0.5;
+
+    // folding into the preceding linear layer gives the same inference output
+    rac_layer_t *layer = rac_layer_make(alloctr, 2, F, NULL);
+    const rac_float input[2] = {0.5, -1.5};
+    rac_float folded[F];
+    vt_plist_t *output = rac_layer_forward_array(layer, input, 2, 1);
+    VT_FOREACH(j, 0, F) y[j] = ((rac_var_t*)vt_plist_get(output, j))->data;
+    rac_norm_forward(norm, y, 1, y);
+    rac_layer_clear_cache(layer);
+    rac_norm_fold(norm, layer);
+    output = rac_layer_forward_array(layer, input, 2, 1);
+    VT_FOREACH(j, 0, F) folded[j] = ((rac_var_t*)vt_plist_get(output, j))->data;
+    VT_FOREACH(j, 0, F) assert(RAC_ABS(folded[j] - y[j]) < 1e-4 * (1 + RAC_ABS(y[j])));
+
+    // free
+    rac_layer_free(layer);
+    rac_norm_free(norm);
+}
+
+void test_random(void) {
+    // Philox4x32-10 known answer: counter 0, key 0
+    const uint32_t zero[4] = {0}, expected[4] = {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8};
+    uint32_t bits[4];
+    rac_random_philox(zero, zero, bits);
+    VT_FOREACH(i, 0, 4) assert(bits[i] == expected[i]);
+
+    // same seed and stream repeat, other streams differ; one long fill equals two short ones
+    enum { N = 10000 };
+    rac_float *a = VT_CALLOC(N * sizeof(rac_float)), *b = VT_CALLOC(N * sizeof(rac_float));
+    rac_random_t rng = rac_random_make(42, 0), same = rac_random_make(42, 0), other = rac_random_make(42, 1);
+    rac_random_uniform(&rng, a, N, 0, 1);
+    rac_random_uniform(&same, b, N / 2, 0, 1);
+    rac_random_uniform(&same, b + N / 2, N / 2, 0, 1);
+    VT_FOREACH(i, 0, N) assert(a[i] == b[i]);
+    rac_random_uniform(&other, b, N, 0, 1);
+    size_t equal = 0;
+    VT_FOREACH(i, 0, N) equal += a[i] == b[i];
+    assert(equal < 10);
+
+    // uniform: range and mean
+    rac_random_uniform(&rng, a, N, -2, 4);
+    rac_float mean = 0, var = 0;
+    VT_FOREACH(i, 0, N) {
+        assert(a[i] >= -2 && a[i] < 4);
+        mean += a[i] / N;
+    }
+    assert(RAC_ABS(mean - 1) < 0.1);
+
+    // normal (odd length): mean and variance
+    rac_random_normal(&rng, a, N - 1, 3, 2);
+    mean = 0;
+    VT_FOREACH(i, 0, N - 1) mean += a[i] / (N - 1);
+    VT_FOREACH(i, 0, N - 1) var += (a[i] - mean) * (a[i] - mean) / (N - 1);
+    assert(RAC_ABS(mean - 3) < 0.1 && RAC_ABS(var - 4) < 0.3);
+
+    // Xavier bounds, He deviation
+    const rac_float limit = RAC_SQRT((rac_float)6 / (100 + 50));
+    rac_random_xavier(&rng, a, N, 100, 50);
+    VT_FOREACH(i, 0, N) assert(RAC_ABS(a[i]) <= limit);
+    rac_random_he(&rng, a, N, 50);
+    var = 0;
+    VT_FOREACH(i, 0, N) var += a[i] * a[i] / N;
+    assert(RAC_ABS(var - (rac_float)2 / 50) < 0.005);
+
+    // layer init: zero biases, reproducible weights
+    rac_mlp_t *model = rac_mlp_make(alloctr, 3, (size_t[]){4, 8, 2}, NULL, NULL);
+    rng = rac_random_make(7, 0);
+    rac_mlp_init(model, RAC_RANDOM_INIT_HE, &rng);
+    const rac_layer_t *layer = vt_plist_get(model->layers, 0);
+    const rac_neuron_t *neuron = vt_plist_get(layer->neurons, 1);
+    const rac_float weight = ((rac_var_t*)vt_plist_get(neuron->params, 2))->data;
+    assert(((rac_var_t*)vt_plist_get(neuron->params, 4))->data == 0);
+    rng = rac_random_make(7, 0);
+    rac_mlp_init(model, RAC_RANDOM_INIT_HE, &rng);
+    assert(((rac_var_t*)vt_plist_get(neuron->params, 2))->data == weight);
+    rac_mlp_init(model, RAC_RANDOM_INIT_XAVIER, &rng);
+    assert(RAC_ABS(((rac_var_t*)vt_plist_get(neuron->params, 2))->data) <= RAC_SQRT((rac_float)6 / (4 + 8)));
+    rac_mlp_free(model);
+
+    // random variables from a stream repeat with the stream
+    rng = rac_random_make(11, 0), same = rac_random_make(11, 0);
+    rac_var_t *drawn = rac_var_make_rand_ex(alloctr, &rng), *redrawn = rac_var_make_rand_ex(alloctr, &same);
+    assert(drawn->data == redrawn->data && drawn->data >= 0 && drawn->data < 1);
+    rac_var_free(drawn);
+    rac_var_free(redrawn);
+
+    // dropout: about `rate` dropped, the rest scaled, gradients masked the same way
+    rac_dropout_t *dropout = rac_dropout_make(alloctr, 0.25, N, rac_random_make(1, 0));
+    VT_FOREACH(i, 0, N) a[i] = 1;
+    rac_dropout_forward(dropout, a, N, b);
+    size_t dropped = 0;
+    VT_FOREACH(i, 0, N) {
+        assert(b[i] == 0 || RAC_ABS(b[i] - (rac_float)4 / 3) < 1e-6);
+        dropped += b[i] == 0;
+    }
+    assert(dropped > N / 5 && dropped < N * 3 / 10);
+    VT_FOREACH(i, 0, N) a[i] = 2;
+    rac_dropout_backward(dropout, a, a);
+    VT_FOREACH(i, 0, N) assert(a[i] == 2 * b[i]);
+
+    // inference is the identity
+    dropout->training = false;
+    rac_dropout_forward(dropout, a, N, b);
+    VT_FOREACH(i, 0, N) assert(a[i] == b[i]);
+
+    // free
+    rac_dropout_free(dropout);
+    VT_FREE(a);
+    VT_FREE(b);
+}
+
 /**
  * HELPER FUNCTIONS
  */
 
 // frees plist and its contents
+rac_var_t *act_square(rac_var_t *const x) {
+    return rac_var_mul(x, x);
+}
+
+rac_float act_square_scalar(const rac_float x) {
+    return x * x;
+}
+
+rac_var_t *act_square_op(rac_var_t *const x) {
+    return rac_var_make_ex(x->alloctr, x->data * x->data, 's', (rac_var_t*[2]){x, NULL}, op_square_backward);
+}
+
+rac_float op_square_forward(const rac_float values[RAC_VAR_PARENTS_LEN]) {
+    return values[0] * values[0];
+}
+
+void op_square_derivative(const rac_float values[RAC_VAR_PARENTS_LEN], const rac_float value, rac_float partials[RAC_VAR_PARENTS_LEN]) {
+    (void)value;
+    partials[0] = 2 * values[0];
+}
+
+void op_square_backward(rac_var_t *const op_result) {
+    op_result->parents[0]->grad += 2 * op_result->parents[0]->data * op_result->grad;
+}
+
 void plist_var_free(vt_plist_t *list) {
     assert(list != NULL);
 